@@ -0,0 +1,182 @@
+// Activity triggers: the cost of one sample (reading the system counters and updating
+// the triggers), and how well the EWMA plus hysteresis holds a noisy rate near its
+// threshold steady compared with a plain comparison per sample.
+
+#include "ActivityMonitor.h"
+#include "BenchUtil.h"
+#include "Clock.h"
+#include <cstdio>
+#include <random>
+#include <thread>
+
+#ifndef _WIN32
+#include <cstring>
+#endif
+
+using namespace Everon;
+
+namespace {
+
+constexpr ULONGLONG kSec = Clock::TICKS_PER_SEC;
+
+void RunTriggerBench() {
+    ActivityTrigger trigger;
+    trigger.Configure(50.0, 60 * kSec, 30 * kSec);
+    std::mt19937 rng{ 5 };
+    std::uniform_real_distribution<double> noise(0.0, 100.0);
+    double values[1024];
+    for (double& value : values) {
+        value = noise(rng);
+    }
+    int flips = 0;
+    Bench::Run("trigger update", 10000000, [&](long long i) {
+        flips += trigger.Update(values[i & 1023], static_cast<ULONGLONG>(i) * 15 * kSec) ? 1 : 0;
+    });
+    Bench::DoNotOptimize(flips);
+}
+
+// A day of 15 s samples of a rate whose true level sits just above, then just below,
+// the threshold (mean +-8%), with +-40% noise on every reading: the hold should switch
+// twice, not every few samples.
+void RunFlapBench() {
+    constexpr double kThreshold = 1000.0;
+    constexpr ULONGLONG kStep = 15 * kSec;
+    constexpr int kSamples = 24 * 3600 / 15;
+    ActivityTrigger trigger;
+    trigger.Configure(kThreshold, 60 * kSec, 30 * kSec);
+    std::mt19937 rng{ 9 };
+    std::uniform_real_distribution<double> noise(-0.4, 0.4);
+
+    int rawFlips = 0;
+    int triggerFlips = 0;
+    bool rawActive = false;
+    for (int i = 0; i < kSamples; ++i) {
+        // Working for the first half of the day, winding down for the second.
+        const double level = (i < kSamples / 2) ? kThreshold * 1.08 : kThreshold * 0.6;
+        const double value = level * (1.0 + noise(rng));
+        const bool raw = value >= kThreshold;
+        rawFlips += (raw != rawActive) ? 1 : 0;
+        rawActive = raw;
+        triggerFlips += trigger.Update(value, static_cast<ULONGLONG>(i) * kStep) ? 1 : 0;
+    }
+    std::printf("%-44s %d switches\n", "plain threshold, noisy day", rawFlips);
+    std::printf("%-44s %d switches\n", "EWMA + hysteresis, noisy day", triggerFlips);
+}
+
+// Cost of one system read through ActivityReader (wall time per sample).
+double TimeReads(unsigned kinds, const char* label) {
+    ActivityReader reader;
+    if (!reader.Open(kinds)) {
+        std::printf("%-44s unavailable\n", label);
+        return 0;
+    }
+    ActivitySample sample;
+    reader.Read(sample);
+    constexpr long long kReads = 20000;
+    const double ns = Bench::Run(label, kReads, [&](long long) {
+        reader.Read(sample);
+        Bench::DoNotOptimize(sample);
+    });
+    return ns;
+}
+
+#ifndef _WIN32
+// The obvious way: open, parse with stdio and close, every sample.
+bool NaiveRead(double& value) {
+    ULONGLONG total = 0;
+    FILE* file = std::fopen("/proc/stat", "r");
+    if (!file) {
+        return false;
+    }
+    unsigned long long fields[8] = {};
+    const int got = std::fscanf(file, "cpu %llu %llu %llu %llu %llu %llu %llu %llu", &fields[0], &fields[1],
+                                &fields[2], &fields[3], &fields[4], &fields[5], &fields[6], &fields[7]);
+    std::fclose(file);
+    for (int i = 0; i < got; ++i) {
+        total += fields[i];
+    }
+
+    file = std::fopen("/proc/diskstats", "r");
+    if (!file) {
+        return false;
+    }
+    char line[512];
+    while (std::fgets(line, sizeof(line), file)) {
+        unsigned major = 0, minor = 0;
+        char name[64];
+        unsigned long long reads = 0, merged = 0, sectors = 0;
+        if (std::sscanf(line, "%u %u %63s %llu %llu %llu", &major, &minor, name, &reads, &merged, &sectors) == 6) {
+            total += sectors;
+        }
+    }
+    std::fclose(file);
+
+    file = std::fopen("/proc/net/dev", "r");
+    if (!file) {
+        return false;
+    }
+    while (std::fgets(line, sizeof(line), file)) {
+        const char* colon = std::strchr(line, ':');
+        unsigned long long bytes = 0;
+        if (colon && std::sscanf(colon + 1, "%llu", &bytes) == 1) {
+            total += bytes;
+        }
+    }
+    std::fclose(file);
+    value = static_cast<double>(total);
+    return true;
+}
+
+void RunNaiveBench() {
+    double value = 0;
+    Bench::Run("reopen + stdio parse, all three", 20000, [&](long long) {
+        NaiveRead(value);
+        Bench::DoNotOptimize(value);
+    });
+}
+#endif
+
+// Busy for half a second on this thread, then one reading: the CPU rate must show it.
+int RunLiveCheck() {
+    ActivityReader reader;
+    if (!reader.Open(ActivityReader::Bit(ActivityKind::Cpu))) {
+        std::printf("cpu counters unavailable; skipped\n");
+        return 0;
+    }
+    ActivitySample sample;
+    reader.Read(sample);
+    const ULONGLONG until = Platform::GetMonotonicTicks() + 500 * Clock::TICKS_PER_MS;
+    volatile ULONGLONG spin = 0;
+    while (Platform::GetMonotonicTicks() < until) {
+        spin = spin + 1;
+    }
+    if (!reader.Read(sample)) {
+        std::printf("%-44s FAILED (no reading)\n", "busy loop seen");
+        return 1;
+    }
+    // One busy thread is 100% of one CPU; other load only adds to it.
+    const double cpus = static_cast<double>(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1);
+    const bool seen = sample[ActivityKind::Cpu] >= 80.0 / cpus;
+    std::printf("%-44s %s (%.0f%% of %.0f CPUs)\n", "busy loop seen", seen ? "ok" : "FAILED",
+                sample[ActivityKind::Cpu], cpus);
+    return seen ? 0 : 1;
+}
+
+} // namespace
+
+int main() {
+    RunTriggerBench();
+    RunFlapBench();
+
+    const double cpu = TimeReads(ActivityReader::Bit(ActivityKind::Cpu), "read cpu");
+    const double disk = TimeReads(ActivityReader::Bit(ActivityKind::Disk), "read disk");
+    const double net = TimeReads(ActivityReader::Bit(ActivityKind::Network), "read network");
+    const double all = TimeReads(ActivityReader::Bit(ActivityKind::Cpu) | ActivityReader::Bit(ActivityKind::Disk) |
+                                 ActivityReader::Bit(ActivityKind::Network), "read all three");
+    std::printf("  per sample: %.1f us (cpu %.1f, disk %.1f, network %.1f)\n", all / 1000.0, cpu / 1000.0,
+                disk / 1000.0, net / 1000.0);
+#ifndef _WIN32
+    RunNaiveBench();
+#endif
+    return RunLiveCheck();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Minimal timing harness for the microbenchmarks in bench/. Not part of the product.
+
+#include <chrono>
+#include <cstdio>
+
+namespace Everon {
+namespace Bench {
+
+// Keeps the optimizer from discarding a computed value.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+// Runs fn(i) for i in [0, iterations) and prints the mean cost per call.
+template <typename Fn>
+inline double Run(const char* name, long long iterations, Fn&& fn) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (long long i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(iterations);
+    std::printf("%-44s %12.2f ns/op\n", name, ns);
+    return ns;
+}
+
+} // namespace Bench
+} // namespace Everon
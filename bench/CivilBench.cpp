@@ -0,0 +1,178 @@
+// Civil calendar arithmetic: the day-by-day loops TimerMode used to carry versus
+// the O(1) CivilTime.h versions.
+
+#include "BenchUtil.h"
+#include "CivilTime.h"
+#include <cstdio>
+#include <ctime>
+#include <initializer_list>
+
+using namespace Everon;
+
+namespace {
+
+// --- Previous TimerMode.cpp helpers -----------------------------------------------
+
+bool LegacyIsLeapYear(WORD year) {
+    if ((year % 400) == 0) return true;
+    if ((year % 100) == 0) return false;
+    return (year % 4) == 0;
+}
+
+WORD LegacyDaysInMonth(WORD year, WORD month) {
+    switch (month) {
+        case 2:  return static_cast<WORD>(LegacyIsLeapYear(year) ? 29 : 28);
+        case 4: case 6: case 9: case 11: return 30;
+        default: return 31;
+    }
+}
+
+void LegacyAddDaysLocal(SYSTEMTIME& st, int days) {
+    while (days-- > 0) {
+        const WORD dim = LegacyDaysInMonth(st.wYear, st.wMonth);
+        if (st.wDay < dim) {
+            st.wDay = static_cast<WORD>(st.wDay + 1);
+        } else {
+            st.wDay = 1;
+            if (st.wMonth < 12) {
+                st.wMonth = static_cast<WORD>(st.wMonth + 1);
+            } else {
+                st.wMonth = 1;
+                st.wYear = static_cast<WORD>(st.wYear + 1);
+            }
+        }
+    }
+}
+
+// --- Previous Platform conversions (OS / libc) -------------------------------------
+
+#ifdef _WIN32
+
+ULONGLONG LegacySystemTimeToTicks(const SYSTEMTIME& st) {
+    FILETIME ft = {};
+    SystemTimeToFileTime(&st, &ft);
+    return (static_cast<ULONGLONG>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+}
+
+SYSTEMTIME LegacyTicksToSystemTime(ULONGLONG ticks) {
+    FILETIME ft = {};
+    ft.dwLowDateTime = static_cast<DWORD>(ticks);
+    ft.dwHighDateTime = static_cast<DWORD>(ticks >> 32);
+    SYSTEMTIME st = {};
+    FileTimeToSystemTime(&ft, &st);
+    st.wMilliseconds = 0;
+    return st;
+}
+
+#else
+
+ULONGLONG LegacySystemTimeToTicks(const SYSTEMTIME& st) {
+    std::tm tm = {};
+    tm.tm_year = st.wYear - 1900;
+    tm.tm_mon = st.wMonth - 1;
+    tm.tm_mday = st.wDay;
+    tm.tm_hour = st.wHour;
+    tm.tm_min = st.wMinute;
+    tm.tm_sec = st.wSecond;
+    return Civil::UnixSecondsToTicks(static_cast<LONGLONG>(timegm(&tm))) + st.wMilliseconds * 10000ULL;
+}
+
+SYSTEMTIME LegacyTicksToSystemTime(ULONGLONG ticks) {
+    const time_t t = static_cast<time_t>(Civil::TicksToUnixSeconds(ticks));
+    std::tm tm = {};
+    gmtime_r(&t, &tm);
+    SYSTEMTIME st = {};
+    st.wYear = static_cast<WORD>(tm.tm_year + 1900);
+    st.wMonth = static_cast<WORD>(tm.tm_mon + 1);
+    st.wDayOfWeek = static_cast<WORD>(tm.tm_wday);
+    st.wDay = static_cast<WORD>(tm.tm_mday);
+    st.wHour = static_cast<WORD>(tm.tm_hour);
+    st.wMinute = static_cast<WORD>(tm.tm_min);
+    st.wSecond = static_cast<WORD>(tm.tm_sec);
+    return st;
+}
+
+#endif
+
+SYSTEMTIME Start() {
+    SYSTEMTIME st = {};
+    st.wYear = 2024;
+    st.wMonth = 2;
+    st.wDay = 27;
+    st.wHour = 22;
+    st.wMinute = 30;
+    return st;
+}
+
+} // namespace
+
+int main() {
+    const SYSTEMTIME start = Start();
+    bool mismatch = false;
+
+    for (int span : { 1, 30, 365, 3650 }) {
+        char name[64];
+        const long long iterations = 20000000LL / span + 1000;
+
+        std::snprintf(name, sizeof(name), "AddDays(+%d) legacy loop", span);
+        Bench::Run(name, iterations, [&](long long i) {
+            SYSTEMTIME st = start;
+            st.wDay = static_cast<WORD>(1 + i % 28);
+            LegacyAddDaysLocal(st, span);
+            Bench::DoNotOptimize(st);
+        });
+
+        std::snprintf(name, sizeof(name), "AddDays(+%d) Civil", span);
+        Bench::Run(name, iterations, [&](long long i) {
+            SYSTEMTIME st = start;
+            st.wDay = static_cast<WORD>(1 + i % 28);
+            Civil::AddDays(st, span);
+            Bench::DoNotOptimize(st);
+        });
+
+        SYSTEMTIME a = start;
+        SYSTEMTIME b = start;
+        LegacyAddDaysLocal(a, span);
+        Civil::AddDays(b, span);
+        mismatch |= a.wYear != b.wYear || a.wMonth != b.wMonth || a.wDay != b.wDay;
+    }
+
+    ULONGLONG base = 0;
+    Civil::SystemTimeToTicks(start, base);
+    const long long iterations = 5000000LL;
+
+    Bench::Run("SYSTEMTIME -> ticks OS/libc", iterations, [&](long long i) {
+        SYSTEMTIME st = start;
+        st.wMinute = static_cast<WORD>(i % 60);
+        Bench::DoNotOptimize(LegacySystemTimeToTicks(st));
+    });
+    Bench::Run("SYSTEMTIME -> ticks Civil", iterations, [&](long long i) {
+        SYSTEMTIME st = start;
+        st.wMinute = static_cast<WORD>(i % 60);
+        ULONGLONG ticks = 0;
+        Civil::SystemTimeToTicks(st, ticks);
+        Bench::DoNotOptimize(ticks);
+    });
+    Bench::Run("ticks -> SYSTEMTIME OS/libc", iterations, [&](long long i) {
+        Bench::DoNotOptimize(LegacyTicksToSystemTime(base + static_cast<ULONGLONG>(i) * Civil::TICKS_PER_SEC * 61));
+    });
+    Bench::Run("ticks -> SYSTEMTIME Civil", iterations, [&](long long i) {
+        Bench::DoNotOptimize(Civil::TicksToSystemTime(base + static_cast<ULONGLONG>(i) * Civil::TICKS_PER_SEC * 61));
+    });
+
+    // Cross-check a sweep of instants against the OS.
+    for (long long i = 0; i < 200000 && !mismatch; ++i) {
+        const ULONGLONG ticks = base + static_cast<ULONGLONG>(i) * 3797ULL * Civil::TICKS_PER_SEC;
+        const SYSTEMTIME a = LegacyTicksToSystemTime(ticks);
+        const SYSTEMTIME b = Civil::TicksToSystemTime(ticks);
+        ULONGLONG back = 0;
+        mismatch = a.wYear != b.wYear || a.wMonth != b.wMonth || a.wDay != b.wDay || a.wHour != b.wHour ||
+                   a.wMinute != b.wMinute || a.wSecond != b.wSecond || a.wDayOfWeek != b.wDayOfWeek ||
+                   !Civil::SystemTimeToTicks(b, back) || back != LegacySystemTimeToTicks(a);
+    }
+
+    if (mismatch) {
+        std::printf("MISMATCH between legacy and Civil results\n");
+    }
+    return mismatch ? 1 : 0;
+}
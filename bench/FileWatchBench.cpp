@@ -0,0 +1,182 @@
+// File watch stress on a tmpfs tree: thousands of small files and one long streamed
+// file land in a watched tree. Reported: what the consumer pays per file when it drains
+// the queue once per busy period (the app's mode) versus waking for every batch, what
+// a long single-file write costs, and whether new subdirectories and the quiet period
+// are handled.
+
+#include "BenchUtil.h"
+#include "Clock.h"
+#include "FileWatch.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <ftw.h>
+#include <poll.h>
+#include <string>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Everon;
+
+namespace {
+
+constexpr int kDirs = 16;
+constexpr int kSubdirs = 16;
+constexpr int kFiles = 20000;
+constexpr ULONGLONG kQuiet = 60 * Clock::TICKS_PER_SEC;
+
+int Check(const char* name, bool ok) {
+    std::printf("%-44s %s\n", name, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+double CpuUs() {
+    return static_cast<double>(Platform::GetThreadCpuTicks()) / 10.0;
+}
+
+// tmpfs when /dev/shm is one (no disk in the way), else the temp directory.
+std::string MakeRoot() {
+    struct statfs info = {};
+    const char* base = (statfs("/dev/shm", &info) == 0 && info.f_type == 0x01021994) ? "/dev/shm" : "/tmp";
+    std::string root = std::string(base) + "/everon-filewatch-XXXXXX";
+    if (!mkdtemp(&root[0])) {
+        return {};
+    }
+    std::printf("tree in %s (%s)\n", root.c_str(), std::strcmp(base, "/dev/shm") == 0 ? "tmpfs" : "not tmpfs");
+    for (int d = 0; d < kDirs; ++d) {
+        const std::string dir = root + "/d" + std::to_string(d);
+        mkdir(dir.c_str(), 0700);
+        for (int s = 0; s < kSubdirs; ++s) {
+            mkdir((dir + "/s" + std::to_string(s)).c_str(), 0700);
+        }
+    }
+    return root;
+}
+
+void RemoveTree(const std::string& root) {
+    nftw(root.c_str(), [](const char* path, const struct stat*, int, FTW*) { return remove(path); }, 16,
+         FTW_DEPTH | FTW_PHYS);
+}
+
+void WriteFile(const std::string& path, const char* data, size_t size) {
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd >= 0) {
+        if (write(fd, data, size) < 0) {
+            std::perror("write");
+        }
+        close(fd);
+    }
+}
+
+// Small files spread over the tree; `pollEvery` > 0 drains the queue after that many
+// files (a consumer woken for every batch), 0 leaves it to one drain at the end.
+void WriteBurst(FileWatcher& watcher, const std::string& root, int round, int pollEvery, double& consumerUs,
+                int& wakeups) {
+    char data[512];
+    std::memset(data, 'x', sizeof(data));
+    for (int i = 0; i < kFiles; ++i) {
+        const std::string path = root + "/d" + std::to_string(i % kDirs) + "/s" + std::to_string((i / kDirs) % kSubdirs) +
+                                 "/f" + std::to_string(round) + "_" + std::to_string(i);
+        WriteFile(path, data, sizeof(data));
+        if (pollEvery > 0 && i % pollEvery == pollEvery - 1) {
+            pollfd pfd = { watcher.GetFd(), POLLIN, 0 };
+            if (poll(&pfd, 1, 0) > 0) {
+                const double before = CpuUs();
+                watcher.Consume(Platform::GetMonotonicTicks());
+                consumerUs += CpuUs() - before;
+                ++wakeups;
+            }
+        }
+    }
+    const double before = CpuUs();
+    watcher.Consume(Platform::GetMonotonicTicks());
+    consumerUs += CpuUs() - before;
+    ++wakeups;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    const std::string root = MakeRoot();
+    if (root.empty()) {
+        std::printf("cannot create the test tree; skipped\n");
+        return 0;
+    }
+
+    FileWatcher watcher;
+    const double startUs = CpuUs();
+    if (!watcher.Start({ root })) {
+        std::printf("inotify unavailable; skipped\n");
+        RemoveTree(root);
+        return 0;
+    }
+    std::printf("%-44s %zu watches, %.0f us\n", "start (recursive watch)", watcher.GetWatchCount(), CpuUs() - startUs);
+    failures += Check("whole tree watched", watcher.GetWatchCount() == 1 + kDirs + kDirs * kSubdirs);
+
+    // The app's mode: busy after the first event, one drain per quiet check.
+    double drainOnceUs = 0;
+    int drainOnceWakeups = 0;
+    const ULONGLONG eventsBefore = watcher.GetEventCount();
+    WriteBurst(watcher, root, 0, 0, drainOnceUs, drainOnceWakeups);
+    const ULONGLONG drainedEvents = watcher.GetEventCount() - eventsBefore;
+    std::printf("%-44s %d wakeup(s), %llu events, %.0f us, %.3f us/file\n", "20000 files, drained once",
+                drainOnceWakeups, static_cast<unsigned long long>(drainedEvents), drainOnceUs, drainOnceUs / kFiles);
+    failures += Check("burst seen", drainedEvents > 0 && watcher.IsBusy(Platform::GetMonotonicTicks(), kQuiet));
+
+    // A consumer woken for every batch of 100 files.
+    double perBatchUs = 0;
+    int perBatchWakeups = 0;
+    WriteBurst(watcher, root, 1, 100, perBatchUs, perBatchWakeups);
+    std::printf("%-44s %d wakeup(s), %.0f us, %.3f us/file\n", "20000 files, woken per 100 files", perBatchWakeups,
+                perBatchUs, perBatchUs / kFiles);
+
+    // One file streamed in 4 KB writes while nobody reads the queue: the kernel merges
+    // the repeated modify events.
+    {
+        static char chunk[4096];
+        const int fd = open((root + "/d0/stream.bin").c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        constexpr int kChunks = 25600;   // 100 MB
+        for (int i = 0; i < kChunks && fd >= 0; ++i) {
+            if (write(fd, chunk, sizeof(chunk)) < 0) {
+                break;
+            }
+        }
+        const ULONGLONG taken = watcher.Consume(Platform::GetMonotonicTicks());
+        std::printf("%-44s %llu events for %d writes\n", "100 MB streamed, one drain", static_cast<unsigned long long>(taken),
+                    kChunks);
+        failures += Check("streamed writes merged", taken > 0 && taken < 16);
+        if (fd >= 0) {
+            close(fd);
+        }
+        watcher.Consume(Platform::GetMonotonicTicks());
+    }
+
+    // A directory created under the watch is watched too.
+    {
+        const size_t watches = watcher.GetWatchCount();
+        const std::string fresh = root + "/d1/new";
+        mkdir(fresh.c_str(), 0700);
+        watcher.Consume(Platform::GetMonotonicTicks());
+        WriteFile(fresh + "/file", "x", 1);
+        const ULONGLONG taken = watcher.Consume(Platform::GetMonotonicTicks());
+        failures += Check("new subdirectory watched", watcher.GetWatchCount() == watches + 1 && taken > 0);
+    }
+
+    // Quiet period: busy right after the writes, not once it has passed without any.
+    const ULONGLONG now = Platform::GetMonotonicTicks();
+    failures += Check("quiet period ends the busy state",
+                      watcher.IsBusy(now, kQuiet) && !watcher.IsBusy(now + kQuiet + FileWatcher::BUCKET_WIDTH, kQuiet));
+
+    FileActivityRing ring(FileWatcher::BUCKET_WIDTH);
+    Bench::Run("ring record", 10000000, [&](long long i) {
+        ring.Record(static_cast<ULONGLONG>(i) * 1000ULL, 3);
+    });
+    Bench::DoNotOptimize(ring.GetTotal());
+
+    watcher.Stop();
+    RemoveTree(root);
+    return failures ? 1 : 0;
+}
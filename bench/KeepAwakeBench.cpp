@@ -0,0 +1,50 @@
+// Per-call latency of every keep-awake mechanism that works on this machine: Acquire +
+// Release for hold strategies, one Pulse for pulse strategies. Meant to run under a
+// headless display server, e.g.
+//   Xvfb :99 & DISPLAY=:99 everon-bench-keepawake
+// Mechanisms that fail their probe (no logind, no desktop session, no X) are listed
+// and skipped.
+
+#include "BenchUtil.h"
+#include "KeepAwake.h"
+#include <cstdio>
+
+using namespace Everon;
+
+namespace {
+
+constexpr long long kIterations = 200;
+constexpr WORD kVirtualKey = VK_F15;
+
+} // namespace
+
+int main() {
+    for (const auto& strategy : CreateKeepAwakeStrategies()) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%ls", strategy->GetName());
+        if (!strategy->Probe()) {
+            std::printf("%-44s unavailable\n", name);
+            continue;
+        }
+
+        strategy->ResetStats(0);
+        const bool hold = (strategy->GetKind() == KeepAwakeStrategy::Kind::Hold);
+        char label[96];
+        std::snprintf(label, sizeof(label), "%s %s", name, hold ? "Acquire + Release" : "Pulse");
+        Bench::Run(label, kIterations, [&](long long) {
+            if (hold) {
+                strategy->Acquire(true);
+                strategy->Release();
+            } else {
+                strategy->Pulse(kVirtualKey);
+            }
+        });
+
+        const KeepAwakeStats& stats = strategy->GetStats();
+        std::printf("  %.1f OS calls/op, %llu failures, cpu %.1f us/op\n",
+                    static_cast<double>(stats.osCalls) / kIterations,
+                    static_cast<unsigned long long>(stats.failures),
+                    static_cast<double>(stats.cpuTicks) / 10.0 / kIterations);
+    }
+    return 0;
+}
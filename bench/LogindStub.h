@@ -0,0 +1,224 @@
+#pragma once
+
+// Stand-in for systemd-logind on a private message bus, for exercising the logind
+// backends offline. Serves Manager.Inhibit (handing out one end of a pipe; the lock is
+// live until the client closes it), Properties.Get for IdleAction, IdleActionUSec and
+// BlockInhibited, and one session (GetSessionByPID/GetSession, Active, LockedHint) whose
+// Lock/Unlock and PropertiesChanged signals can be fired on demand. Not part of the product.
+
+#include "DBusConnection.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <poll.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace Everon {
+namespace Bench {
+
+// Starts `dbus-daemon --session` in the background; returns its address (empty on failure).
+inline std::string StartPrivateBus(pid_t& pid) {
+    FILE* out = popen("dbus-daemon --session --fork --print-address=1 --print-pid=1 2>/dev/null", "r");
+    if (!out) {
+        return {};
+    }
+    char address[512] = {};
+    char pidText[32] = {};
+    const bool ok = std::fgets(address, sizeof(address), out) && std::fgets(pidText, sizeof(pidText), out);
+    pclose(out);
+    if (!ok) {
+        return {};
+    }
+    pid = static_cast<pid_t>(std::atoi(pidText));
+    std::string result = address;
+    while (!result.empty() && (result.back() == '\n' || result.back() == '\r')) {
+        result.pop_back();
+    }
+    return result;
+}
+
+class LogindStub {
+public:
+    explicit LogindStub(const std::string& address) {
+        if (m_bus.Connect(address) && m_bus.RequestName("org.freedesktop.login1")) {
+            m_ready = true;
+            m_thread = std::thread([this]() { Serve(); });
+        }
+    }
+
+    ~LogindStub() {
+        m_stop = true;
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+        for (const Lock& lock : m_locks) {
+            close(lock.fd);
+        }
+    }
+
+    LogindStub(const LogindStub&) = delete;
+    LogindStub& operator=(const LogindStub&) = delete;
+
+    bool IsReady() const noexcept { return m_ready; }
+    // Forgets every lock, as a restarted logind would (takes effect before the next call).
+    void DropLocks() noexcept { m_dropLocks = true; }
+    unsigned GetInhibitCalls() const noexcept { return m_inhibitCalls; }
+
+    static constexpr const char* SESSION_PATH = "/org/freedesktop/login1/session/_31";
+
+    // Locks or unlocks the session: Lock/Unlock signal plus LockedHint PropertiesChanged,
+    // as logind does when a screen locker asks. Sent from the serving thread.
+    void SetLocked(bool locked) noexcept { m_pendingLocked = locked ? 1 : 0; }
+    // Switches the session to the foreground or away (Active PropertiesChanged only).
+    void SetActive(bool active) noexcept { m_pendingActive = active ? 1 : 0; }
+
+private:
+    struct Lock {
+        int fd;             // our end; hangs up once the client closes its end
+        std::string what;
+    };
+
+    void Serve() {
+        while (!m_stop) {
+            EmitPending();
+            DBusMessage message;
+            if (!m_bus.ReadMessage(message, 50)) {
+                if (!m_bus.IsConnected()) {
+                    return;
+                }
+                continue;
+            }
+            if (message.GetType() != DBusMessage::MethodCall) {
+                continue;
+            }
+            DropReleased();
+            if (m_dropLocks.exchange(false)) {
+                for (const Lock& lock : m_locks) {
+                    close(lock.fd);
+                }
+                m_locks.clear();
+            }
+            if (message.GetMember() == "Inhibit") {
+                Inhibit(message);
+            } else if (message.GetMember() == "Get") {
+                Get(message);
+            } else if (message.GetMember() == "GetSessionByPID" || message.GetMember() == "GetSession") {
+                DBusMessage reply = DBusMessage::CreateMethodReturn(message);
+                reply.AppendObjectPath(SESSION_PATH);
+                m_bus.Send(reply);
+            } else {
+                m_bus.Send(DBusMessage::CreateError(message, "org.freedesktop.DBus.Error.UnknownMethod"));
+            }
+        }
+    }
+
+    void Inhibit(DBusMessage& call) {
+        std::string what;
+        int ends[2];
+        if (!call.ReadString(what) || pipe(ends) != 0) {
+            m_bus.Send(DBusMessage::CreateError(call, "org.freedesktop.DBus.Error.InvalidArgs"));
+            return;
+        }
+        ++m_inhibitCalls;
+        DBusMessage reply = DBusMessage::CreateMethodReturn(call);
+        reply.AppendUnixFd(ends[1]);
+        close(ends[1]);
+        m_locks.push_back({ ends[0], what });
+        m_bus.Send(reply);
+    }
+
+    void Get(DBusMessage& call) {
+        std::string interface;
+        std::string name;
+        call.ReadString(interface);
+        call.ReadString(name);
+        DBusMessage reply = DBusMessage::CreateMethodReturn(call);
+        if (name == "IdleAction") {
+            reply.AppendVariant('s');
+            reply.AppendString("suspend");
+        } else if (name == "IdleActionUSec") {
+            reply.AppendVariant('t');
+            reply.AppendUint64(30ULL * 60ULL * 1000000ULL);
+        } else if (name == "BlockInhibited") {
+            reply.AppendVariant('s');
+            reply.AppendString(Blocked());
+        } else if (name == "Active" || name == "LockedHint") {
+            reply.AppendVariant('b');
+            reply.AppendBool(name == "Active" ? m_active : m_locked);
+        } else {
+            m_bus.Send(DBusMessage::CreateError(call, "org.freedesktop.DBus.Error.UnknownProperty"));
+            return;
+        }
+        m_bus.Send(reply);
+    }
+
+    void EmitPending() {
+        const int locked = m_pendingLocked.exchange(-1);
+        if (locked >= 0) {
+            m_locked = (locked != 0);
+            m_bus.Send(DBusMessage::CreateSignal(SESSION_PATH, "org.freedesktop.login1.Session",
+                                                 m_locked ? "Lock" : "Unlock"));
+            PropertiesChanged();
+        }
+        const int active = m_pendingActive.exchange(-1);
+        if (active >= 0) {
+            m_active = (active != 0);
+            PropertiesChanged();
+        }
+    }
+
+    // logind only lists the changed names (invalidated), clients re-read them.
+    void PropertiesChanged() {
+        DBusMessage signal = DBusMessage::CreateSignal(SESSION_PATH, "org.freedesktop.DBus.Properties",
+                                                       "PropertiesChanged");
+        signal.AppendString("org.freedesktop.login1.Session");
+        signal.AppendEmptyArray("{sv}");
+        signal.AppendEmptyArray("s");
+        m_bus.Send(signal);
+    }
+
+    // Colon-separated union of the live locks' "what", like logind's property.
+    std::string Blocked() const {
+        std::string out;
+        for (const char* kind : { "sleep", "idle" }) {
+            const std::string needle = std::string(":") + kind + ":";
+            for (const Lock& lock : m_locks) {
+                if ((":" + lock.what + ":").find(needle) != std::string::npos) {
+                    out += out.empty() ? kind : std::string(":") + kind;
+                    break;
+                }
+            }
+        }
+        return out;
+    }
+
+    void DropReleased() {
+        for (size_t i = 0; i < m_locks.size();) {
+            pollfd pfd = { m_locks[i].fd, 0, 0 };
+            if (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLHUP)) {
+                close(m_locks[i].fd);
+                m_locks.erase(m_locks.begin() + static_cast<std::ptrdiff_t>(i));
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    DBusConnection m_bus;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{ false };
+    std::atomic<bool> m_dropLocks{ false };
+    std::atomic<unsigned> m_inhibitCalls{ 0 };
+    std::atomic<int> m_pendingLocked{ -1 };
+    std::atomic<int> m_pendingActive{ -1 };
+    std::vector<Lock> m_locks;
+    bool m_locked = false;
+    bool m_active = true;
+    bool m_ready = false;
+};
+
+} // namespace Bench
+} // namespace Everon
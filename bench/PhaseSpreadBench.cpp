@@ -0,0 +1,105 @@
+// Keypress load on a terminal server: hundreds of sessions start within seconds of each
+// other (logon storm) with the default 59 s period. Compares the relative schedule
+// (first press one period after start) with the per-session phase on the shared
+// monotonic grid, with and without jitter, by the peak number of sessions pressing
+// a key within the same few milliseconds. Also measures the per-session setup cost.
+
+#include "BenchUtil.h"
+#include "Clock.h"
+#include "PeriodicScheduler.h"
+#include "PhaseSpread.h"
+#include <algorithm>
+#include <cstdio>
+#include <cwchar>
+#include <random>
+#include <vector>
+
+using namespace Everon;
+
+namespace {
+
+constexpr size_t kSessions = 500;
+constexpr ULONGLONG kPeriod = 59ULL * Clock::TICKS_PER_SEC;
+constexpr ULONGLONG kLogonSpread = 3ULL * Clock::TICKS_PER_SEC;     // all sessions start within 3 s
+constexpr ULONGLONG kBoot = 3600ULL * Clock::TICKS_PER_SEC;          // host uptime at the storm
+constexpr ULONGLONG kSimulated = 3600ULL * Clock::TICKS_PER_SEC;
+constexpr ULONGLONG kWindow = 5ULL * Clock::TICKS_PER_MS;            // CPU burst per keypress
+
+enum class Mode { Relative, Phase, PhaseJitter };
+
+std::wstring Identity(size_t session) {
+    wchar_t buffer[64] = {};
+    std::swprintf(buffer, sizeof(buffer) / sizeof(buffer[0]), L"CORP\\user%03zu#%zu", session, session + 2);
+    return buffer;
+}
+
+// Fire times of every session over the simulated hour.
+std::vector<ULONGLONG> Simulate(Mode mode) {
+    std::mt19937_64 rng{ 11 };
+    std::uniform_int_distribution<ULONGLONG> logon{ 0, kLogonSpread };
+    std::exponential_distribution<double> delayMs{ 1.0 / 2.0 };   // message-pump delay, mean 2 ms
+
+    std::vector<ULONGLONG> fires;
+    for (size_t s = 0; s < kSessions; ++s) {
+        const ULONGLONG start = kBoot + logon(rng);
+        const ULONGLONG hash = PhaseSpread::HashIdentity(Identity(s));
+        PeriodicScheduler scheduler;
+        if (mode == Mode::PhaseJitter) {
+            scheduler.SetJitter(5ULL * Clock::TICKS_PER_SEC, hash);
+        }
+        if (mode == Mode::Relative) {
+            scheduler.Start(start, kPeriod);
+        } else {
+            scheduler.StartAligned(start, kPeriod, PhaseSpread::PhaseOffset(hash, kPeriod));
+        }
+        while (scheduler.GetNextDeadline() < kBoot + kSimulated) {
+            const ULONGLONG wake = scheduler.GetNextDeadline() +
+                static_cast<ULONGLONG>(delayMs(rng) * static_cast<double>(Clock::TICKS_PER_MS));
+            if (scheduler.OnWake(wake) != 0) {
+                fires.push_back(wake);
+            }
+        }
+    }
+    std::sort(fires.begin(), fires.end());
+    return fires;
+}
+
+// Largest number of fires inside any window of the given width.
+size_t PeakConcurrency(const std::vector<ULONGLONG>& fires, ULONGLONG window) {
+    size_t peak = 0;
+    size_t first = 0;
+    for (size_t i = 0; i < fires.size(); ++i) {
+        while (fires[i] - fires[first] >= window) {
+            ++first;
+        }
+        peak = (std::max)(peak, i - first + 1);
+    }
+    return peak;
+}
+
+void Report(const char* name, Mode mode) {
+    const std::vector<ULONGLONG> fires = Simulate(mode);
+    std::printf("%-22s fires=%zu  peak/5ms=%zu  peak/100ms=%zu  peak/1s=%zu\n", name, fires.size(),
+                PeakConcurrency(fires, kWindow), PeakConcurrency(fires, 100ULL * Clock::TICKS_PER_MS),
+                PeakConcurrency(fires, Clock::TICKS_PER_SEC));
+}
+
+} // namespace
+
+int main() {
+    std::printf("%zu sessions, period %llus, logon storm %llus, 1 h simulated\n", kSessions,
+                static_cast<unsigned long long>(kPeriod / Clock::TICKS_PER_SEC),
+                static_cast<unsigned long long>(kLogonSpread / Clock::TICKS_PER_SEC));
+    Report("relative (Start)", Mode::Relative);
+    Report("phase", Mode::Phase);
+    Report("phase + 5 s jitter", Mode::PhaseJitter);
+    std::printf("uniform spread: mean %.2f fires per 5 ms\n\n",
+                static_cast<double>(kSessions) * static_cast<double>(kWindow) / static_cast<double>(kPeriod));
+
+    const std::wstring identity = Identity(42);
+    Bench::Run("HashIdentity + PhaseOffset", 1000000, [&](long long i) {
+        const ULONGLONG hash = PhaseSpread::HashIdentity(identity) + static_cast<ULONGLONG>(i);
+        Bench::DoNotOptimize(PhaseSpread::PhaseOffset(hash, kPeriod));
+    });
+    return 0;
+}
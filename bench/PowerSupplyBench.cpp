@@ -0,0 +1,95 @@
+// Battery policy against a fake /sys/class/power_supply tree: checks the AC/battery
+// reading and the policy decision for plugged, unplugged and low-charge states, then
+// times one evaluation (the work done per power_supply uevent; nothing polls).
+
+#include "BatteryPolicy.h"
+#include "BenchUtil.h"
+#include "PowerSupplyMonitor.h"
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Everon;
+
+namespace {
+
+int g_failures = 0;
+std::vector<std::string> g_created;     // removed in reverse order at exit
+
+void WriteAttribute(const std::string& root, const char* supply, const char* name, const char* value) {
+    const std::string dir = root + "/" + supply;
+    if (mkdir(dir.c_str(), 0755) == 0) {
+        g_created.push_back(dir);
+    }
+    const std::string path = dir + "/" + name;
+    if (FILE* file = std::fopen(path.c_str(), "w")) {
+        std::fprintf(file, "%s\n", value);
+        std::fclose(file);
+        g_created.push_back(path);
+    }
+}
+
+void SetState(const std::string& root, bool acOnline, int percent) {
+    WriteAttribute(root, "AC", "online", acOnline ? "1" : "0");
+    WriteAttribute(root, "BAT0", "capacity", std::to_string(percent).c_str());
+    WriteAttribute(root, "BAT0", "status", acOnline ? "Charging" : "Discharging");
+}
+
+void Check(const char* what, const std::string& root, const BatteryPolicy& policy, BatteryAction expected) {
+    PowerSupplyStatus status;
+    const bool read = PowerSupply::QuerySysfs(root.c_str(), status);
+    const BatteryAction action = policy.Evaluate(status);
+    const bool ok = read && action == expected;
+    g_failures += ok ? 0 : 1;
+    std::printf("%-44s %s (battery %d, on battery %d, %d%%, action %lu)\n", what, ok ? "ok" : "FAILED",
+                status.hasBattery ? 1 : 0, status.onBattery ? 1 : 0, status.percent,
+                static_cast<unsigned long>(action));
+}
+
+} // namespace
+
+int main() {
+    char root[] = "/tmp/everon-power-supply-XXXXXX";
+    if (!mkdtemp(root)) {
+        std::printf("mkdtemp failed\n");
+        return 1;
+    }
+
+    WriteAttribute(root, "AC", "type", "Mains");
+    WriteAttribute(root, "BAT0", "type", "Battery");
+    // A wireless mouse's battery must not count as the system's.
+    WriteAttribute(root, "hidpp_battery_0", "type", "Battery");
+    WriteAttribute(root, "hidpp_battery_0", "scope", "Device");
+    WriteAttribute(root, "hidpp_battery_0", "capacity", "5");
+
+    BatteryPolicy policy;
+    policy.onBattery = BatteryAction::DropDisplay;
+    policy.lowPercent = 20;
+    policy.whenLow = BatteryAction::Suspend;
+
+    SetState(root, true, 80);
+    Check("on AC", root, policy, BatteryAction::None);
+    SetState(root, false, 80);
+    Check("unplugged: drop display", root, policy, BatteryAction::DropDisplay);
+    SetState(root, false, 20);
+    Check("low charge: suspend", root, policy, BatteryAction::Suspend);
+    SetState(root, true, 20);
+    Check("plugged in again", root, policy, BatteryAction::None);
+
+    PowerSupplyStatus status;
+    Bench::Run("QuerySysfs + Evaluate (per uevent)", 20000, [&](long long) {
+        PowerSupply::QuerySysfs(root, status);
+        Bench::DoNotOptimize(policy.Evaluate(status));
+    });
+
+    PowerSupplyMonitor monitor;
+    std::printf("%-44s %s\n", "uevent monitor", monitor.Start() ? "listening" : "unavailable here");
+
+    for (auto it = g_created.rbegin(); it != g_created.rend(); ++it) {
+        remove(it->c_str());
+    }
+    rmdir(root);
+    return g_failures == 0 ? 0 : 1;
+}
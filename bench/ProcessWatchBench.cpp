@@ -0,0 +1,193 @@
+// Process watch rules: matching throughput for bursts of process starts (a build or a
+// login storm starting thousands of processes) against a short and a long rule list,
+// versus a linear case-insensitive scan of the rules. On Linux it then watches a real
+// burst through the process connector: the watched job must be seen starting and
+// exiting, and the CPU spent per event is reported.
+
+#include "BenchUtil.h"
+#include "ProcessWatch.h"
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <ctime>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace Everon;
+
+namespace {
+
+constexpr long long kStarts = 1000000;
+
+// Image names as the OS reports them: mixed case, some with paths, some with ".exe".
+std::vector<std::string> MakeImages(size_t count) {
+    static const char* const kStems[] = { "svchost", "chrome", "Code", "bash", "git", "cc1plus", "ld", "python3",
+                                          "RuntimeBroker", "conhost", "node", "make", "sh", "sed", "grep" };
+    std::mt19937 rng{ 11 };
+    std::vector<std::string> out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string name = kStems[rng() % (sizeof(kStems) / sizeof(kStems[0]))];
+        switch (rng() % 4) {
+            case 0: name = "C:\\Windows\\System32\\" + name + ".exe"; break;
+            case 1: name += ".EXE"; break;
+            case 2: name = "/usr/bin/" + name; break;
+            default: break;
+        }
+        // About 1 in 100 starts is a watched job.
+        if (rng() % 100 == 0) {
+            name = (rng() % 2) ? "RoboCopy.exe" : "/usr/bin/rsync";
+        }
+        out.push_back(std::move(name));
+    }
+    return out;
+}
+
+std::wstring MakeRules(size_t count) {
+    std::wstring rules = L"robocopy;ffmpeg;rsync";
+    for (size_t i = 3; i < count; ++i) {
+        rules += L";job" + std::to_wstring(i) + L".exe";
+    }
+    return rules;
+}
+
+bool EqualsNoCase(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RunMatchBench(const std::vector<std::string>& images, size_t ruleCount) {
+    ProcessWatchList list;
+    list.SetNames(MakeRules(ruleCount));
+    const size_t mask = images.size() - 1;
+    char label[64];
+
+    std::snprintf(label, sizeof(label), "start + exit, %zu rules", ruleCount);
+    size_t matched = 0;
+    Bench::Run(label, kStarts, [&](long long i) {
+        const DWORD pid = static_cast<DWORD>(i);
+        matched += list.OnStart(pid, images[static_cast<size_t>(i) & mask]) ? 1 : 0;
+        list.OnExit(pid);
+    });
+    std::printf("  matched %zu\n", matched);
+
+    // The obvious alternative: compare against every rule, with and without ".exe".
+    std::vector<std::string> rules(list.GetNames().begin(), list.GetNames().end());
+    std::snprintf(label, sizeof(label), "linear scan, %zu rules", ruleCount);
+    matched = 0;
+    Bench::Run(label, kStarts, [&](long long i) {
+        const std::string& image = images[static_cast<size_t>(i) & mask];
+        const size_t slash = image.find_last_of("/\\");
+        const std::string name = (slash == std::string::npos) ? image : image.substr(slash + 1);
+        for (const std::string& rule : rules) {
+            if (EqualsNoCase(name, rule) || EqualsNoCase(name, rule + ".exe")) {
+                ++matched;
+                break;
+            }
+        }
+    });
+    std::printf("  matched %zu\n", matched);
+}
+
+#ifndef _WIN32
+double ThreadCpuNs() {
+    timespec now = {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) * 1e9 + static_cast<double>(now.tv_nsec);
+}
+
+pid_t Spawn(const char* path, const char* arg) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+        execl(path, path, arg, static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    return pid;
+}
+
+// Drains the watcher for up to `timeoutMs`; returns the CPU time spent consuming.
+double Drain(ProcessWatcher& watcher, int timeoutMs) {
+    double cpu = 0;
+    pollfd pfd = { watcher.GetFd(), POLLIN, 0 };
+    while (poll(&pfd, 1, timeoutMs) > 0) {
+        const double before = ThreadCpuNs();
+        watcher.Consume();
+        cpu += ThreadCpuNs() - before;
+    }
+    return cpu;
+}
+
+int RunConnectorBench() {
+    ProcessWatchList list;
+    list.SetNames(L"sleep");
+    ProcessWatcher watcher(list);
+    if (!watcher.Start()) {
+        std::printf("process connector unavailable (needs CAP_NET_ADMIN); skipped\n");
+        return 0;
+    }
+
+    int failures = 0;
+    const pid_t job = Spawn("/bin/sleep", "2");
+    Drain(watcher, 200);
+    const bool seenStart = list.IsAnyRunning();
+    failures += seenStart ? 0 : 1;
+    std::printf("%-44s %s\n", "watched job start seen", seenStart ? "ok" : "FAILED");
+
+    // A burst of short-lived unwatched processes while the job runs.
+    constexpr int kBurst = 2000;
+    const ULONGLONG eventsBefore = watcher.GetEventCount();
+    double cpu = 0;
+    for (int i = 0; i < kBurst; ++i) {
+        const pid_t child = Spawn("/bin/true", nullptr);
+        if (child > 0) {
+            waitpid(child, nullptr, 0);
+        }
+        if (i % 100 == 99) {
+            cpu += Drain(watcher, 0);
+        }
+    }
+    cpu += Drain(watcher, 100);
+    const ULONGLONG events = watcher.GetEventCount() - eventsBefore;
+    std::printf("%-44s %llu events, %.0f ns CPU/event, %llu rescans\n", "burst of 2000 processes",
+                static_cast<unsigned long long>(events), events ? cpu / static_cast<double>(events) : 0.0,
+                static_cast<unsigned long long>(watcher.GetScanCount()));
+    const bool stillRunning = list.IsAnyRunning();
+    failures += stillRunning ? 0 : 1;
+    std::printf("%-44s %s\n", "job still tracked after the burst", stillRunning ? "ok" : "FAILED");
+
+    kill(job, SIGTERM);
+    waitpid(job, nullptr, 0);
+    Drain(watcher, 200);
+    const bool seenExit = !list.IsAnyRunning();
+    failures += seenExit ? 0 : 1;
+    std::printf("%-44s %s\n", "watched job exit seen", seenExit ? "ok" : "FAILED");
+    return failures ? 1 : 0;
+}
+#endif
+
+} // namespace
+
+int main() {
+    const std::vector<std::string> images = MakeImages(1 << 16);
+    RunMatchBench(images, 3);
+    RunMatchBench(images, 200);
+#ifndef _WIN32
+    return RunConnectorBench();
+#else
+    return 0;
+#endif
+}
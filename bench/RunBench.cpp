@@ -0,0 +1,103 @@
+// `everon run` startup overhead: a short command (/bin/true) run directly versus
+// wrapped, with no keep-awake mechanism and with a logind stand-in on a private bus
+// (one inhibitor lock taken and released per run). Also checks that exit codes and
+// terminating signals come through the wrapper unchanged. Runs offline.
+//
+// Usage: everon-bench-run [bus address]
+// Without an address, $DBUS_SESSION_BUS_ADDRESS is used, else a private dbus-daemon is
+// started for the run.
+
+#include "BenchUtil.h"
+#include "LogindStub.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <spawn.h>
+#include <string>
+#include <sys/wait.h>
+#include <vector>
+
+extern char** environ;
+
+using namespace Everon;
+
+namespace {
+
+constexpr long long kRuns = 200;
+int g_failures = 0;
+
+// Runs argv (stderr discarded: debug builds log there) and returns the wait status.
+int RunStatus(const std::vector<const char*>& argv) {
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+    std::vector<char*> args;
+    for (const char* arg : argv) {
+        args.push_back(const_cast<char*>(arg));
+    }
+    args.push_back(nullptr);
+    pid_t pid = 0;
+    int status = -1;
+    if (posix_spawn(&pid, args[0], &actions, nullptr, args.data(), environ) == 0) {
+        waitpid(pid, &status, 0);
+    }
+    posix_spawn_file_actions_destroy(&actions);
+    return status;
+}
+
+void Check(const char* what, bool ok) {
+    g_failures += ok ? 0 : 1;
+    std::printf("%-44s %s\n", what, ok ? "ok" : "FAILED");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* everon = EVERON_CLI_PATH;
+
+    int status = RunStatus({ everon, "run", "--", "/bin/sh", "-c", "exit 3" });
+    Check("exit code 3 passed through", WIFEXITED(status) && WEXITSTATUS(status) == 3);
+    status = RunStatus({ everon, "run", "--", "/bin/sh", "-c", "kill -TERM $$" });
+    Check("SIGTERM passed through", WIFSIGNALED(status) && WTERMSIG(status) == SIGTERM);
+    status = RunStatus({ everon, "run", "--", "/nonexistent/command" });
+    Check("missing command is 127", WIFEXITED(status) && WEXITSTATUS(status) == 127);
+
+    const double direct = Bench::Run("/bin/true", kRuns, [](long long) {
+        RunStatus({ "/bin/true" });
+    });
+    setenv("DBUS_SYSTEM_BUS_ADDRESS", "unix:path=/nonexistent", 1);
+    const double unheld = Bench::Run("everon run -- /bin/true (nothing holds)", kRuns, [everon](long long) {
+        RunStatus({ everon, "run", "--", "/bin/true" });
+    });
+    std::printf("  overhead %.2f ms\n", (unheld - direct) / 1e6);
+
+    pid_t daemon = 0;
+    std::string address;
+    if (argc > 1) {
+        address = argv[1];
+    } else if (const char* session = std::getenv("DBUS_SESSION_BUS_ADDRESS"); session && *session) {
+        address = session;
+    } else {
+        address = Bench::StartPrivateBus(daemon);
+    }
+    if (address.empty()) {
+        std::printf("no message bus for the logind stand-in; held run skipped\n");
+        return g_failures ? 1 : 0;
+    }
+    {
+        Bench::LogindStub stub(address);
+        if (stub.IsReady()) {
+            setenv("DBUS_SYSTEM_BUS_ADDRESS", address.c_str(), 1);
+            const double held = Bench::Run("everon run -- /bin/true (logind hold)", kRuns, [everon](long long) {
+                RunStatus({ everon, "run", "--", "/bin/true" });
+            });
+            std::printf("  overhead %.2f ms\n", (held - direct) / 1e6);
+            Check("one inhibitor lock per run", stub.GetInhibitCalls() == static_cast<unsigned>(kRuns));
+        }
+    }
+    if (daemon > 0) {
+        kill(daemon, SIGTERM);
+    }
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+// Sensor sampler: the wakeups a day of monitoring costs as sensors are added (shared
+// aligned tick versus one timer per sensor), the sampler's own overhead per read, and
+// the per-sensor cost report for the real activity sensors.
+
+#include "ActivityMonitor.h"
+#include "BenchUtil.h"
+#include "Clock.h"
+#include "SensorSampler.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Everon;
+
+namespace {
+
+constexpr ULONGLONG kSec = Clock::TICKS_PER_SEC;
+constexpr ULONGLONG kDay = 24ULL * 3600ULL * kSec;
+
+// A sensor that is near its threshold during a few random stretches of the day (a
+// download, a build) and stable otherwise.
+struct SimulatedSensor {
+    std::vector<std::pair<ULONGLONG, ULONGLONG>> busy;
+
+    SensorTrend Read(ULONGLONG now) const {
+        for (const auto& span : busy) {
+            if (now >= span.first && now < span.second) {
+                return SensorTrend::NearThreshold;
+            }
+        }
+        return SensorTrend::Stable;
+    }
+};
+
+std::vector<SimulatedSensor> MakeSensors(size_t count) {
+    std::mt19937_64 rng{ 17 };
+    std::vector<SimulatedSensor> sensors(count);
+    for (SimulatedSensor& sensor : sensors) {
+        for (int i = 0; i < 3; ++i) {
+            const ULONGLONG start = rng() % kDay;
+            sensor.busy.emplace_back(start, start + (10 + rng() % 50) * 60 * kSec);
+        }
+    }
+    return sensors;
+}
+
+// One simulated day; returns the number of wakeups.
+ULONGLONG SimulateDay(size_t count) {
+    const std::vector<SimulatedSensor> sensors = MakeSensors(count);
+    SensorSampler sampler;
+    for (size_t i = 0; i < count; ++i) {
+        const SimulatedSensor& sensor = sensors[i];
+        sampler.Add("sim", 15 * kSec, 60 * kSec, [&sensor](ULONGLONG now) { return sensor.Read(now); }, 0);
+    }
+    ULONGLONG deadline = 0;
+    ULONGLONG tolerance = 0;
+    while (sampler.GetNextDeadline(deadline, tolerance) && deadline < kDay) {
+        sampler.Run(deadline);
+    }
+    const ULONGLONG fixed = static_cast<ULONGLONG>(count) * (kDay / (15 * kSec));
+    std::printf("%3zu sensors: %6llu wakeups shared, %7llu adaptive reads, %7llu fixed 15 s timers\n", count,
+                static_cast<unsigned long long>(sampler.GetWakeupCount()),
+                static_cast<unsigned long long>(sampler.GetReadCount()), static_cast<unsigned long long>(fixed));
+    return sampler.GetWakeupCount();
+}
+
+void RunOverheadBench() {
+    SensorSampler sampler;
+    int reads = 0;
+    for (int i = 0; i < 16; ++i) {
+        sampler.Add("noop", kSec, kSec, [&reads](ULONGLONG) {
+            ++reads;
+            return SensorTrend::Stable;
+        }, 0);
+    }
+    constexpr long long kBatches = 200000;
+    const double ns = Bench::Run("batch of 16 trivial sensors", kBatches, [&](long long i) {
+        sampler.Run(static_cast<ULONGLONG>(i + 1) * kSec);
+    });
+    std::printf("  %.1f ns per read, including the CPU-time accounting\n", ns / 16.0);
+    Bench::DoNotOptimize(reads);
+}
+
+// The real activity sensors on a simulated clock (every batch reads all three), with
+// the per-sensor cost as the app logs it.
+void RunActivityReport() {
+    ActivityMonitor monitor;
+    monitor.Configure(50, 1024, 1024, 60 * kSec);
+    SensorSampler sampler;
+    for (size_t i = 0; i < static_cast<size_t>(ActivityKind::Count); ++i) {
+        const ActivityKind kind = static_cast<ActivityKind>(i);
+        if (!monitor.IsEnabled(kind)) {
+            continue;
+        }
+        monitor.Sample(kind, 0);
+        sampler.Add(ActivityMonitor::GetName(kind), 16 * kSec, 16 * kSec, [&monitor, kind](ULONGLONG now) {
+            monitor.Sample(kind, now);
+            return monitor.GetTrigger(kind).GetTrend();
+        }, 0);
+    }
+    for (ULONGLONG now = 16 * kSec; now <= 2000 * 16 * kSec; now += 16 * kSec) {
+        sampler.Run(now);
+    }
+    std::printf("activity sensors: %s\n", sampler.DescribeStats().c_str());
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    const ULONGLONG one = SimulateDay(1);
+    for (size_t count : { 4, 16, 64 }) {
+        const ULONGLONG wakeups = SimulateDay(count);
+        // Aligned reads share wakeups: more sensors may only fill in the gaps a quiet
+        // sensor left by backing off, never exceed the fastest interval's grid.
+        if (wakeups > kDay / (16 * kSec)) {
+            ++failures;
+        }
+    }
+    std::printf("%-44s %s (1 sensor: %llu)\n", "wakeups bounded by the shortest interval", failures ? "FAILED" : "ok",
+                static_cast<unsigned long long>(one));
+    RunOverheadBench();
+    RunActivityReport();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+// Keypress cadence over a simulated week: a relative re-arm (what SetTimer with
+// periodSec * 1000 does) versus PeriodicScheduler's absolute monotonic grid, with the
+// same random wakeup delays. Also measures the per-wakeup bookkeeping cost.
+
+#include "BenchUtil.h"
+#include "Clock.h"
+#include "PeriodicScheduler.h"
+#include <cstdio>
+#include <random>
+
+using namespace Everon;
+
+namespace {
+
+constexpr ULONGLONG kPeriod = 60ULL * Clock::TICKS_PER_SEC;
+constexpr ULONGLONG kIdleWindow = 120ULL * Clock::TICKS_PER_SEC;   // e.g. a 2-minute screen timeout
+constexpr ULONGLONG kSimulated = 7ULL * 24ULL * 3600ULL * Clock::TICKS_PER_SEC;
+
+// Message-pump delay before a due timer is serviced: mostly a few ms, sometimes a
+// busy UI thread (hundreds of ms), rarely a multi-second stall.
+struct DelayModel {
+    std::mt19937_64 rng{ 42 };
+    std::exponential_distribution<double> normal{ 1.0 / 8.0 };     // mean 8 ms
+    std::uniform_real_distribution<double> unit{ 0.0, 1.0 };
+
+    ULONGLONG Next() {
+        double ms = normal(rng);
+        const double roll = unit(rng);
+        if (roll < 0.01) {
+            ms += 300.0 + 700.0 * unit(rng);
+        } else if (roll < 0.0115) {
+            ms += 5000.0 * unit(rng);
+        }
+        return static_cast<ULONGLONG>(ms * static_cast<double>(Clock::TICKS_PER_MS));
+    }
+};
+
+void Report(const char* name, const LatencyHistogram& lateness, ULONGLONG maxInterval,
+            ULONGLONG fires, ULONGLONG expectedFires) {
+    std::printf("%s\n", name);
+    std::printf("  fires %llu (grid %llu), lateness %ls\n",
+                static_cast<unsigned long long>(fires), static_cast<unsigned long long>(expectedFires),
+                lateness.Format().c_str());
+    std::printf("  max interval %.3fs, inside %.0fs idle window: %s\n",
+                static_cast<double>(maxInterval) / Clock::TICKS_PER_SEC,
+                static_cast<double>(kIdleWindow) / Clock::TICKS_PER_SEC,
+                maxInterval < kIdleWindow ? "yes" : "NO");
+}
+
+} // namespace
+
+int main() {
+    const ULONGLONG expectedFires = kSimulated / kPeriod;
+
+    // Relative re-arm: each wakeup schedules "now + period", so delays accumulate.
+    {
+        VirtualClock clock(0);
+        DelayModel delays;
+        const ULONGLONG origin = clock.NowMonotonic();
+        ULONGLONG due = origin + kPeriod;
+        ULONGLONG lastFire = 0;
+        ULONGLONG maxInterval = 0;
+        ULONGLONG fires = 0;
+        LatencyHistogram lateness;
+        while (due - origin <= kSimulated) {
+            clock.Advance(due - clock.NowMonotonic() + delays.Next());
+            const ULONGLONG now = clock.NowMonotonic();
+            lateness.Record(now - (origin + (fires + 1) * kPeriod)); // versus the ideal grid
+            if (lastFire && now - lastFire > maxInterval) {
+                maxInterval = now - lastFire;
+            }
+            lastFire = now;
+            ++fires;
+            due = now + kPeriod;
+        }
+        Report("relative re-arm (SetTimer)", lateness, maxInterval, fires, expectedFires);
+    }
+
+    // Absolute grid.
+    {
+        VirtualClock clock(0);
+        DelayModel delays;
+        const ULONGLONG origin = clock.NowMonotonic();
+        PeriodicScheduler scheduler;
+        scheduler.Start(origin, kPeriod);
+        while (scheduler.GetNextDeadline() - origin <= kSimulated) {
+            clock.Advance(scheduler.GetNextDeadline() - clock.NowMonotonic() + delays.Next());
+            scheduler.OnWake(clock.NowMonotonic());
+        }
+        Report("absolute grid (PeriodicScheduler)", scheduler.GetLateness(), scheduler.GetMaxInterval(),
+               scheduler.GetFiredCount(), expectedFires);
+    }
+
+    PeriodicScheduler scheduler;
+    scheduler.Start(0, kPeriod);
+    Bench::Run("PeriodicScheduler::OnWake", 20000000LL, [&](long long i) {
+        Bench::DoNotOptimize(scheduler.OnWake(static_cast<ULONGLONG>(i + 1) * kPeriod + static_cast<ULONGLONG>(i & 1023)));
+    });
+    return 0;
+}
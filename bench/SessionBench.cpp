@@ -0,0 +1,105 @@
+// Session monitor against a stand-in logind on a private bus: checks that Lock/Unlock
+// and Active changes are picked up from the signals alone, and measures how long a
+// change takes to be noticed and what a wake-up costs. Runs offline.
+//
+// Usage: everon-bench-session [bus address]
+// Without an address, $DBUS_SESSION_BUS_ADDRESS is used, else a private dbus-daemon is
+// started for the run.
+
+#include "BenchUtil.h"
+#include "LogindStub.h"
+#include "SessionMonitor.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <poll.h>
+#include <string>
+#include <sys/types.h>
+
+using namespace Everon;
+
+namespace {
+
+int g_failures = 0;
+
+// Waits for the monitor's socket and consumes it until the state changes; returns the
+// wait in microseconds, -1 on timeout.
+double WaitForChange(SessionMonitor& monitor, int timeoutMs) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::milliseconds(timeoutMs);
+    while (std::chrono::steady_clock::now() < deadline) {
+        pollfd pfd = { monitor.GetFd(), POLLIN, 0 };
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (poll(&pfd, 1, static_cast<int>(left.count()) + 1) > 0 && monitor.Consume()) {
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+    return -1.0;
+}
+
+void Check(const char* what, const SessionMonitor& monitor, bool locked, bool active, double waitUs) {
+    const SessionState& state = monitor.GetState();
+    const bool ok = waitUs >= 0 && state.locked == locked && state.active == active;
+    g_failures += ok ? 0 : 1;
+    std::printf("%-28s %s (locked=%d active=%d idle=%d, noticed after %.0f us)\n", what, ok ? "ok" : "FAILED",
+                state.locked, state.active, state.IsIdle(), waitUs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    pid_t daemon = 0;
+    std::string address;
+    if (argc > 1) {
+        address = argv[1];
+    } else if (const char* session = std::getenv("DBUS_SESSION_BUS_ADDRESS"); session && *session) {
+        address = session;
+    } else {
+        address = Bench::StartPrivateBus(daemon);
+    }
+    if (address.empty()) {
+        std::printf("no message bus (pass an address or install dbus-daemon); skipped\n");
+        return 0;
+    }
+
+    int result = 0;
+    {
+        Bench::LogindStub stub(address);
+        SessionMonitor monitor(address);
+        if (!stub.IsReady()) {
+            std::printf("could not own org.freedesktop.login1 on %s\n", address.c_str());
+            result = 1;
+        } else if (!monitor.Start()) {
+            std::printf("session monitor did not start\n");
+            result = 1;
+        } else {
+            std::printf("%-28s %s\n", "session", monitor.GetSessionPath().c_str());
+            stub.SetLocked(true);
+            Check("locked", monitor, true, true, WaitForChange(monitor, 2000));
+            stub.SetActive(false);
+            Check("disconnected", monitor, true, false, WaitForChange(monitor, 2000));
+            stub.SetLocked(false);
+            Check("unlocked while away", monitor, false, false, WaitForChange(monitor, 2000));
+            stub.SetActive(true);
+            Check("reconnected", monitor, false, true, WaitForChange(monitor, 2000));
+
+            // A wake-up with nothing to read costs one non-blocking recv.
+            Bench::Run("Consume (nothing pending)", 100000, [&](long long) {
+                Bench::DoNotOptimize(monitor.Consume());
+            });
+            // Lock + unlock round trip, including the stub's 50 ms poll granularity.
+            Bench::Run("lock + unlock noticed", 20, [&](long long) {
+                stub.SetLocked(true);
+                WaitForChange(monitor, 2000);
+                stub.SetLocked(false);
+                WaitForChange(monitor, 2000);
+            });
+            result = g_failures ? 1 : 0;
+        }
+    }
+    if (daemon > 0) {
+        kill(daemon, SIGTERM);
+    }
+    return result;
+}
@@ -0,0 +1,126 @@
+// TimingWheel versus an ordered std::multimap (the obvious priority queue) for the
+// operations App performs: schedule, cancel, and advancing time over due entries.
+// Deadlines are spread over minutes to hours, like keypress, tooltip and expiry timers.
+// Also checks that the coalesced wakeup honours the tolerance of every entry it covers.
+
+#include "BenchUtil.h"
+#include "Clock.h"
+#include "TimingWheel.h"
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace Everon;
+
+namespace {
+
+constexpr size_t kActive = 10000;
+constexpr long long kOps = 1000000;
+
+std::vector<ULONGLONG> MakeOffsets(size_t count) {
+    std::mt19937_64 rng{ 7 };
+    std::uniform_int_distribution<ULONGLONG> offset{ Clock::TICKS_PER_SEC, 4ULL * 3600ULL * Clock::TICKS_PER_SEC };
+    std::vector<ULONGLONG> out(count);
+    for (auto& value : out) {
+        value = offset(rng);
+    }
+    return out;
+}
+
+// A slack entry (an expiry, 60 s late allowed) followed by a tight one (a keypress,
+// 3 s): waking as late as the first allows would fire the second 47 s past its limit.
+int CheckCoalescedTolerance() {
+    constexpr ULONGLONG kSec = Clock::TICKS_PER_SEC;
+    TimingWheel wheel(0);
+    wheel.Schedule(60 * kSec, []() {}, 60 * kSec);
+    wheel.Schedule(70 * kSec, []() {}, 3 * kSec);
+    ULONGLONG deadline = 0;
+    ULONGLONG tolerance = 0;
+    const bool ok = wheel.GetNextDeadline(deadline, tolerance) && deadline == 60 * kSec &&
+                    deadline + tolerance == 73 * kSec;
+    std::printf("%-44s %s (wake at %llu s, as late as %llu s)\n", "coalesced wakeup within every tolerance",
+                ok ? "ok" : "FAILED", static_cast<unsigned long long>(deadline / kSec),
+                static_cast<unsigned long long>((deadline + tolerance) / kSec));
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+int main() {
+    const int failures = CheckCoalescedTolerance();
+    const std::vector<ULONGLONG> offsets = MakeOffsets(1 << 16);
+    const size_t mask = offsets.size() - 1;
+    size_t fired = 0;
+    auto callback = [&fired]() { ++fired; };
+
+    // Steady state: kActive timers pending, each op cancels one and schedules a replacement
+    // (a re-armed keypress or expiry).
+    {
+        TimingWheel wheel(0);
+        std::vector<TimingWheel::TimerId> ids(kActive);
+        for (size_t i = 0; i < kActive; ++i) {
+            ids[i] = wheel.Schedule(offsets[i & mask], callback);
+        }
+        Bench::Run("TimingWheel cancel + schedule", kOps, [&](long long i) {
+            TimingWheel::TimerId& id = ids[static_cast<size_t>(i) % kActive];
+            wheel.Cancel(id);
+            id = wheel.Schedule(offsets[static_cast<size_t>(i) & mask], callback);
+        });
+    }
+    {
+        std::multimap<ULONGLONG, TimingWheel::Callback> queue;
+        std::vector<std::multimap<ULONGLONG, TimingWheel::Callback>::iterator> ids(kActive);
+        for (size_t i = 0; i < kActive; ++i) {
+            ids[i] = queue.emplace(offsets[i & mask], callback);
+        }
+        Bench::Run("std::multimap erase + insert", kOps, [&](long long i) {
+            auto& id = ids[static_cast<size_t>(i) % kActive];
+            queue.erase(id);
+            id = queue.emplace(offsets[static_cast<size_t>(i) & mask], callback);
+        });
+    }
+
+    // Time advancing in 1 s steps over a full set of pending timers; every fired
+    // timer is rescheduled, so the population stays constant.
+    constexpr long long kSteps = 4LL * 3600LL;
+    {
+        TimingWheel wheel(0);
+        size_t next = 0;
+        std::function<void()> rearm;
+        rearm = [&]() {
+            ++fired;
+            wheel.Schedule(wheel.GetNow() + offsets[next++ & mask], rearm);
+        };
+        for (size_t i = 0; i < kActive; ++i) {
+            wheel.Schedule(offsets[next++ & mask], rearm);
+        }
+        fired = 0;
+        Bench::Run("TimingWheel advance 1 s (per step)", kSteps, [&](long long i) {
+            wheel.Advance(static_cast<ULONGLONG>(i + 1) * Clock::TICKS_PER_SEC);
+            ULONGLONG deadline = 0;
+            ULONGLONG tolerance = 0;
+            Bench::DoNotOptimize(wheel.GetNextDeadline(deadline, tolerance));
+        });
+        std::printf("  fired %zu\n", fired);
+    }
+    {
+        std::multimap<ULONGLONG, TimingWheel::Callback> queue;
+        size_t next = 0;
+        for (size_t i = 0; i < kActive; ++i) {
+            queue.emplace(offsets[next++ & mask], callback);
+        }
+        fired = 0;
+        Bench::Run("std::multimap advance 1 s (per step)", kSteps, [&](long long i) {
+            const ULONGLONG now = static_cast<ULONGLONG>(i + 1) * Clock::TICKS_PER_SEC;
+            while (!queue.empty() && queue.begin()->first <= now) {
+                auto node = queue.extract(queue.begin());
+                node.mapped()();
+                queue.emplace(now + offsets[next++ & mask], std::move(node.mapped()));
+            }
+            Bench::DoNotOptimize(queue.begin()->first);
+        });
+        std::printf("  fired %zu\n", fired);
+    }
+    return failures;
+}
@@ -0,0 +1,166 @@
+#include "ActivityMonitor.h"
+#include "Clock.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace Everon {
+
+void ActivityTrigger::Configure(double threshold, ULONGLONG sustain, ULONGLONG smoothing) noexcept {
+    m_threshold = threshold > 0 ? threshold : 0;
+    m_release = m_threshold * RELEASE_RATIO;
+    m_sustain = sustain;
+    m_smoothing = smoothing;
+    m_alphaStep = 0;
+    Reset();
+}
+
+void ActivityTrigger::Reset() noexcept {
+    m_smoothed = 0;
+    m_lastChange = 0;
+    m_last = 0;
+    m_pendingSince = 0;
+    m_hasLast = false;
+    m_pending = false;
+    m_active = false;
+}
+
+bool ActivityTrigger::Update(double value, ULONGLONG now) noexcept {
+    if (!IsEnabled()) {
+        return false;
+    }
+
+    if (!m_hasLast) {
+        m_smoothed = value;
+        m_hasLast = true;
+    } else if (now > m_last) {
+        // The weight depends on the step only, and the sampler's step rarely changes:
+        // exp() runs once per new step, not once per reading.
+        const ULONGLONG step = now - m_last;
+        if (step != m_alphaStep) {
+            m_alpha = m_smoothing ? 1.0 - std::exp(-static_cast<double>(step) / static_cast<double>(m_smoothing)) : 1.0;
+            m_alphaStep = step;
+        }
+        const double change = m_alpha * (value - m_smoothed);
+        m_smoothed += change;
+        m_lastChange = change < 0 ? -change : change;
+    }
+    m_last = now;
+
+    const bool wanted = m_smoothed >= (m_active ? m_release : m_threshold);
+    if (wanted == m_active) {
+        m_pending = false;
+        return false;
+    }
+    if (!m_pending) {
+        m_pending = true;
+        m_pendingSince = now;
+    }
+    if (now - m_pendingSince < m_sustain) {
+        return false;
+    }
+    m_active = wanted;
+    m_pending = false;
+    return true;
+}
+
+SensorTrend ActivityTrigger::GetTrend() const noexcept {
+    if (m_pending || (m_smoothed >= m_release * 0.5 && m_smoothed < m_threshold * 1.5)) {
+        return SensorTrend::NearThreshold;
+    }
+    return (m_lastChange > m_threshold * 0.1) ? SensorTrend::Changing : SensorTrend::Stable;
+}
+
+bool ActivityMonitor::Configure(DWORD cpuPercent, DWORD diskKBps, DWORD networkKBps, ULONGLONG sustain) {
+    const double thresholds[] = { static_cast<double>(cpuPercent), diskKBps * 1024.0, networkKBps * 1024.0 };
+    unsigned kinds = 0;
+    for (size_t i = 0; i < static_cast<size_t>(ActivityKind::Count); ++i) {
+        m_triggers[i].Configure(thresholds[i], sustain, sustain / 2);
+        if (m_triggers[i].IsEnabled()) {
+            kinds |= ActivityReader::Bit(static_cast<ActivityKind>(i));
+        }
+    }
+
+    if (kinds != m_kinds) {
+        m_kinds = 0;
+        for (size_t i = 0; i < static_cast<size_t>(ActivityKind::Count); ++i) {
+            const unsigned bit = ActivityReader::Bit(static_cast<ActivityKind>(i));
+            m_readers[i].Close();
+            if ((kinds & bit) && m_readers[i].Open(bit)) {
+                m_kinds |= bit;
+            }
+        }
+        if (m_kinds != kinds) {
+            Utils::DebugLog(L"[Everon] Some activity triggers unavailable (wanted 0x%x, have 0x%x)\n", kinds, m_kinds);
+        }
+    }
+    return m_kinds == kinds;
+}
+
+void ActivityMonitor::Stop() {
+    for (size_t i = 0; i < static_cast<size_t>(ActivityKind::Count); ++i) {
+        m_readers[i].Close();
+        m_triggers[i].Reset();
+    }
+    m_kinds = 0;
+}
+
+bool ActivityMonitor::Sample(ActivityKind kind, ULONGLONG now) {
+    const size_t index = static_cast<size_t>(kind);
+    ActivitySample sample;
+    if (!IsEnabled(kind) || !m_readers[index].Read(sample)) {
+        return false;
+    }
+    const bool wasActive = IsActive();
+    m_triggers[index].Update(sample[kind], now);
+    return IsActive() != wasActive;
+}
+
+bool ActivityMonitor::IsActive() const noexcept {
+    for (const ActivityTrigger& trigger : m_triggers) {
+        if (trigger.IsActive()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* ActivityMonitor::GetName(ActivityKind kind) noexcept {
+    static const char* const kNames[] = { "cpu", "disk", "network" };
+    return kNames[static_cast<size_t>(kind)];
+}
+
+std::string ActivityMonitor::DescribeActive() const {
+    std::string out;
+    char part[48];
+    for (size_t i = 0; i < static_cast<size_t>(ActivityKind::Count); ++i) {
+        if (!m_triggers[i].IsActive()) {
+            continue;
+        }
+        const double value = m_triggers[i].GetSmoothed();
+        if (static_cast<ActivityKind>(i) == ActivityKind::Cpu) {
+            std::snprintf(part, sizeof(part), "%s %.0f%%", GetName(static_cast<ActivityKind>(i)), value);
+        } else {
+            std::snprintf(part, sizeof(part), "%s %.1f MB/s", GetName(static_cast<ActivityKind>(i)), value / (1024.0 * 1024.0));
+        }
+        if (!out.empty()) {
+            out += ", ";
+        }
+        out += part;
+    }
+    return out;
+}
+
+ULONGLONG ActivityMonitor::GetSamplePeriod(ULONGLONG sustain) noexcept {
+    const ULONGLONG period = sustain / 4;
+    if (period < Clock::TICKS_PER_SEC) {
+        return Clock::TICKS_PER_SEC;
+    }
+    return (std::min)(period, 60 * Clock::TICKS_PER_SEC);
+}
+
+ULONGLONG ActivityMonitor::GetMaxSamplePeriod(ULONGLONG sustain) noexcept {
+    return 4 * GetSamplePeriod(sustain);
+}
+
+} // namespace Everon
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Platform.h"
+#include "SensorSampler.h"
+#include <memory>
+#include <string>
+
+namespace Everon {
+
+// System activity measured by ActivityReader.
+enum class ActivityKind : unsigned char {
+    Cpu,        // busy share of all CPUs, percent
+    Disk,       // bytes read + written on physical disks, per second
+    Network,    // bytes received + sent, loopback excluded, per second
+    Count
+};
+
+struct ActivitySample {
+    double values[static_cast<size_t>(ActivityKind::Count)] = {};
+
+    double& operator[](ActivityKind kind) noexcept { return values[static_cast<size_t>(kind)]; }
+    double operator[](ActivityKind kind) const noexcept { return values[static_cast<size_t>(kind)]; }
+};
+
+// Reads system-wide CPU, disk and network rates, only for the kinds asked for.
+// Linux: /proc/stat, /proc/diskstats and /proc/net/dev, kept open and re-read from
+// offset 0 (no path lookups, no allocations per read). Windows: PDH counters.
+class ActivityReader {
+public:
+    ActivityReader();
+    ~ActivityReader();
+
+    ActivityReader(const ActivityReader&) = delete;
+    ActivityReader& operator=(const ActivityReader&) = delete;
+
+    // `kinds`: bit n set reads ActivityKind n. False if none of them can be read.
+    bool Open(unsigned kinds);
+    void Close();
+    bool IsOpen() const noexcept;
+
+    // Rates since the previous Read(). The first Read() after Open() only takes the
+    // baseline and returns false.
+    bool Read(ActivitySample& sample);
+
+    static constexpr unsigned Bit(ActivityKind kind) noexcept { return 1u << static_cast<unsigned>(kind); }
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+// One threshold on one noisy rate. Readings are smoothed by an EWMA (time constant
+// `smoothing`), and the trigger turns on only after the smoothed value has stayed at or
+// above `threshold` for `sustain`, and off only after it has stayed below
+// threshold * RELEASE_RATIO for `sustain` again: a value hovering near the threshold
+// does not make the keep-awake hold flap.
+class ActivityTrigger {
+public:
+    static constexpr double RELEASE_RATIO = 0.75;
+
+    // threshold 0 disables the trigger. Times in 100 ns ticks.
+    void Configure(double threshold, ULONGLONG sustain, ULONGLONG smoothing) noexcept;
+    void Reset() noexcept;
+
+    bool IsEnabled() const noexcept { return m_threshold > 0; }
+    bool IsActive() const noexcept { return m_active; }
+    double GetThreshold() const noexcept { return m_threshold; }
+    double GetSmoothed() const noexcept { return m_smoothed; }
+
+    // One reading taken at monotonic time `now`. True if IsActive() changed.
+    bool Update(double value, ULONGLONG now) noexcept;
+
+    // How soon the next reading matters: near the threshold (or a switch pending),
+    // moving by more than a tenth of the threshold per reading, or neither.
+    SensorTrend GetTrend() const noexcept;
+
+private:
+    double m_threshold = 0;
+    double m_release = 0;
+    ULONGLONG m_sustain = 0;
+    ULONGLONG m_smoothing = 0;
+
+    double m_smoothed = 0;
+    double m_lastChange = 0;        // |smoothed change| at the latest reading
+    double m_alpha = 0;             // EWMA weight for m_alphaStep; recomputed when the step changes
+    ULONGLONG m_alphaStep = 0;
+    ULONGLONG m_last = 0;           // time of the previous reading
+    ULONGLONG m_pendingSince = 0;   // the opposite state has been wanted since
+    bool m_hasLast = false;
+    bool m_pending = false;
+    bool m_active = false;
+};
+
+// The CPU, disk and network triggers, each with its own reader so each can be sampled
+// at its own pace (SensorSampler): "awake while the download is going" without a manual
+// toggle.
+class ActivityMonitor {
+public:
+    // Thresholds of 0 disable that trigger: CPU in percent, disk and network in KB/s.
+    // Reopens the readers of the enabled kinds only.
+    bool Configure(DWORD cpuPercent, DWORD diskKBps, DWORD networkKBps, ULONGLONG sustain);
+    void Stop();
+    bool IsEnabled() const noexcept { return m_kinds != 0; }
+    bool IsEnabled(ActivityKind kind) const noexcept { return (m_kinds & ActivityReader::Bit(kind)) != 0; }
+
+    // Reads one kind and feeds its trigger. True if IsActive() changed.
+    bool Sample(ActivityKind kind, ULONGLONG now);
+
+    bool IsActive() const noexcept;
+    const ActivityTrigger& GetTrigger(ActivityKind kind) const noexcept {
+        return m_triggers[static_cast<size_t>(kind)];
+    }
+    // "cpu 73%, network 2.1 MB/s", the active triggers, for the log.
+    std::string DescribeActive() const;
+    static const char* GetName(ActivityKind kind) noexcept;
+
+    // Sampling bounds for a sustain window: a handful of readings per window while a
+    // trigger is near its threshold, backing off to about one per window while quiet.
+    static ULONGLONG GetSamplePeriod(ULONGLONG sustain) noexcept;
+    static ULONGLONG GetMaxSamplePeriod(ULONGLONG sustain) noexcept;
+
+private:
+    ActivityReader m_readers[static_cast<size_t>(ActivityKind::Count)];
+    ActivityTrigger m_triggers[static_cast<size_t>(ActivityKind::Count)];
+    unsigned m_kinds = 0;
+};
+
+} // namespace Everon
@@ -0,0 +1,277 @@
+#include "ActivityMonitor.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace Everon {
+
+namespace {
+
+// Devices seen in a statistics file, classified once by their sysfs entry: only
+// physical devices count (no partitions, loop devices, bridges or tunnels, whose
+// traffic is already counted on the device below them). Where none is physical (a
+// container's veth), the virtual ones count instead.
+enum class DeviceClass : BYTE { Excluded, Virtual, Physical };
+
+class DeviceClassifier {
+public:
+    explicit DeviceClassifier(const char* sysfsDir) : m_sysfsDir(sysfsDir) {}
+
+    DeviceClass Classify(const char* name, size_t length) {
+        for (const auto& entry : m_cache) {
+            if (entry.first.size() == length && entry.first.compare(0, length, name, length) == 0) {
+                return entry.second;
+            }
+        }
+        const std::string device(name, length);
+        DeviceClass result = DeviceClass::Excluded;
+        const std::string base = m_sysfsDir + device;
+        if (device != "lo" && access(base.c_str(), F_OK) == 0) {
+            result = (access((base + "/device").c_str(), F_OK) == 0) ? DeviceClass::Physical : DeviceClass::Virtual;
+        }
+        m_cache.emplace_back(device, result);
+        return result;
+    }
+
+private:
+    std::string m_sysfsDir;
+    std::vector<std::pair<std::string, DeviceClass>> m_cache;
+};
+
+bool IsSpace(char c) noexcept {
+    return c == ' ' || c == '\t';
+}
+
+// Unsigned decimal at `p`, after any blanks; `p` ends past it.
+ULONGLONG ParseNumber(const char*& p, const char* end) noexcept {
+    while (p < end && IsSpace(*p)) {
+        ++p;
+    }
+    ULONGLONG value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<ULONGLONG>(*p - '0');
+        ++p;
+    }
+    return value;
+}
+
+void SkipNumbers(const char*& p, const char* end, int count) noexcept {
+    for (int i = 0; i < count; ++i) {
+        ParseNumber(p, end);
+    }
+}
+
+const char* NextLine(const char* p, const char* end) noexcept {
+    while (p < end && *p != '\n') {
+        ++p;
+    }
+    return p < end ? p + 1 : end;
+}
+
+} // namespace
+
+struct ActivityReader::Impl {
+    int statFd = -1;
+    int diskFd = -1;
+    int netFd = -1;
+    std::vector<char> buffer;
+    DeviceClassifier disks{ "/sys/block/" };
+    DeviceClassifier interfaces{ "/sys/class/net/" };
+
+    bool primed = false;
+    ULONGLONG lastTime = 0;
+    ULONGLONG cpuBusy = 0;
+    ULONGLONG cpuTotal = 0;
+    ULONGLONG diskBytes = 0;
+    ULONGLONG netBytes = 0;
+
+    ~Impl() {
+        for (int fd : { statFd, diskFd, netFd }) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    // Whole file from offset 0 into `buffer` (grown until it fits); false on error.
+    bool ReadFile(int fd, const char*& begin, const char*& end) {
+        for (;;) {
+            const ssize_t got = pread(fd, buffer.data(), buffer.size(), 0);
+            if (got < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if (static_cast<size_t>(got) < buffer.size()) {
+                begin = buffer.data();
+                end = begin + got;
+                return true;
+            }
+            buffer.resize(buffer.size() * 2);
+        }
+    }
+
+    // "cpu  user nice system idle iowait irq softirq steal ...": the first line only.
+    bool ReadCpu(ULONGLONG& busy, ULONGLONG& total) {
+        char line[256];
+        ssize_t got;
+        do {
+            got = pread(statFd, line, sizeof(line), 0);
+        } while (got < 0 && errno == EINTR);
+        if (got < 5 || line[0] != 'c' || line[1] != 'p' || line[2] != 'u') {
+            return false;
+        }
+        const char* p = line + 3;
+        const char* end = line + got;
+        ULONGLONG fields[8] = {};
+        for (ULONGLONG& field : fields) {
+            field = ParseNumber(p, end);
+        }
+        const ULONGLONG idle = fields[3] + fields[4];
+        busy = fields[0] + fields[1] + fields[2] + fields[5] + fields[6] + fields[7];
+        total = busy + idle;
+        return true;
+    }
+
+    // "major minor name reads merged sectors ms writes merged sectors ...", 512-byte sectors.
+    bool ReadDisks(ULONGLONG& bytes) {
+        const char* p = nullptr;
+        const char* end = nullptr;
+        if (!ReadFile(diskFd, p, end)) {
+            return false;
+        }
+        ULONGLONG sectors[2] = {};   // virtual, physical
+        while (p < end) {
+            const char* line = p;
+            SkipNumbers(line, end, 2);
+            while (line < end && IsSpace(*line)) {
+                ++line;
+            }
+            const char* name = line;
+            while (line < end && !IsSpace(*line) && *line != '\n') {
+                ++line;
+            }
+            const DeviceClass type = disks.Classify(name, static_cast<size_t>(line - name));
+            if (type != DeviceClass::Excluded) {
+                SkipNumbers(line, end, 2);
+                ULONGLONG count = ParseNumber(line, end);
+                SkipNumbers(line, end, 3);
+                count += ParseNumber(line, end);
+                sectors[type == DeviceClass::Physical] += count;
+            }
+            p = NextLine(line, end);
+        }
+        bytes = (sectors[1] ? sectors[1] : sectors[0]) * 512;
+        return true;
+    }
+
+    // Two header lines, then "name: rxbytes 7 more fields txbytes ...".
+    bool ReadNetwork(ULONGLONG& bytes) {
+        const char* p = nullptr;
+        const char* end = nullptr;
+        if (!ReadFile(netFd, p, end)) {
+            return false;
+        }
+        p = NextLine(NextLine(p, end), end);
+        ULONGLONG counted[2] = {};   // virtual, physical
+        while (p < end) {
+            const char* line = p;
+            while (line < end && IsSpace(*line)) {
+                ++line;
+            }
+            const char* name = line;
+            while (line < end && *line != ':' && *line != '\n') {
+                ++line;
+            }
+            if (line < end && *line == ':') {
+                const DeviceClass type = interfaces.Classify(name, static_cast<size_t>(line - name));
+                if (type != DeviceClass::Excluded) {
+                    ++line;
+                    ULONGLONG count = ParseNumber(line, end);
+                    SkipNumbers(line, end, 7);
+                    count += ParseNumber(line, end);
+                    counted[type == DeviceClass::Physical] += count;
+                }
+            }
+            p = NextLine(line, end);
+        }
+        bytes = counted[1] ? counted[1] : counted[0];
+        return true;
+    }
+};
+
+ActivityReader::ActivityReader() = default;
+
+ActivityReader::~ActivityReader() = default;
+
+bool ActivityReader::Open(unsigned kinds) {
+    Close();
+    auto impl = std::make_unique<Impl>();
+    if (kinds & Bit(ActivityKind::Cpu)) {
+        impl->statFd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    }
+    if (kinds & Bit(ActivityKind::Disk)) {
+        impl->diskFd = open("/proc/diskstats", O_RDONLY | O_CLOEXEC);
+    }
+    if (kinds & Bit(ActivityKind::Network)) {
+        impl->netFd = open("/proc/net/dev", O_RDONLY | O_CLOEXEC);
+    }
+    if (impl->statFd < 0 && impl->diskFd < 0 && impl->netFd < 0) {
+        Utils::DebugLog(L"[Everon] Activity: /proc statistics unreadable (errno %d)\n", errno);
+        return false;
+    }
+    impl->buffer.resize(4096);
+    m_impl = std::move(impl);
+    return true;
+}
+
+void ActivityReader::Close() {
+    m_impl.reset();
+}
+
+bool ActivityReader::IsOpen() const noexcept {
+    return m_impl != nullptr;
+}
+
+bool ActivityReader::Read(ActivitySample& sample) {
+    if (!m_impl) {
+        return false;
+    }
+    Impl& impl = *m_impl;
+    const ULONGLONG now = Platform::GetMonotonicTicks();
+
+    ULONGLONG busy = impl.cpuBusy;
+    ULONGLONG total = impl.cpuTotal;
+    ULONGLONG diskBytes = impl.diskBytes;
+    ULONGLONG netBytes = impl.netBytes;
+    if ((impl.statFd >= 0 && !impl.ReadCpu(busy, total)) ||
+        (impl.diskFd >= 0 && !impl.ReadDisks(diskBytes)) ||
+        (impl.netFd >= 0 && !impl.ReadNetwork(netBytes))) {
+        return false;
+    }
+
+    const bool primed = impl.primed && now > impl.lastTime;
+    if (primed) {
+        const double seconds = static_cast<double>(now - impl.lastTime) / 1e7;
+        // Counters can step back (a device or interface went away): read as no activity.
+        sample[ActivityKind::Cpu] = (total > impl.cpuTotal && busy >= impl.cpuBusy)
+            ? 100.0 * static_cast<double>(busy - impl.cpuBusy) / static_cast<double>(total - impl.cpuTotal) : 0.0;
+        sample[ActivityKind::Disk] = diskBytes >= impl.diskBytes
+            ? static_cast<double>(diskBytes - impl.diskBytes) / seconds : 0.0;
+        sample[ActivityKind::Network] = netBytes >= impl.netBytes
+            ? static_cast<double>(netBytes - impl.netBytes) / seconds : 0.0;
+    }
+    impl.primed = true;
+    impl.lastTime = now;
+    impl.cpuBusy = busy;
+    impl.cpuTotal = total;
+    impl.diskBytes = diskBytes;
+    impl.netBytes = netBytes;
+    return primed;
+}
+
+} // namespace Everon
@@ -0,0 +1,121 @@
+#include "ActivityMonitor.h"
+#include <pdh.h>
+#include <pdhmsg.h>
+#include <vector>
+
+namespace Everon {
+
+namespace {
+
+// English paths, so the query works on every UI language. Instance wildcards are summed.
+const wchar_t* const kCounterPaths[] = {
+    L"\\Processor(_Total)\\% Processor Time",
+    L"\\PhysicalDisk(_Total)\\Disk Bytes/sec",
+    L"\\Network Interface(*)\\Bytes Total/sec",
+};
+
+} // namespace
+
+struct ActivityReader::Impl {
+    PDH_HQUERY query = nullptr;
+    PDH_HCOUNTER counters[static_cast<size_t>(ActivityKind::Count)] = {};
+    std::vector<BYTE> buffer;   // PdhGetFormattedCounterArrayW output, reused
+    bool primed = false;
+
+    ~Impl() {
+        if (query) {
+            PdhCloseQuery(query);
+        }
+    }
+
+    // Sum over all instances (a single instance for the _Total counters).
+    bool ReadCounter(PDH_HCOUNTER counter, double& value) {
+        for (;;) {
+            DWORD size = static_cast<DWORD>(buffer.size());
+            DWORD count = 0;
+            auto* items = reinterpret_cast<PDH_FMT_COUNTERVALUE_ITEM_W*>(buffer.data());
+            const PDH_STATUS status = PdhGetFormattedCounterArrayW(counter, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100,
+                                                                   &size, &count, size ? items : nullptr);
+            if (status == PDH_MORE_DATA) {
+                buffer.resize(size);
+                continue;
+            }
+            if (status != ERROR_SUCCESS) {
+                return false;
+            }
+            value = 0;
+            for (DWORD i = 0; i < count; ++i) {
+                if (items[i].FmtValue.CStatus == PDH_CSTATUS_VALID_DATA ||
+                    items[i].FmtValue.CStatus == PDH_CSTATUS_NEW_DATA) {
+                    value += items[i].FmtValue.doubleValue;
+                }
+            }
+            return true;
+        }
+    }
+};
+
+ActivityReader::ActivityReader() = default;
+
+ActivityReader::~ActivityReader() = default;
+
+bool ActivityReader::Open(unsigned kinds) {
+    Close();
+    auto impl = std::make_unique<Impl>();
+    PDH_STATUS status = PdhOpenQueryW(nullptr, 0, &impl->query);
+    if (status != ERROR_SUCCESS) {
+        Utils::DebugLog(L"[Everon] Activity: PdhOpenQuery failed (0x%08lX)\n", static_cast<unsigned long>(status));
+        return false;
+    }
+    bool any = false;
+    for (size_t i = 0; i < static_cast<size_t>(ActivityKind::Count); ++i) {
+        if (!(kinds & Bit(static_cast<ActivityKind>(i)))) {
+            continue;
+        }
+        status = PdhAddEnglishCounterW(impl->query, kCounterPaths[i], 0, &impl->counters[i]);
+        if (status != ERROR_SUCCESS) {
+            Utils::DebugLog(L"[Everon] Activity: counter %ls unavailable (0x%08lX)\n", kCounterPaths[i],
+                            static_cast<unsigned long>(status));
+            impl->counters[i] = nullptr;
+            continue;
+        }
+        any = true;
+    }
+    if (!any) {
+        return false;
+    }
+    impl->buffer.resize(4096);
+    m_impl = std::move(impl);
+    return true;
+}
+
+void ActivityReader::Close() {
+    m_impl.reset();
+}
+
+bool ActivityReader::IsOpen() const noexcept {
+    return m_impl != nullptr;
+}
+
+bool ActivityReader::Read(ActivitySample& sample) {
+    if (!m_impl) {
+        return false;
+    }
+    Impl& impl = *m_impl;
+    // Rate counters need two collections: PDH keeps the previous raw values itself.
+    if (PdhCollectQueryData(impl.query) != ERROR_SUCCESS) {
+        return false;
+    }
+    if (!impl.primed) {
+        impl.primed = true;
+        return false;
+    }
+    for (size_t i = 0; i < static_cast<size_t>(ActivityKind::Count); ++i) {
+        if (impl.counters[i] && !impl.ReadCounter(impl.counters[i], sample.values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Everon
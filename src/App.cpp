@@ -5,15 +5,30 @@
 #include "Utils.h"
 #include "Localization.h"
 #include "TimerMode.h"
+#include "TimeZone.h"
+#include "PhaseSpread.h"
+#include "IdleTimeout.h"
 #include "resource.h"
 #include <commctrl.h>
+#include <wtsapi32.h>
+#include <algorithm>
 
 #pragma comment(lib, "comctl32.lib")
 
 namespace Everon {
 
-App::App(HINSTANCE instance)
+App::App(HINSTANCE instance, const Clock& clock)
     : m_instance(instance)
+    , m_clock(clock)
+    , m_awake([this](AwakeArbiter::State state) {
+          if (state == AwakeArbiter::State::Sleep) {
+              m_powerManager.AllowSleep();
+              return true;
+          }
+          return m_powerManager.PreventSleep(state == AwakeArbiter::State::Display);
+      })
+    , m_wheel(clock.NowMonotonic())
+    , m_processWatcher(m_watchList)
     , m_settingsDialog(std::make_unique<SettingsDialog>(instance)) {
 }
 
@@ -45,23 +60,84 @@ bool App::SaveSettings() {
 }
 
 void App::ArmExpireTimer(const TimerConfig& timer) {
-    const DWORD remainingMs = timer.GetRemainingMilliseconds();
-    if (remainingMs == 0) {
-        OnTimer(TIMER_ID_EXPIRE);
+    m_wheel.Cancel(m_expireId);
+
+    const DWORD remainingMs = timer.GetRemainingMilliseconds(m_clock);
+    ClockBase base = ClockBase::Wall;
+    ULONGLONG deadline = 0;
+    if (remainingMs == 0 || !timer.GetDeadline(m_clock, base, deadline)) {
+        OnExpireTimer();
+        return;
+    }
+
+    // The wheel runs on monotonic time: a wall deadline is mapped across now and
+    // mapped again by OnClockChanged() whenever the wall clock moves.
+    const ULONGLONG now = m_clock.NowMonotonic();
+    if (base == ClockBase::Wall) {
+        const ULONGLONG nowUtc = m_clock.NowUtc();
+        deadline = now + ((deadline > nowUtc) ? deadline - nowUtc : 0);
+    }
+
+    const ULONGLONG tolerance = Efficiency::ExpiryTolerance(static_cast<ULONGLONG>(remainingMs) * Clock::TICKS_PER_MS);
+    m_expireId = m_wheel.Schedule(deadline, [this]() { OnExpireTimer(); }, tolerance);
+    ArmWheelTimer();
+}
+
+void App::ArmWheelTimer() {
+    if (m_inWheelAdvance) {
         return;
     }
 
-    static constexpr DWORD kWinTimerMaxMs = 0x7FFFFFFFUL;
-    static constexpr UINT kLongRearmChunkMs = 10U * 60U * 1000U; // 10 minutes
+    KillTimer(m_window, TIMER_ID_WHEEL);
+    ULONGLONG deadline = 0;
+    ULONGLONG tolerance = 0;
+    if (!m_wheel.GetNextDeadline(deadline, tolerance)) {
+        m_wheelTimer.Cancel();
+        return;
+    }
+    if (!m_settings.GetEfficiencyMode()) {
+        tolerance = 0;
+    }
 
-    UINT intervalMs = static_cast<UINT>(remainingMs);
-    if (remainingMs > kWinTimerMaxMs) {
-        // Defensive path for corrupted/legacy settings far in the future.
-        // Re-arm in chunks instead of passing an out-of-range value to SetTimer.
-        intervalMs = kLongRearmChunkMs;
+    // One absolute deadline for all logical timers: the process wakes once per due entry.
+    if (m_wheelTimer.Arm(ClockBase::Monotonic, deadline, tolerance) && WatchWheelTimer()) {
+        return;
     }
 
-    Utils::SetTimerChecked(m_window, TIMER_ID_EXPIRE, intervalMs ? intervalMs : 1U);
+    // Fallback: relative window timer, re-armed at least every 10 minutes.
+    static constexpr ULONGLONG kFallbackRearmMs = 10ULL * 60ULL * 1000ULL;
+    const ULONGLONG now = m_clock.NowMonotonic();
+    const ULONGLONG remainingMs = (deadline > now) ? (deadline - now + Clock::TICKS_PER_MS - 1) / Clock::TICKS_PER_MS : 1;
+    Utils::SetTimerChecked(m_window, TIMER_ID_WHEEL, static_cast<UINT>((std::min)(remainingMs, kFallbackRearmMs)),
+                           static_cast<ULONG>(tolerance / Clock::TICKS_PER_MS));
+}
+
+bool App::WatchWheelTimer() {
+    // The signal becomes a posted message: the message loops of the settings dialog,
+    // message boxes and the tray menu dispatch it like the main loop does.
+    if (m_wheelWait) {
+        return true;
+    }
+    return Utils::CheckWinApiBool(
+        RegisterWaitForSingleObject(&m_wheelWait, m_wheelTimer.GetHandle(), OnWheelTimerSignaled, this, INFINITE,
+                                    WT_EXECUTEINWAITTHREAD),
+        L"RegisterWaitForSingleObject(wheel timer)");
+}
+
+VOID CALLBACK App::OnWheelTimerSignaled(PVOID context, BOOLEAN /*timedOut*/) {
+    // Satisfying the wait has reset the (auto-reset) timer.
+    const App* app = static_cast<const App*>(context);
+    PostMessageW(app->m_window, WM_WHEEL_TIMER, 0, 0);
+}
+
+void App::OnWheelTimer() {
+    m_wakeups.Record(m_clock.NowMonotonic());
+
+    m_inWheelAdvance = true;
+    m_wheel.Advance(m_clock.NowMonotonic());
+    m_inWheelAdvance = false;
+
+    ArmWheelTimer();
 }
 
 int App::Run() {
@@ -97,6 +173,7 @@ int App::Run() {
 
     ShowWindow(m_window, SW_HIDE);
 
+    // The timing wheel's deadline timer arrives as WM_WHEEL_TIMER (see WatchWheelTimer).
     MSG message = {};
     int gm = 0;
     while ((gm = GetMessageW(&message, nullptr, 0, 0)) > 0) {
@@ -150,6 +227,49 @@ LRESULT CALLBACK App::WindowProc(HWND window, UINT message,
         case WM_SHOW_SETTINGS:
             app->ShowSettings();
             return 0;
+        case WM_PROCESS_EVENT:
+            app->OnProcessEvent();
+            return 0;
+        case WM_FILE_EVENT:
+            app->OnFileEvent();
+            return 0;
+        case WM_WHEEL_TIMER:
+            // A re-arm after the signal leaves the timer armed: the wheel then finds
+            // nothing due and arms it again.
+            if (app->m_wheelTimer.Consume()) {
+                app->OnWheelTimer();
+            }
+            return 0;
+        case WM_TIMECHANGE:
+            // System time or time zone changed: drop the cached zone tables.
+            TimeZone::InvalidateCurrent();
+            app->OnClockChanged();
+            return 0;
+        case WM_POWERBROADCAST:
+            if (wParam == PBT_APMRESUMEAUTOMATIC || wParam == PBT_APMRESUMESUSPEND) {
+                app->OnClockChanged();
+            } else if (wParam == PBT_APMPOWERSTATUSCHANGE) {
+                app->OnPowerSupplyChanged();
+            } else if (wParam == PBT_POWERSETTINGCHANGE) {
+                // Display/sleep timeout, power source or battery charge changed.
+                const auto* setting = reinterpret_cast<const POWERBROADCAST_SETTING*>(lParam);
+                if (setting && (IsEqualGUID(setting->PowerSetting, GUID_ACDC_POWER_SOURCE) ||
+                                IsEqualGUID(setting->PowerSetting, GUID_BATTERY_PERCENTAGE_REMAINING))) {
+                    app->OnPowerSupplyChanged();
+                }
+                if (!setting || !IsEqualGUID(setting->PowerSetting, GUID_BATTERY_PERCENTAGE_REMAINING)) {
+                    app->RefreshIdleTimeout();
+                }
+            }
+            return TRUE;
+        case WM_WTSSESSION_CHANGE:
+            app->OnSessionChanged(wParam);
+            return 0;
+        case WM_SETTINGCHANGE:
+            if (wParam == SPI_SETSCREENSAVETIMEOUT || wParam == SPI_SETSCREENSAVEACTIVE) {
+                app->RefreshIdleTimeout();
+            }
+            break;
         case WM_DESTROY:
             app->OnDestroy();
             return 0;
@@ -160,6 +280,9 @@ LRESULT CALLBACK App::WindowProc(HWND window, UINT message,
 
 void App::OnCreate() {
     m_settings.LoadFromRegistry();
+    m_sessionHash = PhaseSpread::HashIdentity(Platform::GetSessionIdentity());
+    m_powerManager.Initialize();
+    ApplyEfficiencyMode();
 
     m_trayIcon = std::make_unique<TrayIcon>(m_window, m_instance);
     m_trayIcon->SetToggleCallback([this]() { ToggleEnabled(); });
@@ -180,70 +303,203 @@ void App::OnCreate() {
         return;
     }
 
-    m_trayIcon->UpdateTooltip(m_settings);
     m_trayIcon->SetEnabled(m_settings.IsEnabled());
 
     m_hotkeyManager = std::make_unique<HotkeyManager>(m_window);
     RegisterHotkey();
+    RegisterPowerSettingNotifications();
+    PowerSupply::Query(m_powerSupply);
+    m_sessionNotify = Utils::CheckWinApiBool(WTSRegisterSessionNotification(m_window, NOTIFY_FOR_THIS_SESSION),
+                                             L"WTSRegisterSessionNotification");
+    StartProcessWatch();
+    StartActivityMonitor();
+    StartFileWatch();
 
     if (m_settings.IsEnabled()) {
         UpdatePowerState();
         StartTimer();
     }
+    UpdateTooltip();
+}
+
+void App::ApplyEfficiencyMode() {
+    // Efficiency mode and the wakeup budget are registry (policy) settings, read at start-up.
+    m_wakeups.SetBudgetPerHour(m_settings.GetWakeupBudgetPerHour());
+    if (m_settings.GetEfficiencyMode()) {
+        Platform::SetEfficiencyMode(true, Efficiency::TIMER_SLACK_TICKS);
+    }
 }
 
 void App::OnDestroy() {
     StopTimer();
-    m_powerManager.AllowSleep();
+    UnregisterPowerSettingNotifications();
+    if (m_sessionNotify) {
+        WTSUnRegisterSessionNotification(m_window);
+        m_sessionNotify = false;
+    }
+    m_processWatcher.Stop();
+    LogSensorStatistics();
+    m_wheel.Cancel(m_samplerId);
+    m_activity.Stop();
+    m_fileWatcher.Stop();
+    m_awake.ReleaseAll();
     m_hotkeyManager.reset();
     m_trayIcon.reset();
+    m_wheelTimer.Cancel();
+    if (m_wheelWait) {
+        // Waits for a running callback, so none posts to the window after this.
+        UnregisterWaitEx(m_wheelWait, INVALID_HANDLE_VALUE);
+        m_wheelWait = nullptr;
+    }
     m_window = nullptr;
     PostQuitMessage(0);
 }
 
 void App::OnTimer(UINT_PTR timerId) {
-    if (!m_settings.IsEnabled()) {
+    if (timerId == TIMER_ID_WHEEL) {
+        KillTimer(m_window, TIMER_ID_WHEEL);
+        OnWheelTimer();
+    }
+}
+
+void App::OnKeypressTimer() {
+    if (!m_settings.IsEnabled() || !m_keypressScheduler.IsRunning()) {
         return;
     }
 
-    if (timerId == TIMER_ID_KEYPRESS) {
-        // Periodic key press (optional)
-        const WORD vk = m_settings.GetVirtualKey();
-        if (vk != 0) {
-            m_powerManager.SendKeyPress(vk);
+    // Periodic key press (optional), on the absolute monotonic grid.
+    const ULONGLONG now = m_clock.NowMonotonic();
+    const unsigned due = m_keypressScheduler.OnWake(now);
+    const WORD vk = m_settings.GetVirtualKey();
+    if (due != 0 && vk != 0 && GetBatteryAction() != BatteryAction::Suspend) {
+        const ULONGLONG period = m_keypressScheduler.GetPeriod();
+        // The adaptive period may be shorter than the configured one the setting was clamped to.
+        const ULONGLONG threshold = m_settings.GetIdleThresholdSec()
+            ? (std::min)(m_settings.GetIdleThresholdSec() * Clock::TICKS_PER_SEC, period)
+            : IdleMonitor::DefaultThreshold(period);
+
+        ULONGLONG lastInput = 0;
+        if (m_idleMonitor.ShouldInject(now, threshold, lastInput)) {
+            for (unsigned i = 0; i < due; ++i) {
+                m_powerManager.SendKeyPress(vk);
+            }
+        } else {
+            // The user is active and has already reset the OS idle timer: count from there.
+            // Never into the past, which would fire again straight away.
+            m_keypressScheduler.Defer((std::max)(now + Clock::TICKS_PER_SEC, lastInput + period));
         }
+    }
+
+    static constexpr ULONGLONG kStatsLogEvery = 60;
+    if (due != 0 && m_keypressScheduler.GetFiredCount() % kStatsLogEvery == 0) {
+        LogKeypressStatistics();
+    }
+
+    ArmKeypressTimer();
+}
+
+void App::ArmKeypressTimer() {
+    // Nobody sees input sent to a locked or disconnected session; resumed by OnSessionChanged.
+    m_wheel.Cancel(m_keypressId);
+    if (m_session.IsIdle()) {
+        ArmWheelTimer();
         return;
     }
 
-    if (timerId == TIMER_ID_EXPIRE) {
-        // One-shot: stop this timer immediately
-        KillTimer(m_window, TIMER_ID_EXPIRE);
+    const ULONGLONG now = m_clock.NowMonotonic();
 
-        const TimerConfig timer = m_settings.GetTimerConfig();
-        if (timer.IsExpired()) {
-            // Timer expired - disable
-            m_settings.SetEnabled(false);
+    // Over the wakeup budget: hold the (discretionary) keypress back until a wakeup
+    // leaves the window. The scheduler counts the late grid points as skipped.
+    const ULONGLONG next = (std::max)(m_keypressScheduler.GetNextDeadline(), m_wakeups.GetNextAllowed(now));
+    const ULONGLONG tolerance = Efficiency::KeypressTolerance(m_keypressScheduler.GetPeriod());
+    m_keypressId = m_wheel.Schedule(next, [this]() { OnKeypressTimer(); }, tolerance);
+    ArmWheelTimer();
+}
 
-            TimerConfig cleared = timer;
-            cleared.endTimeUtc = 0;
-            cleared.startTime = {};
-            m_settings.SetTimerConfig(cleared);
+void App::OnTooltipTimer() {
+    UpdateTooltip();
+    ArmTooltipTimer();
+}
 
-            SaveSettings();
-            StopTimer();
-            m_powerManager.AllowSleep();
-            m_trayIcon->UpdateTooltip(m_settings);
-            m_trayIcon->SetEnabled(false);
+void App::ArmTooltipTimer() {
+    m_wheel.Cancel(m_tooltipId);
 
-            auto& loc = Localization::Instance();
-            m_trayIcon->ShowNotification(loc.GetString(StringID::ErrorTitle),
-                                        loc.GetString(StringID::NotifyTimerExpired), NIIF_INFO);
-        } else {
-            // Re-arm to handle clock adjustments and boundary races robustly.
-            ArmExpireTimer(timer);
-        }
+    // Only a running Duration shows a countdown; refresh it as the remaining whole minute changes.
+    const TimerConfig timer = m_settings.GetTimerConfig();
+    if (!m_settings.IsEnabled() || m_session.IsIdle() || timer.mode != TimerMode::Duration ||
+        timer.endTimeMonotonic == 0) {
+        ArmWheelTimer();
+        return;
+    }
+
+    const ULONGLONG now = m_clock.NowMonotonic();
+    if (timer.endTimeMonotonic <= now) {
+        ArmWheelTimer();
+        return;
+    }
+
+    ULONGLONG untilBoundary = (timer.endTimeMonotonic - now) % Clock::TICKS_PER_MIN;
+    if (untilBoundary == 0) {
+        untilBoundary = Clock::TICKS_PER_MIN;
+    }
+    static constexpr ULONGLONG kTooltipTolerance = 5ULL * Clock::TICKS_PER_SEC;
+    m_tooltipId = m_wheel.Schedule(now + untilBoundary, [this]() { OnTooltipTimer(); }, kTooltipTolerance);
+    ArmWheelTimer();
+}
+
+void App::LogKeypressStatistics() const {
+    if (m_keypressScheduler.GetFiredCount() == 0) {
+        return;
+    }
+    Utils::DebugLog(L"[Everon] Keypress lateness %ls, max interval %llums, skipped %llu\n",
+                    m_keypressScheduler.GetLateness().Format().c_str(),
+                    static_cast<unsigned long long>(m_keypressScheduler.GetMaxInterval() / Clock::TICKS_PER_MS),
+                    static_cast<unsigned long long>(m_keypressScheduler.GetSkippedCount()));
+    Utils::DebugLog(L"[Everon] Wakeups: %lu in the last hour (budget %lu), %llu total\n",
+                    static_cast<unsigned long>(m_wakeups.GetLastHour(m_clock.NowMonotonic())),
+                    static_cast<unsigned long>(m_wakeups.GetBudgetPerHour()),
+                    static_cast<unsigned long long>(m_wakeups.GetTotal()));
+    Utils::DebugLog(L"[Everon] Keypresses injected %llu, avoided (user active) %llu\n",
+                    static_cast<unsigned long long>(m_idleMonitor.GetInjectedCount()),
+                    static_cast<unsigned long long>(m_idleMonitor.GetAvoidedCount()));
+    m_powerManager.LogStatistics();
+    Utils::DebugLog(L"[Everon] Awake arbiter: %llu requests, %llu OS transitions\n",
+                    static_cast<unsigned long long>(m_awake.GetRequestCount()),
+                    static_cast<unsigned long long>(m_awake.GetTransitionCount()));
+}
+
+void App::OnExpireTimer() {
+    // One-shot: drop the entry in case we were called directly rather than by the wheel.
+    m_wheel.Cancel(m_expireId);
+
+    if (!m_settings.IsEnabled()) {
         return;
     }
+
+    const TimerConfig timer = m_settings.GetTimerConfig();
+    if (timer.IsExpired(m_clock)) {
+        // Timer expired - disable
+        m_settings.SetEnabled(false);
+
+        TimerConfig cleared = timer;
+        cleared.endTimeUtc = 0;
+        cleared.endTimeMonotonic = 0;
+        cleared.startTime = {};
+        m_settings.SetTimerConfig(cleared);
+
+        SaveSettings();
+        StopTimer();
+        UpdatePowerState();
+        UpdateTooltip();
+        m_trayIcon->SetEnabled(false);
+
+        auto& loc = Localization::Instance();
+        m_trayIcon->ShowNotification(loc.GetString(StringID::ErrorTitle),
+                                    loc.GetString(StringID::NotifyTimerExpired), NIIF_INFO);
+    } else {
+        // Woken early (clock adjustment, boundary race): arm again for the remainder.
+        ArmExpireTimer(timer);
+    }
 }
 
 
@@ -267,10 +523,11 @@ void App::ToggleEnabled() {
         // Initialize timer runtime state on enable
         TimerConfig timer = m_settings.GetTimerConfig();
         if (timer.mode != TimerMode::Indefinite) {
-            timer.ResetStartTime();
+            timer.ResetStartTime(m_clock);
         } else {
             timer.startTime = {};
             timer.endTimeUtc = 0;
+            timer.endTimeMonotonic = 0;
         }
         m_settings.SetTimerConfig(timer);
 
@@ -278,18 +535,19 @@ void App::ToggleEnabled() {
         StartTimer();
     } else {
         StopTimer();
-        m_powerManager.AllowSleep();
+        UpdatePowerState();
 
         // Clear runtime state to avoid stale expirations
         TimerConfig timer = m_settings.GetTimerConfig();
         timer.startTime = {};
         timer.endTimeUtc = 0;
+        timer.endTimeMonotonic = 0;
         m_settings.SetTimerConfig(timer);
     }
 
     SaveSettings();
     if (m_trayIcon) {
-        m_trayIcon->UpdateTooltip(m_settings);
+        UpdateTooltip();
         m_trayIcon->SetEnabled(m_settings.IsEnabled());
 
         if (m_settings.GetShowToggleNotifications()) {
@@ -318,7 +576,7 @@ void App::ShowSettings() {
         if (m_settings.IsEnabled()) {
             TimerConfig timer = m_settings.GetTimerConfig();
             if (timer.mode != TimerMode::Indefinite && timer.endTimeUtc == 0) {
-                timer.ResetStartTime();
+                timer.ResetStartTime(m_clock);
                 m_settings.SetTimerConfig(timer);
                 SaveSettings();
             }
@@ -328,7 +586,7 @@ void App::ShowSettings() {
         }
 
         if (m_trayIcon) {
-            m_trayIcon->UpdateTooltip(m_settings);
+            UpdateTooltip();
             m_trayIcon->SetEnabled(m_settings.IsEnabled());
         }
         RegisterHotkey();
@@ -363,7 +621,7 @@ void App::OnTaskbarCreated() {
 
     if (m_trayIcon->ReAdd()) {
         m_trayIcon->SetEnabled(m_settings.IsEnabled());
-        m_trayIcon->UpdateTooltip(m_settings);
+        UpdateTooltip();
     }
 }
 
@@ -375,20 +633,15 @@ void App::Exit() {
 
 void App::StartTimer() {
     // Stop existing timers
-    KillTimer(m_window, TIMER_ID_KEYPRESS);
-    KillTimer(m_window, TIMER_ID_EXPIRE);
+    StopTimer();
 
     if (!m_settings.IsEnabled()) {
         return;
     }
 
     // Keypress timer (only if a virtual key is configured)
-    const WORD vk = m_settings.GetVirtualKey();
-    const UINT periodSec = m_settings.GetPeriodSec();
-    if (vk != 0 && periodSec > 0) {
-        const UINT intervalMs = periodSec * 1000;
-        Utils::SetTimerChecked(m_window, TIMER_ID_KEYPRESS, intervalMs);
-    }
+    RefreshIdleTimeout();
+    StartKeypressSchedule();
 
     // Expiration timer (one-shot)
     TimerConfig timer = m_settings.GetTimerConfig();
@@ -396,32 +649,423 @@ void App::StartTimer() {
         // For UntilTime we must pin a concrete end moment, otherwise it would roll to "tomorrow"
         // at the exact moment the timer fires.
         if (timer.mode == TimerMode::UntilTime && timer.endTimeUtc == 0) {
-            timer.ResetStartTime();
+            timer.ResetStartTime(m_clock);
             m_settings.SetTimerConfig(timer);
             SaveSettings();
         } else if (timer.mode == TimerMode::Duration && timer.endTimeUtc == 0 && timer.startTime.wYear == 0) {
             // Defensive: enabled duration without runtime state
-            timer.ResetStartTime();
+            timer.ResetStartTime(m_clock);
             m_settings.SetTimerConfig(timer);
             SaveSettings();
         }
 
+        // Restored duration: continue on the monotonic clock from here on.
+        timer.AnchorToMonotonic(m_clock);
+        m_settings.SetTimerConfig(timer);
+
         ArmExpireTimer(timer);
     }
+
+    ArmTooltipTimer();
+}
+
+void App::StartKeypressSchedule() {
+    m_wheel.Cancel(m_keypressId);
+    m_keypressScheduler.Stop();
+
+    const WORD vk = m_settings.GetVirtualKey();
+    const UINT periodSec = GetKeypressPeriodSec();
+    if (vk == 0 || periodSec == 0) {
+        ArmWheelTimer();
+        return;
+    }
+
+    // Per-session phase (and optional jitter) so sessions sharing a host do not
+    // all send their keypress in the same instant.
+    const ULONGLONG period = periodSec * Clock::TICKS_PER_SEC;
+    m_keypressScheduler.SetJitter(m_settings.GetKeypressJitterSec() * Clock::TICKS_PER_SEC, m_sessionHash);
+    m_keypressScheduler.StartAligned(m_clock.NowMonotonic(), period,
+                                     PhaseSpread::PhaseOffset(m_sessionHash, period),
+                                     PeriodicScheduler::LatePolicy::Skip);
+    ArmKeypressTimer();
+}
+
+UINT App::GetKeypressPeriodSec() const {
+    if (m_settings.GetAdaptivePeriod() && m_idleTimeout != 0) {
+        return IdleTimeout::AdaptivePeriodSec(m_idleTimeout, m_settings.GetKeypressJitterSec() * Clock::TICKS_PER_SEC);
+    }
+    return m_settings.GetPeriodSec();
+}
+
+void App::RefreshIdleTimeout() {
+    if (!m_settings.GetAdaptivePeriod() || !m_settings.IsEnabled() || m_session.IsIdle()) {
+        m_sampler.Remove(m_idleTimeoutSensor);
+        ArmSampler();
+        return;
+    }
+
+    ReadIdleTimeout();
+
+    // The lock policy and logind settings come without change notifications: re-read
+    // them on the sensors' shared tick.
+    if (!m_sampler.IsActive(m_idleTimeoutSensor)) {
+        static constexpr ULONGLONG kRereadInterval = 10ULL * Clock::TICKS_PER_MIN;
+        m_idleTimeoutSensor = m_sampler.Add("idle timeout", kRereadInterval, kRereadInterval, [this](ULONGLONG) {
+            ReadIdleTimeout();
+            return SensorTrend::Stable;
+        }, m_clock.NowMonotonic());
+        ArmSampler();
+    }
+}
+
+void App::ReadIdleTimeout() {
+    ULONGLONG timeout = 0;
+    if (!IdleTimeout::Query(timeout)) {
+        timeout = 0;   // nothing configured: fall back to PeriodSec
+    }
+    if (timeout != m_idleTimeout) {
+        m_idleTimeout = timeout;
+        Utils::DebugLog(L"[Everon] OS idle timeout %llus, keypress period %us\n",
+                        static_cast<unsigned long long>(timeout / Clock::TICKS_PER_SEC), GetKeypressPeriodSec());
+        if (m_keypressScheduler.IsRunning()) {
+            StartKeypressSchedule();
+        }
+    }
+}
+
+void App::ArmSampler() {
+    // One wheel entry for every sensor: reads due together share the wakeup.
+    m_wheel.Cancel(m_samplerId);
+    ULONGLONG deadline = 0;
+    ULONGLONG tolerance = 0;
+    if (m_sampler.GetNextDeadline(deadline, tolerance)) {
+        m_samplerId = m_wheel.Schedule(deadline, [this]() { OnSamplerTimer(); }, tolerance);
+    }
+    ArmWheelTimer();
+}
+
+void App::OnSamplerTimer() {
+    m_sampler.Run(m_clock.NowMonotonic());
+
+    static constexpr ULONGLONG kStatsLogEvery = 256;
+    if (m_sampler.GetWakeupCount() % kStatsLogEvery == 0) {
+        LogSensorStatistics();
+    }
+    ArmSampler();
+}
+
+void App::LogSensorStatistics() const {
+    if (m_sampler.IsEmpty()) {
+        return;
+    }
+    Utils::DebugLog(L"[Everon] Sensors: %llu wakeups, %llu reads; %hs\n",
+                    static_cast<unsigned long long>(m_sampler.GetWakeupCount()),
+                    static_cast<unsigned long long>(m_sampler.GetReadCount()), m_sampler.DescribeStats().c_str());
+}
+
+void App::RegisterPowerSettingNotifications() {
+    const GUID* settings[] = { &GUID_VIDEO_POWERDOWN_TIMEOUT, &GUID_STANDBY_TIMEOUT, &GUID_ACDC_POWER_SOURCE,
+                               &GUID_BATTERY_PERCENTAGE_REMAINING };
+    static_assert(_countof(settings) == _countof(m_powerNotify), "one handle per setting");
+    for (size_t i = 0; i < _countof(settings); ++i) {
+        m_powerNotify[i] = RegisterPowerSettingNotification(m_window, settings[i], DEVICE_NOTIFY_WINDOW_HANDLE);
+        if (!m_powerNotify[i]) {
+            Utils::CheckWinApiBool(FALSE, L"RegisterPowerSettingNotification");
+        }
+    }
+}
+
+void App::OnPowerSupplyChanged() {
+    // Broadcast on AC/battery switches and charge steps; act only when the policy's
+    // answer changes.
+    const BatteryAction before = GetBatteryAction();
+    if (!PowerSupply::Query(m_powerSupply)) {
+        return;
+    }
+    const BatteryAction after = GetBatteryAction();
+    if (after != before) {
+        Utils::DebugLog(L"[Everon] Battery policy: action %lu (on battery %d, %d%%)\n",
+                        static_cast<unsigned long>(after), m_powerSupply.onBattery ? 1 : 0, m_powerSupply.percent);
+        UpdatePowerState();
+        UpdateTooltip();
+    }
+}
+
+void App::OnSessionChanged(WPARAM event) {
+    const bool wasIdle = m_session.IsIdle();
+    switch (event) {
+        case WTS_SESSION_LOCK:
+            m_session.locked = true;
+            break;
+        case WTS_SESSION_UNLOCK:
+            m_session.locked = false;
+            break;
+        case WTS_CONSOLE_DISCONNECT:
+        case WTS_REMOTE_DISCONNECT:
+            m_session.active = false;
+            break;
+        case WTS_CONSOLE_CONNECT:
+        case WTS_REMOTE_CONNECT:
+            m_session.active = true;
+            break;
+        default:
+            return;
+    }
+    if (m_session.IsIdle() == wasIdle) {
+        return;
+    }
+
+    Utils::DebugLog(L"[Everon] Session %ls (locked %d, connected %d)\n",
+                    m_session.IsIdle() ? L"idle: timers paused" : L"back: timers resumed",
+                    m_session.locked ? 1 : 0, m_session.active ? 1 : 0);
+    if (m_session.IsIdle()) {
+        // The Arm* guards see the idle session and leave their timers cancelled.
+        ArmKeypressTimer();
+        ArmTooltipTimer();
+        RefreshIdleTimeout();
+    } else if (m_settings.IsEnabled()) {
+        RefreshIdleTimeout();
+        StartKeypressSchedule();
+        ArmTooltipTimer();
+        UpdateTooltip();
+    }
+    UpdatePowerState();
+}
+
+void App::StartProcessWatch() {
+    m_processWatcher.Stop();
+    m_watchList.SetNames(m_settings.GetWatchProcesses());
+    if (m_watchList.IsEmpty() || !m_processWatcher.Start(m_window, WM_PROCESS_EVENT)) {
+        return;
+    }
+    // Jobs already running at start-up are found by one walk of the process list;
+    // from here on only start/exit events are seen.
+    if (m_processWatcher.Scan()) {
+        Utils::DebugLog(L"[Everon] Watched jobs: %hs\n", m_watchList.DescribeRunning().c_str());
+        UpdatePowerState();
+    }
+}
+
+void App::OnProcessEvent() {
+    if (m_processWatcher.Consume()) {
+        Utils::DebugLog(L"[Everon] Watched jobs: %hs\n",
+                        m_watchList.IsAnyRunning() ? m_watchList.DescribeRunning().c_str() : "none running");
+        UpdatePowerState();
+    }
+}
+
+void App::StartActivityMonitor() {
+    for (SensorSampler::SensorId& id : m_activitySensors) {
+        m_sampler.Remove(id);
+    }
+    const ULONGLONG sustain = m_settings.GetActivitySustainSec() * Clock::TICKS_PER_SEC;
+    m_activity.Configure(m_settings.GetCpuActivityPercent(), m_settings.GetDiskActivityKBps(),
+                         m_settings.GetNetworkActivityKBps(), sustain);
+
+    // One sensor per kind: a busy network is sampled quickly while the quiet CPU backs off.
+    const ULONGLONG now = m_clock.NowMonotonic();
+    for (size_t i = 0; i < static_cast<size_t>(ActivityKind::Count); ++i) {
+        const ActivityKind kind = static_cast<ActivityKind>(i);
+        if (!m_activity.IsEnabled(kind)) {
+            continue;
+        }
+        m_activity.Sample(kind, now);   // baseline only
+        m_activitySensors[i] = m_sampler.Add(ActivityMonitor::GetName(kind), ActivityMonitor::GetSamplePeriod(sustain),
+                                             ActivityMonitor::GetMaxSamplePeriod(sustain), [this, kind](ULONGLONG at) {
+            if (m_activity.Sample(kind, at)) {
+                const std::string active = m_activity.DescribeActive();
+                Utils::DebugLog(L"[Everon] System activity: %hs\n", active.empty() ? "quiet" : active.c_str());
+                UpdatePowerState();
+            }
+            return m_activity.GetTrigger(kind).GetTrend();
+        }, now);
+    }
+    ArmSampler();
+}
+
+void App::StartFileWatch() {
+    m_sampler.Remove(m_filesQuietSensor);
+    m_filesBusy = false;
+    const std::vector<FileWatcher::String> roots = FileWatcher::SplitList(m_settings.GetWatchFolders());
+    if (roots.empty() || !m_fileWatcher.Start(roots, m_window, WM_FILE_EVENT)) {
+        m_fileWatcher.Stop();
+    }
+    ArmSampler();
+}
+
+void App::OnFileEvent() {
+    const ULONGLONG now = m_clock.NowMonotonic();
+    m_fileWatcher.Consume(now);
+    if (m_filesBusy || !m_fileWatcher.IsBusy(now, m_settings.GetFolderQuietSec() * Clock::TICKS_PER_SEC)) {
+        return;
+    }
+
+    // Files are landing. Until the quiet period passes, events only accumulate in the
+    // watcher's ring: no message per batch, one look per quarter of the quiet period.
+    m_filesBusy = true;
+    m_fileWatcher.SetNotify(false);
+    const ULONGLONG quiet = m_settings.GetFolderQuietSec() * Clock::TICKS_PER_SEC;
+    m_filesQuietSensor = m_sampler.Add("folders", quiet / 4, quiet / 4, [this](ULONGLONG at) {
+        CheckFilesQuiet(at);
+        return SensorTrend::NearThreshold;
+    }, now);
+    Utils::DebugLog(L"[Everon] Files arriving in watched folders\n");
+    UpdatePowerState();
+    ArmSampler();
+}
+
+void App::CheckFilesQuiet(ULONGLONG now) {
+    m_fileWatcher.Consume(now);
+    if (m_fileWatcher.IsBusy(now, m_settings.GetFolderQuietSec() * Clock::TICKS_PER_SEC)) {
+        return;
+    }
+    Utils::DebugLog(L"[Everon] Watched folders quiet (%llu events in total)\n",
+                    static_cast<unsigned long long>(m_fileWatcher.GetEventCount()));
+    m_filesBusy = false;
+    m_sampler.Remove(m_filesQuietSensor);
+    m_fileWatcher.SetNotify(true);
+    UpdatePowerState();
+}
+
+BatteryAction App::GetBatteryAction() const {
+    return m_settings.GetBatteryPolicy().Evaluate(m_powerSupply);
+}
+
+void App::UnregisterPowerSettingNotifications() {
+    for (HPOWERNOTIFY& handle : m_powerNotify) {
+        if (handle) {
+            UnregisterPowerSettingNotification(handle);
+            handle = nullptr;
+        }
+    }
+}
+
+void App::OnClockChanged() {
+    // Wall clock stepped, time zone changed or the system resumed: SetTimer intervals
+    // no longer match the deadline, so re-evaluate and re-arm right away.
+    if (!m_settings.IsEnabled()) {
+        return;
+    }
+
+    // A display window is defined in local time: re-evaluate it against the new clock.
+    if (m_settings.GetDisplayPolicy().HasWindow()) {
+        UpdatePowerState();
+        UpdateTooltip();
+    }
+
+    TimerConfig timer = m_settings.GetTimerConfig();
+    if (timer.mode == TimerMode::Indefinite) {
+        return;
+    }
+
+    // Durations run on the monotonic clock; only the persisted wall deadline moves.
+    if (timer.SyncWallDeadline(m_clock)) {
+        m_settings.SetTimerConfig(timer);
+        SaveSettings();
+    }
+
+    ArmExpireTimer(timer);
 }
 
 
 void App::StopTimer() {
-    KillTimer(m_window, TIMER_ID_KEYPRESS);
-    KillTimer(m_window, TIMER_ID_EXPIRE);
+    m_wheel.Cancel(m_keypressId);
+    m_wheel.Cancel(m_expireId);
+    m_wheel.Cancel(m_tooltipId);
+    m_sampler.Remove(m_idleTimeoutSensor);
+    ArmSampler();
+
+    if (m_keypressScheduler.IsRunning()) {
+        LogKeypressStatistics();
+        m_keypressScheduler.Stop();
+        m_keypressScheduler.ResetStatistics();
+        m_idleMonitor.ResetCounters();
+    }
 }
 
 
 void App::UpdatePowerState() {
-    if (m_settings.IsEnabled()) {
-        m_powerManager.PreventSleep(m_settings.GetKeepDisplayOn());
+    m_wheel.Cancel(m_displayPolicyId);
+    if (!m_settings.IsEnabled()) {
+        m_enabledMonotonic = 0;
+    } else if (m_enabledMonotonic == 0) {
+        m_enabledMonotonic = m_clock.NowMonotonic();
+    }
+
+    // On battery the policy may drop the display part or pause keeping awake altogether.
+    const BatteryAction battery = GetBatteryAction();
+    // Locked/disconnected sessions keep their request only if the policy says so (a
+    // download left running behind the lock screen).
+    const bool keepAwake = m_settings.IsEnabled() && battery != BatteryAction::Suspend &&
+                           (!m_session.IsIdle() || m_settings.GetKeepAwakeWhenLocked());
+
+    // The display policy may limit "keep display on" to part of the period; re-run at the
+    // next switch so the hold drops to (or returns from) system only.
+    bool keepDisplayOn = m_settings.GetKeepDisplayOn() && battery == BatteryAction::None;
+    const DisplayPolicy policy = m_settings.GetDisplayPolicy();
+    if (m_settings.IsEnabled() && keepDisplayOn && policy.IsLimited()) {
+        ULONGLONG next = 0;
+        keepDisplayOn = policy.IsDisplayOn(m_clock, m_enabledMonotonic, next);
+        if (next != 0) {
+            m_displayPolicyId = m_wheel.Schedule(next, [this]() {
+                UpdatePowerState();
+                UpdateTooltip();
+            }, 5 * Clock::TICKS_PER_SEC);
+        }
+    }
+
+    // The enabled state is held as "Timer" while a timed mode runs, "Manual" otherwise.
+    const bool timed = m_settings.GetTimerConfig().mode != TimerMode::Indefinite;
+    if (keepAwake) {
+        m_awake.Request(timed ? AWAKE_SOURCE_TIMER : AWAKE_SOURCE_MANUAL, keepDisplayOn);
+    }
+    if (!keepAwake || timed) {
+        m_awake.Release(AWAKE_SOURCE_MANUAL);
+    }
+    if (!keepAwake || !timed) {
+        m_awake.Release(AWAKE_SOURCE_TIMER);
+    }
+
+    // Watched jobs keep the system (not the display) awake whether or not Everon is
+    // enabled, and behind the lock screen too: that is where backups run.
+    if (m_watchList.IsAnyRunning() && battery != BatteryAction::Suspend) {
+        m_awake.Request(AWAKE_SOURCE_PROCESS, false);
+    } else {
+        m_awake.Release(AWAKE_SOURCE_PROCESS);
+    }
+    // Sustained system activity (a download, a render) likewise.
+    if (m_activity.IsActive() && battery != BatteryAction::Suspend) {
+        m_awake.Request(AWAKE_SOURCE_ACTIVITY, false);
     } else {
-        m_powerManager.AllowSleep();
+        m_awake.Release(AWAKE_SOURCE_ACTIVITY);
+    }
+    // Files landing in a watched folder likewise.
+    if (m_filesBusy && battery != BatteryAction::Suspend) {
+        m_awake.Request(AWAKE_SOURCE_FILES, false);
+    } else {
+        m_awake.Release(AWAKE_SOURCE_FILES);
+    }
+    ArmVerifyTimer();
+}
+
+void App::ArmVerifyTimer() {
+    m_wheel.Cancel(m_verifyId);
+    if (m_powerManager.IsPreventingSleep()) {
+        // Low frequency with a wide tolerance: the check only needs to happen eventually.
+        const ULONGLONG interval = m_powerManager.GetVerifyInterval();
+        m_verifyId = m_wheel.Schedule(m_clock.NowMonotonic() + interval, [this]() {
+            m_powerManager.Verify();
+            ArmVerifyTimer();
+        }, interval / 10);
+    }
+    ArmWheelTimer();
+}
+
+
+void App::UpdateTooltip() {
+    if (m_trayIcon) {
+        m_trayIcon->UpdateTooltip(m_settings, m_awake.GetState() == AwakeArbiter::State::Display,
+                                  GetBatteryAction() == BatteryAction::Suspend);
     }
 }
 
@@ -4,6 +4,18 @@
 #include <memory>
 #include "Settings.h"
 #include "PowerManager.h"
+#include "AwakeArbiter.h"
+#include "Clock.h"
+#include "DeadlineTimer.h"
+#include "PeriodicScheduler.h"
+#include "TimingWheel.h"
+#include "Efficiency.h"
+#include "IdleMonitor.h"
+#include "ActivityMonitor.h"
+#include "FileWatch.h"
+#include "ProcessWatch.h"
+#include "SensorSampler.h"
+#include "SessionMonitor.h"
 
 namespace Everon {
 
@@ -13,19 +25,52 @@ class HotkeyManager;
 
 class App {
 public:
-    explicit App(HINSTANCE instance);
+    explicit App(HINSTANCE instance, const Clock& clock = SystemClock::Instance());
     ~App();
     int Run();
 
     static constexpr const wchar_t* WINDOW_CLASS_NAME = L"EveronMainWindow";
     static constexpr UINT WM_SHOW_SETTINGS = WM_APP + 2;
+    static constexpr UINT WM_PROCESS_EVENT = WM_APP + 3;
+    static constexpr UINT WM_FILE_EVENT = WM_APP + 4;
+    static constexpr UINT WM_WHEEL_TIMER = WM_APP + 5;
 
 private:
     static LRESULT CALLBACK WindowProc(HWND window, UINT message,
                                       WPARAM wParam, LPARAM lParam);
     void OnCreate();
+    void ApplyEfficiencyMode();
     void OnDestroy();
     void OnTimer(UINT_PTR timerId);
+    void OnClockChanged();
+    void OnWheelTimer();
+    void ArmWheelTimer();
+    bool WatchWheelTimer();
+    static VOID CALLBACK OnWheelTimerSignaled(PVOID context, BOOLEAN timedOut);
+    void OnExpireTimer();
+    void OnKeypressTimer();
+    void ArmKeypressTimer();
+    void OnTooltipTimer();
+    void ArmTooltipTimer();
+    void StartKeypressSchedule();
+    UINT GetKeypressPeriodSec() const;
+    void RefreshIdleTimeout();
+    void ReadIdleTimeout();
+    void OnPowerSupplyChanged();
+    void OnSessionChanged(WPARAM event);
+    void StartProcessWatch();
+    void OnProcessEvent();
+    void StartActivityMonitor();
+    void StartFileWatch();
+    void OnFileEvent();
+    void CheckFilesQuiet(ULONGLONG now);
+    void ArmSampler();
+    void OnSamplerTimer();
+    void LogSensorStatistics() const;
+    BatteryAction GetBatteryAction() const;
+    void RegisterPowerSettingNotifications();
+    void UnregisterPowerSettingNotifications();
+    void LogKeypressStatistics() const;
     void OnTrayIcon(LPARAM lParam);
     void OnHotkey(WPARAM wParam);
     void OnTaskbarCreated();
@@ -37,13 +82,46 @@ private:
     void StopTimer();
     void ArmExpireTimer(const TimerConfig& timer);
     void UpdatePowerState();
+    void UpdateTooltip();
+    void ArmVerifyTimer();
     void RegisterHotkey();
     bool SaveSettings();
 
     HINSTANCE m_instance = nullptr;
     HWND m_window = nullptr;
+    const Clock& m_clock;
     Settings m_settings;
     PowerManager m_powerManager;
+    AwakeArbiter m_awake;           // merges keep-awake requests into m_powerManager calls
+    TimingWheel m_wheel;            // every logical timer, on m_clock's monotonic time line
+    DeadlineTimer m_wheelTimer;     // the one OS timer, armed for the wheel's next deadline
+    HANDLE m_wheelWait = nullptr;   // thread-pool wait posting WM_WHEEL_TIMER when it fires
+    bool m_inWheelAdvance = false;  // callbacks running: re-arm once afterwards
+    TimingWheel::TimerId m_expireId;
+    TimingWheel::TimerId m_keypressId;
+    TimingWheel::TimerId m_tooltipId;
+    TimingWheel::TimerId m_displayPolicyId; // next display-on/system-only switch
+    TimingWheel::TimerId m_verifyId;        // next check that the OS honours the hold
+    ULONGLONG m_enabledMonotonic = 0;       // start of the current enabled period, 0 = disabled
+    ULONGLONG m_idleTimeout = 0;            // shortest OS inactivity timeout, 0 = none/unknown
+    HPOWERNOTIFY m_powerNotify[4] = {};
+    PowerSupplyStatus m_powerSupply;        // AC/battery state, refreshed on power broadcasts
+    SessionState m_session;                 // lock/connect state, from WM_WTSSESSION_CHANGE
+    bool m_sessionNotify = false;           // registered for session change notifications
+    ProcessWatchList m_watchList;           // watched jobs (WatchProcesses) now running
+    ProcessWatcher m_processWatcher;        // feeds m_watchList from OS process events
+    ActivityMonitor m_activity;             // CPU/disk/network triggers (Cpu/Disk/NetworkActivity*)
+    SensorSampler m_sampler;                // every polled sensor, on one shared tick
+    TimingWheel::TimerId m_samplerId;       // the sampler's next batch
+    SensorSampler::SensorId m_idleTimeoutSensor;    // periodic re-read of the OS idle timeout
+    SensorSampler::SensorId m_activitySensors[static_cast<size_t>(ActivityKind::Count)];
+    FileWatcher m_fileWatcher;              // writes in the WatchFolders trees
+    SensorSampler::SensorId m_filesQuietSensor;     // while files are landing: checks for the quiet period
+    bool m_filesBusy = false;
+    PeriodicScheduler m_keypressScheduler;
+    WakeupCounter m_wakeups;        // timer wakeups, checked against the budget
+    IdleMonitor m_idleMonitor;      // skips keypresses while the user is typing
+    ULONGLONG m_sessionHash = 0;    // PhaseSpread identity of this login session
     std::unique_ptr<TrayIcon> m_trayIcon;
     std::unique_ptr<SettingsDialog> m_settingsDialog;
     std::unique_ptr<HotkeyManager> m_hotkeyManager;
@@ -51,8 +129,15 @@ private:
 
     UINT m_taskbarCreatedMessage = 0;
 
-    static constexpr UINT_PTR TIMER_ID_KEYPRESS = 1;
-    static constexpr UINT_PTR TIMER_ID_EXPIRE = 2;
+    // Keep-awake request sources
+    static constexpr const wchar_t* AWAKE_SOURCE_MANUAL = L"Manual";
+    static constexpr const wchar_t* AWAKE_SOURCE_TIMER = L"Timer";
+    static constexpr const wchar_t* AWAKE_SOURCE_PROCESS = L"Process";
+    static constexpr const wchar_t* AWAKE_SOURCE_ACTIVITY = L"Activity";
+    static constexpr const wchar_t* AWAKE_SOURCE_FILES = L"Files";
+
+    // Window timer, used only if the wheel's DeadlineTimer cannot be armed
+    static constexpr UINT_PTR TIMER_ID_WHEEL = 1;
 };
 
 } // namespace Everon
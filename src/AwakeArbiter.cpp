@@ -0,0 +1,91 @@
+#include "AwakeArbiter.h"
+#include <algorithm>
+#include <utility>
+
+namespace Everon {
+
+AwakeArbiter::AwakeArbiter(ApplyFn apply)
+    : m_apply(std::move(apply)) {
+}
+
+void AwakeArbiter::Request(const std::wstring& source, bool keepDisplayOn) {
+    ++m_requests;
+    auto it = std::find_if(m_holders.begin(), m_holders.end(),
+                           [&source](const Holder& holder) { return holder.source == source; });
+    if (it == m_holders.end()) {
+        m_holders.push_back({ source, keepDisplayOn });
+        m_displayCount += keepDisplayOn ? 1 : 0;
+    } else if (it->keepDisplayOn != keepDisplayOn) {
+        it->keepDisplayOn = keepDisplayOn;
+        keepDisplayOn ? ++m_displayCount : --m_displayCount;
+    }
+    Update();
+}
+
+void AwakeArbiter::Release(const std::wstring& source) {
+    auto it = std::find_if(m_holders.begin(), m_holders.end(),
+                           [&source](const Holder& holder) { return holder.source == source; });
+    if (it == m_holders.end()) {
+        return;
+    }
+    ++m_requests;
+    m_displayCount -= it->keepDisplayOn ? 1 : 0;
+    m_holders.erase(it);
+    Update();
+}
+
+void AwakeArbiter::ReleaseAll() {
+    ++m_requests;
+    m_holders.clear();
+    m_displayCount = 0;
+    Update();
+}
+
+bool AwakeArbiter::IsHeld(const std::wstring& source) const noexcept {
+    return std::any_of(m_holders.begin(), m_holders.end(),
+                       [&source](const Holder& holder) { return holder.source == source; });
+}
+
+std::vector<std::wstring> AwakeArbiter::GetHolders() const {
+    std::vector<std::wstring> out;
+    out.reserve(m_holders.size());
+    for (const Holder& holder : m_holders) {
+        out.push_back(holder.keepDisplayOn ? holder.source + L" (display)" : holder.source);
+    }
+    return out;
+}
+
+std::wstring AwakeArbiter::DescribeHolders() const {
+    std::wstring out;
+    for (const std::wstring& holder : GetHolders()) {
+        if (!out.empty()) {
+            out += L", ";
+        }
+        out += holder;
+    }
+    return out;
+}
+
+AwakeArbiter::State AwakeArbiter::Merged() const noexcept {
+    if (m_holders.empty()) {
+        return State::Sleep;
+    }
+    return m_displayCount > 0 ? State::Display : State::System;
+}
+
+void AwakeArbiter::Update() {
+    const State merged = Merged();
+    if (merged == m_applied) {
+        return;
+    }
+
+    if (!m_apply || m_apply(merged)) {
+        m_applied = merged;
+        ++m_transitions;
+        static const wchar_t* const kNames[] = { L"sleep allowed", L"system awake", L"system and display awake" };
+        Utils::DebugLog(L"[Everon] Power state: %ls, held by: %ls\n", kNames[static_cast<int>(merged)],
+                        m_holders.empty() ? L"(nobody)" : DescribeHolders().c_str());
+    }
+}
+
+} // namespace Everon
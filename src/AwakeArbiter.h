@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Platform.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Everon {
+
+// Merges the keep-awake requests of independent sources (manual toggle, timer, IPC
+// clients, watchers) into one OS state. Each source holds at most one named request;
+// the machine stays awake while any request exists and the display stays on while any
+// request asks for it. The OS is called only when the merged state changes.
+class AwakeArbiter {
+public:
+    enum class State {
+        Sleep,          // no requests: normal power management
+        System,         // keep the system awake, the display may turn off
+        Display         // keep the system awake and the display on
+    };
+
+    // Applies a merged state to the OS; false if it could not (retried on the next change).
+    using ApplyFn = std::function<bool(State state)>;
+
+    explicit AwakeArbiter(ApplyFn apply);
+
+    // Adds or updates `source`'s request.
+    void Request(const std::wstring& source, bool keepDisplayOn);
+    // Drops `source`'s request, if any.
+    void Release(const std::wstring& source);
+    // Drops every request.
+    void ReleaseAll();
+
+    State GetState() const noexcept { return m_applied; }
+    bool IsHeld(const std::wstring& source) const noexcept;
+    // Sources holding the machine awake, in request order; "(display)" marks those that
+    // also keep the display on.
+    std::vector<std::wstring> GetHolders() const;
+    std::wstring DescribeHolders() const;
+
+    // Requests seen versus OS transitions made.
+    ULONGLONG GetRequestCount() const noexcept { return m_requests; }
+    ULONGLONG GetTransitionCount() const noexcept { return m_transitions; }
+
+private:
+    struct Holder {
+        std::wstring source;
+        bool keepDisplayOn;
+    };
+
+    State Merged() const noexcept;
+    void Update();
+
+    ApplyFn m_apply;
+    std::vector<Holder> m_holders;      // a handful of sources: linear search
+    size_t m_displayCount = 0;          // holders with keepDisplayOn
+    State m_applied = State::Sleep;
+    ULONGLONG m_requests = 0;
+    ULONGLONG m_transitions = 0;
+};
+
+} // namespace Everon
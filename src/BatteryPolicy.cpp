@@ -0,0 +1,18 @@
+#include "BatteryPolicy.h"
+
+namespace Everon {
+
+BatteryAction BatteryPolicy::Evaluate(const PowerSupplyStatus& status) const noexcept {
+    if (!status.hasBattery || !status.onBattery) {
+        return BatteryAction::None;
+    }
+
+    BatteryAction action = onBattery;
+    if (lowPercent != 0 && status.percent >= 0 && static_cast<DWORD>(status.percent) <= lowPercent &&
+        whenLow > action) {
+        action = whenLow;
+    }
+    return action;
+}
+
+} // namespace Everon
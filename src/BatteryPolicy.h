@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Platform.h"
+
+namespace Everon {
+
+// Power source as last reported by the OS.
+struct PowerSupplyStatus {
+    bool hasBattery = false;
+    bool onBattery = false;     // running from the battery (no AC)
+    int percent = -1;           // remaining charge, -1 = unknown
+};
+
+// What to give up on battery to avoid keeping a laptop awake until it dies.
+enum class BatteryAction : DWORD {
+    None = 0,
+    DropDisplay = 1,    // stay awake, but let the display turn off
+    Suspend = 2         // stop keeping awake (and stop keypresses) until AC returns
+};
+
+struct BatteryPolicy {
+    BatteryAction onBattery = BatteryAction::None;      // as soon as AC is unplugged
+    DWORD lowPercent = 0;                               // 0 = no low-charge rule
+    BatteryAction whenLow = BatteryAction::Suspend;     // on battery at or below lowPercent
+
+    static constexpr DWORD MAX_LOW_PERCENT = 99;
+
+    // The stronger of the rules that apply to `status`; None on AC or without a battery.
+    BatteryAction Evaluate(const PowerSupplyStatus& status) const noexcept;
+};
+
+namespace PowerSupply {
+
+// Current power source. Windows: GetSystemPowerStatus. Linux: /sys/class/power_supply.
+bool Query(PowerSupplyStatus& status);
+
+#ifndef _WIN32
+// Same, from a power_supply class tree rooted at `root` (a fake tree in tests).
+bool QuerySysfs(const char* root, PowerSupplyStatus& status);
+#endif
+
+} // namespace PowerSupply
+} // namespace Everon
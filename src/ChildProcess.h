@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Platform.h"
+#include <string>
+#include <vector>
+
+namespace Everon {
+
+// One command run as a child process and waited on without polling.
+// Windows: CreateProcess and a wait on the process handle. Linux: posix_spawnp and a
+// pidfd (Linux 5.3+; older kernels fall back to a blocking waitpid).
+class ChildProcess {
+public:
+#ifdef _WIN32
+    using String = std::wstring;
+    using NativeHandle = HANDLE;
+#else
+    using String = std::string;
+    using NativeHandle = int;
+#endif
+
+    ChildProcess() = default;
+    ~ChildProcess();
+
+    ChildProcess(const ChildProcess&) = delete;
+    ChildProcess& operator=(const ChildProcess&) = delete;
+
+    // Starts argv[0] (searched in PATH) with the remaining arguments, sharing our
+    // console and standard handles. False on failure, with the OS error in GetError().
+    bool Spawn(const std::vector<String>& argv);
+
+    // Waits up to `timeoutMs` (INFINITE: no limit) for the child to exit. True once it
+    // has exited; GetExitStatus() is then valid.
+    bool Wait(DWORD timeoutMs);
+    bool HasExited() const noexcept { return m_exited; }
+
+    // The status as a shell reports it: the exit code, or 128 + N when killed by signal N.
+    int GetExitStatus() const noexcept { return m_status; }
+    // Signal that ended the child, 0 if it exited normally (always 0 on Windows).
+    int GetTermSignal() const noexcept { return m_signal; }
+    int GetError() const noexcept { return m_error; }
+
+    // Forwards a termination request to the child (a signal on Linux).
+    void Signal(int signal);
+
+private:
+    NativeHandle m_handle = {};         // process handle or pidfd
+    DWORD m_pid = 0;
+    bool m_exited = false;
+    int m_status = 0;
+    int m_signal = 0;
+    int m_error = 0;
+};
+
+} // namespace Everon
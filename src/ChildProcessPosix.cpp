@@ -0,0 +1,100 @@
+#include "ChildProcess.h"
+#include <cerrno>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace Everon {
+
+ChildProcess::~ChildProcess() {
+    if (m_handle > 0) {
+        close(m_handle);
+    }
+}
+
+bool ChildProcess::Spawn(const std::vector<String>& argv) {
+    if (argv.empty() || m_pid != 0) {
+        m_error = EINVAL;
+        return false;
+    }
+
+    std::vector<char*> args;
+    args.reserve(argv.size() + 1);
+    for (const String& arg : argv) {
+        args.push_back(const_cast<char*>(arg.c_str()));
+    }
+    args.push_back(nullptr);
+
+    // The child starts with default signal dispositions and an empty mask, whatever the
+    // wrapper ignores or blocks while it waits.
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t all;
+    sigset_t none;
+    sigfillset(&all);
+    sigemptyset(&none);
+    posix_spawnattr_setsigdefault(&attr, &all);
+    posix_spawnattr_setsigmask(&attr, &none);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+
+    pid_t pid = 0;
+    m_error = posix_spawnp(&pid, args[0], nullptr, &attr, args.data(), environ);
+    posix_spawnattr_destroy(&attr);
+    if (m_error != 0) {
+        return false;
+    }
+    m_pid = static_cast<DWORD>(pid);
+
+#ifdef SYS_pidfd_open
+    m_handle = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (m_handle < 0) {
+        m_handle = 0;   // ENOSYS: wait with waitpid alone
+    }
+#endif
+    return true;
+}
+
+bool ChildProcess::Wait(DWORD timeoutMs) {
+    if (m_exited || m_pid == 0) {
+        return m_exited;
+    }
+
+    if (m_handle > 0) {
+        pollfd pfd = { m_handle, POLLIN, 0 };
+        const int timeout = (timeoutMs == INFINITE) ? -1 : static_cast<int>(timeoutMs);
+        const int ready = poll(&pfd, 1, timeout);
+        if (ready == 0 || (ready < 0 && errno == EINTR)) {
+            return false;
+        }
+    }
+
+    // Reaped only once it has exited (pidfd readable), or blocking without a pidfd:
+    // older kernels give up the timeout rather than poll.
+    int status = 0;
+    const pid_t pid = static_cast<pid_t>(m_pid);
+    if (waitpid(pid, &status, 0) != pid) {
+        return false;   // EINTR: a signal for the caller to handle
+    }
+
+    m_exited = true;
+    if (WIFSIGNALED(status)) {
+        m_signal = WTERMSIG(status);
+        m_status = 128 + m_signal;
+    } else {
+        m_status = WEXITSTATUS(status);
+    }
+    return true;
+}
+
+void ChildProcess::Signal(int signal) {
+    if (m_pid != 0 && !m_exited) {
+        kill(static_cast<pid_t>(m_pid), signal);
+    }
+}
+
+} // namespace Everon
@@ -0,0 +1,92 @@
+#include "ChildProcess.h"
+
+namespace Everon {
+
+namespace {
+
+// Appends `arg` to a command line so that CommandLineToArgvW (and the C runtime) read it
+// back unchanged: quoted when needed, with backslashes doubled only before a quote.
+void AppendArgument(std::wstring& commandLine, const std::wstring& arg) {
+    if (!commandLine.empty()) {
+        commandLine += L' ';
+    }
+    if (!arg.empty() && arg.find_first_of(L" \t\n\v\"") == std::wstring::npos) {
+        commandLine += arg;
+        return;
+    }
+
+    commandLine += L'"';
+    size_t backslashes = 0;
+    for (wchar_t c : arg) {
+        if (c == L'\\') {
+            ++backslashes;
+            continue;
+        }
+        if (c == L'"') {
+            commandLine.append(backslashes * 2 + 1, L'\\');
+        } else {
+            commandLine.append(backslashes, L'\\');
+        }
+        backslashes = 0;
+        commandLine += c;
+    }
+    commandLine.append(backslashes * 2, L'\\');
+    commandLine += L'"';
+}
+
+} // namespace
+
+ChildProcess::~ChildProcess() {
+    if (m_handle) {
+        CloseHandle(m_handle);
+    }
+}
+
+bool ChildProcess::Spawn(const std::vector<String>& argv) {
+    if (argv.empty() || m_handle) {
+        m_error = ERROR_INVALID_PARAMETER;
+        return false;
+    }
+
+    std::wstring commandLine;
+    for (const String& arg : argv) {
+        AppendArgument(commandLine, arg);
+    }
+
+    STARTUPINFOW startup = {};
+    startup.cb = sizeof(startup);
+    PROCESS_INFORMATION info = {};
+    if (!CreateProcessW(nullptr, &commandLine[0], nullptr, nullptr, TRUE, 0, nullptr, nullptr, &startup, &info)) {
+        m_error = static_cast<int>(GetLastError());
+        return false;
+    }
+    CloseHandle(info.hThread);
+    m_handle = info.hProcess;
+    m_pid = info.dwProcessId;
+    return true;
+}
+
+bool ChildProcess::Wait(DWORD timeoutMs) {
+    if (m_exited || !m_handle) {
+        return m_exited;
+    }
+    if (WaitForSingleObject(m_handle, timeoutMs) != WAIT_OBJECT_0) {
+        return false;
+    }
+
+    DWORD code = 0;
+    GetExitCodeProcess(m_handle, &code);
+    m_exited = true;
+    m_status = static_cast<int>(code);
+    return true;
+}
+
+void ChildProcess::Signal(int signal) {
+    // Ctrl+C and Ctrl+Break reach the child through the shared console; anything else
+    // (the console closing, a logoff) ends it the way a shell would report a signal.
+    if (m_handle && !m_exited) {
+        TerminateProcess(m_handle, static_cast<UINT>(128 + signal));
+    }
+}
+
+} // namespace Everon
@@ -0,0 +1,116 @@
+#include "CivilTime.h"
+
+// Compile-time checks for CivilTime.h. Nothing here runs; a failing check breaks the build.
+
+namespace Everon {
+namespace Civil {
+namespace {
+
+constexpr SYSTEMTIME MakeTime(WORD year, WORD month, WORD day, WORD hour = 0, WORD minute = 0,
+                              WORD second = 0, WORD milliseconds = 0) noexcept {
+    SYSTEMTIME st = {};
+    st.wYear = year;
+    st.wMonth = month;
+    st.wDay = day;
+    st.wHour = hour;
+    st.wMinute = minute;
+    st.wSecond = second;
+    st.wMilliseconds = milliseconds;
+    return st;
+}
+
+constexpr bool SameDateTime(const SYSTEMTIME& a, const SYSTEMTIME& b) noexcept {
+    return a.wYear == b.wYear && a.wMonth == b.wMonth && a.wDay == b.wDay && a.wHour == b.wHour &&
+           a.wMinute == b.wMinute && a.wSecond == b.wSecond && a.wMilliseconds == b.wMilliseconds;
+}
+
+constexpr ULONGLONG Ticks(const SYSTEMTIME& st) noexcept {
+    ULONGLONG ticks = 0;
+    return SystemTimeToTicks(st, ticks) ? ticks : 0;
+}
+
+constexpr SYSTEMTIME PlusDays(SYSTEMTIME st, LONGLONG days) noexcept {
+    AddDays(st, days);
+    return st;
+}
+
+constexpr SYSTEMTIME PlusMinutes(SYSTEMTIME st, LONGLONG minutes) noexcept {
+    AddMinutes(st, minutes);
+    return st;
+}
+
+// Every day in [first, last] survives days -> civil -> days.
+constexpr bool RoundTrips(LONGLONG first, LONGLONG last) noexcept {
+    for (LONGLONG days = first; days <= last; ++days) {
+        const Date date = CivilFromDays(days);
+        if (DaysFromCivil(date.year, date.month, date.day) != days) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Leap years
+static_assert(IsLeapYear(2000) && IsLeapYear(2024) && IsLeapYear(1600), "leap years");
+static_assert(!IsLeapYear(1900) && !IsLeapYear(2100) && !IsLeapYear(2023), "common years");
+static_assert(DaysInMonth(2024, 2) == 29 && DaysInMonth(2023, 2) == 28 && DaysInMonth(2100, 2) == 28, "February");
+static_assert(DaysInMonth(2023, 4) == 30 && DaysInMonth(2023, 12) == 31, "month lengths");
+
+// days_from_civil / civil_from_days
+static_assert(DaysFromCivil(1970, 1, 1) == 0, "Unix epoch");
+static_assert(DaysFromCivil(1969, 12, 31) == -1, "day before epoch");
+static_assert(DaysFromCivil(2000, 3, 1) == 11017, "2000-03-01");
+static_assert(DaysFromCivil(1601, 1, 1) == -134774, "FILETIME epoch");
+static_assert(CivilFromDays(19782).year == 2024 && CivilFromDays(19782).month == 2 &&
+              CivilFromDays(19782).day == 29, "2024-02-29");
+static_assert(RoundTrips(-1000, 1000), "round trip around the epoch");
+static_assert(RoundTrips(DaysFromCivil(2099, 12, 1), DaysFromCivil(2101, 3, 31)), "round trip across 2100");
+
+// Weekdays (0 = Sunday)
+static_assert(WeekdayFromDays(0) == 4, "1970-01-01 was a Thursday");
+static_assert(WeekdayFromDays(-1) == 3, "1969-12-31 was a Wednesday");
+static_assert(WeekdayFromDays(DaysFromCivil(1601, 1, 1)) == 1, "1601-01-01 was a Monday");
+static_assert(WeekdayFromDays(DaysFromCivil(2024, 2, 29)) == 4, "2024-02-29 was a Thursday");
+static_assert(NthWeekdayOfMonth(2024, 3, 5, 0) == DaysFromCivil(2024, 3, 31), "last Sunday of March 2024");
+static_assert(NthWeekdayOfMonth(2024, 3, 2, 0) == DaysFromCivil(2024, 3, 10), "second Sunday of March 2024");
+static_assert(NthWeekdayOfMonth(2023, 10, 5, 0) == DaysFromCivil(2023, 10, 29), "last Sunday of October 2023");
+
+// Floor division
+static_assert(FloorDiv(-1, 86400) == -1 && FloorMod(-1, 86400) == 86399, "negative floor");
+static_assert(FloorDiv(86400, 86400) == 1 && FloorMod(86400, 86400) == 0, "positive floor");
+
+// Unix time <-> ticks <-> SYSTEMTIME
+static_assert(UnixSecondsToTicks(0) == 116444736000000000ULL, "Unix epoch in FILETIME ticks");
+static_assert(TicksToUnixSeconds(116444736000000000ULL) == 0, "FILETIME ticks of the Unix epoch");
+static_assert(Ticks(MakeTime(1601, 1, 1)) == 0, "FILETIME epoch");
+static_assert(Ticks(MakeTime(1970, 1, 1)) == 116444736000000000ULL, "Unix epoch");
+static_assert(Ticks(MakeTime(2024, 2, 29, 12, 34, 56, 789)) ==
+              UnixSecondsToTicks(1709210096) + 789ULL * 10000ULL, "SYSTEMTIME -> ticks");
+static_assert(SameDateTime(TicksToSystemTime(Ticks(MakeTime(2024, 2, 29, 12, 34, 56, 789))),
+                           MakeTime(2024, 2, 29, 12, 34, 56, 789)), "ticks -> SYSTEMTIME");
+static_assert(TicksToSystemTime(Ticks(MakeTime(2024, 2, 29))).wDayOfWeek == 4, "wDayOfWeek is filled in");
+static_assert(SystemTimeToUnixSeconds(MakeTime(2038, 1, 19, 3, 14, 8)) == 2147483648LL, "past 2038");
+static_assert(SameDateTime(UnixSecondsToSystemTime(-1), MakeTime(1969, 12, 31, 23, 59, 59)), "before epoch");
+
+// Validation mirrors SystemTimeToFileTime
+static_assert(!IsValid(MakeTime(2023, 2, 29)), "no February 29 in 2023");
+static_assert(!IsValid(MakeTime(2024, 13, 1)) && !IsValid(MakeTime(2024, 1, 0)), "month/day range");
+static_assert(!IsValid(MakeTime(1600, 12, 31)), "before the FILETIME epoch");
+static_assert(!IsValid(MakeTime(2024, 1, 1, 24)), "hour range");
+
+// Calendar arithmetic
+static_assert(SameDateTime(PlusDays(MakeTime(2023, 12, 31, 23, 30), 1), MakeTime(2024, 1, 1, 23, 30)), "year wrap");
+static_assert(SameDateTime(PlusDays(MakeTime(2024, 2, 28), 1), MakeTime(2024, 2, 29)), "leap day");
+static_assert(SameDateTime(PlusDays(MakeTime(2023, 2, 28), 1), MakeTime(2023, 3, 1)), "no leap day");
+static_assert(SameDateTime(PlusDays(MakeTime(2024, 3, 1), -1), MakeTime(2024, 2, 29)), "negative days");
+static_assert(SameDateTime(PlusDays(MakeTime(2000, 1, 1), 36524), MakeTime(2099, 12, 31)), "a century at once");
+static_assert(PlusDays(MakeTime(2024, 2, 28), 1).wDayOfWeek == 4, "AddDays updates wDayOfWeek");
+static_assert(SameDateTime(PlusMinutes(MakeTime(2024, 12, 31, 23, 59), 1), MakeTime(2025, 1, 1, 0, 0)), "minute wrap");
+static_assert(SameDateTime(PlusMinutes(MakeTime(2024, 3, 1, 0, 5), -10), MakeTime(2024, 2, 29, 23, 55)), "negative minutes");
+static_assert(SameDateTime(PlusMinutes(MakeTime(2024, 1, 1, 8, 0), 10080), MakeTime(2024, 1, 8, 8, 0)), "a week of minutes");
+static_assert(DiffDays(MakeTime(2024, 1, 1, 23), MakeTime(2025, 1, 1, 1)) == 366, "DiffDays ignores time of day");
+static_assert(DiffDays(MakeTime(2024, 3, 1), MakeTime(2024, 2, 28)) == -2, "DiffDays is signed");
+
+} // namespace
+} // namespace Civil
+} // namespace Everon
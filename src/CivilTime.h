@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Platform.h"
+
+// constexpr proleptic Gregorian calendar arithmetic (days-from-civil / civil-from-days,
+// after Howard Hinnant's public-domain algorithms). Every operation is O(1), so adding
+// a year costs the same as adding a day. Compile-time checks live in CivilTime.cpp.
+
+namespace Everon {
+namespace Civil {
+
+struct Date {
+    int year = 1970;
+    int month = 1;   // 1..12
+    int day = 1;     // 1..31
+};
+
+constexpr LONGLONG SECONDS_PER_DAY = 86400LL;
+constexpr ULONGLONG TICKS_PER_SEC = 10000000ULL;
+constexpr ULONGLONG TICKS_PER_DAY = 86400ULL * TICKS_PER_SEC;
+
+// Seconds between 1601-01-01 (FILETIME epoch) and 1970-01-01 (Unix epoch).
+constexpr LONGLONG UNIX_EPOCH_DELTA_SEC = 11644473600LL;
+
+constexpr bool IsLeapYear(int year) noexcept {
+    return (year % 4 == 0) && (year % 100 != 0 || year % 400 == 0);
+}
+
+constexpr int DaysInMonth(int year, int month) noexcept {
+    constexpr int kDays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    return (month == 2 && IsLeapYear(year)) ? 29 : kDays[month - 1];
+}
+
+// Days since 1970-01-01 (negative before).
+constexpr LONGLONG DaysFromCivil(int year, int month, int day) noexcept {
+    year -= (month <= 2) ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153U * static_cast<unsigned>(month > 2 ? month - 3 : month + 9) + 2U) / 5U +
+                         static_cast<unsigned>(day) - 1U;
+    const unsigned doe = yoe * 365U + yoe / 4U - yoe / 100U + doy;
+    return static_cast<LONGLONG>(era) * 146097LL + static_cast<LONGLONG>(doe) - 719468LL;
+}
+
+constexpr Date CivilFromDays(LONGLONG days) noexcept {
+    days += 719468;
+    const LONGLONG era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460U + doe / 36524U - doe / 146096U) / 365U;
+    const unsigned doy = doe - (365U * yoe + yoe / 4U - yoe / 100U);
+    const unsigned mp = (5U * doy + 2U) / 153U;
+    Date date;
+    date.day = static_cast<int>(doy - (153U * mp + 2U) / 5U + 1U);
+    date.month = static_cast<int>(mp < 10U ? mp + 3U : mp - 9U);
+    date.year = static_cast<int>(static_cast<LONGLONG>(yoe) + era * 400) + (date.month <= 2 ? 1 : 0);
+    return date;
+}
+
+// 0 = Sunday (matches SYSTEMTIME::wDayOfWeek)
+constexpr int WeekdayFromDays(LONGLONG days) noexcept {
+    return static_cast<int>(days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6);
+}
+
+// The `week`-th (1..4, 5 = last) `weekday` (0 = Sunday) of a month, as days since 1970-01-01.
+constexpr LONGLONG NthWeekdayOfMonth(int year, int month, int week, int weekday) noexcept {
+    const LONGLONG first = DaysFromCivil(year, month, 1);
+    int day = 1 + (weekday - WeekdayFromDays(first) + 7) % 7 + (week - 1) * 7;
+    const int dim = DaysInMonth(year, month);
+    while (day > dim) {
+        day -= 7;
+    }
+    return first + day - 1;
+}
+
+// Floor division helpers (C++ division truncates toward zero).
+constexpr LONGLONG FloorDiv(LONGLONG a, LONGLONG b) noexcept {
+    return (a / b) - ((a % b != 0) && ((a < 0) != (b < 0)) ? 1 : 0);
+}
+
+constexpr LONGLONG FloorMod(LONGLONG a, LONGLONG b) noexcept {
+    return a - FloorDiv(a, b) * b;
+}
+
+// ---------------------------------------------------------------------------
+// Unix time <-> FILETIME ticks
+// ---------------------------------------------------------------------------
+
+constexpr ULONGLONG UnixSecondsToTicks(LONGLONG seconds) noexcept {
+    return static_cast<ULONGLONG>(seconds + UNIX_EPOCH_DELTA_SEC) * TICKS_PER_SEC;
+}
+
+constexpr LONGLONG TicksToUnixSeconds(ULONGLONG ticks) noexcept {
+    return static_cast<LONGLONG>(ticks / TICKS_PER_SEC) - UNIX_EPOCH_DELTA_SEC;
+}
+
+// ---------------------------------------------------------------------------
+// SYSTEMTIME <-> FILETIME ticks / Unix time
+// ---------------------------------------------------------------------------
+
+constexpr bool IsValid(const SYSTEMTIME& st) noexcept {
+    return st.wYear >= 1601 && st.wYear <= 30827 && st.wMonth >= 1 && st.wMonth <= 12 &&
+           st.wDay >= 1 && st.wDay <= DaysInMonth(st.wYear, st.wMonth) &&
+           st.wHour < 24 && st.wMinute < 60 && st.wSecond < 60 && st.wMilliseconds < 1000;
+}
+
+constexpr LONGLONG DaysFromSystemTime(const SYSTEMTIME& st) noexcept {
+    return DaysFromCivil(st.wYear, st.wMonth, st.wDay);
+}
+
+constexpr LONGLONG SecondsOfDay(const SYSTEMTIME& st) noexcept {
+    return static_cast<LONGLONG>(st.wHour) * 3600 + static_cast<LONGLONG>(st.wMinute) * 60 + st.wSecond;
+}
+
+// Like SystemTimeToFileTime: wDayOfWeek is ignored, invalid fields fail.
+constexpr bool SystemTimeToTicks(const SYSTEMTIME& st, ULONGLONG& ticks) noexcept {
+    if (!IsValid(st)) {
+        return false;
+    }
+    const LONGLONG seconds = DaysFromSystemTime(st) * SECONDS_PER_DAY + SecondsOfDay(st);
+    ticks = UnixSecondsToTicks(seconds) + static_cast<ULONGLONG>(st.wMilliseconds) * 10000ULL;
+    return true;
+}
+
+constexpr SYSTEMTIME SystemTimeFromDays(LONGLONG days, LONGLONG secondsOfDay, WORD milliseconds) noexcept {
+    const Date date = CivilFromDays(days);
+    SYSTEMTIME st = {};
+    st.wYear = static_cast<WORD>(date.year);
+    st.wMonth = static_cast<WORD>(date.month);
+    st.wDayOfWeek = static_cast<WORD>(WeekdayFromDays(days));
+    st.wDay = static_cast<WORD>(date.day);
+    st.wHour = static_cast<WORD>(secondsOfDay / 3600);
+    st.wMinute = static_cast<WORD>((secondsOfDay / 60) % 60);
+    st.wSecond = static_cast<WORD>(secondsOfDay % 60);
+    st.wMilliseconds = milliseconds;
+    return st;
+}
+
+// Like FileTimeToSystemTime (including wDayOfWeek).
+constexpr SYSTEMTIME TicksToSystemTime(ULONGLONG ticks) noexcept {
+    const LONGLONG seconds = TicksToUnixSeconds(ticks);
+    const WORD milliseconds = static_cast<WORD>((ticks % TICKS_PER_SEC) / 10000ULL);
+    return SystemTimeFromDays(FloorDiv(seconds, SECONDS_PER_DAY), FloorMod(seconds, SECONDS_PER_DAY), milliseconds);
+}
+
+constexpr LONGLONG SystemTimeToUnixSeconds(const SYSTEMTIME& st) noexcept {
+    return DaysFromSystemTime(st) * SECONDS_PER_DAY + SecondsOfDay(st);
+}
+
+constexpr SYSTEMTIME UnixSecondsToSystemTime(LONGLONG seconds) noexcept {
+    return SystemTimeFromDays(FloorDiv(seconds, SECONDS_PER_DAY), FloorMod(seconds, SECONDS_PER_DAY), 0);
+}
+
+// ---------------------------------------------------------------------------
+// Calendar arithmetic on SYSTEMTIME (time of day is preserved, wDayOfWeek is updated)
+// ---------------------------------------------------------------------------
+
+constexpr void AddDays(SYSTEMTIME& st, LONGLONG days) noexcept {
+    const LONGLONG target = DaysFromSystemTime(st) + days;
+    const Date date = CivilFromDays(target);
+    st.wYear = static_cast<WORD>(date.year);
+    st.wMonth = static_cast<WORD>(date.month);
+    st.wDay = static_cast<WORD>(date.day);
+    st.wDayOfWeek = static_cast<WORD>(WeekdayFromDays(target));
+}
+
+constexpr void AddMinutes(SYSTEMTIME& st, LONGLONG minutes) noexcept {
+    const LONGLONG total = static_cast<LONGLONG>(st.wHour) * 60 + st.wMinute + minutes;
+    AddDays(st, FloorDiv(total, 1440));
+    const LONGLONG minuteOfDay = FloorMod(total, 1440);
+    st.wHour = static_cast<WORD>(minuteOfDay / 60);
+    st.wMinute = static_cast<WORD>(minuteOfDay % 60);
+}
+
+// Whole calendar days from `from` to `to` (dates only).
+constexpr LONGLONG DiffDays(const SYSTEMTIME& from, const SYSTEMTIME& to) noexcept {
+    return DaysFromSystemTime(to) - DaysFromSystemTime(from);
+}
+
+} // namespace Civil
+} // namespace Everon
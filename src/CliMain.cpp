@@ -0,0 +1,201 @@
+// everon run [--display] [--] <command> [args...]
+//
+// Keeps the machine awake (and the display on with --display) for exactly as long as
+// <command> runs, then exits with its status. Made for CI agents and scripted transfers:
+// no window, no settings, and nothing probed beyond the first keep-awake mechanism that
+// works, so wrapping a short command stays cheap.
+//
+// Exit status: the command's own, 128 + N (and the same signal re-raised on Linux) if a
+// signal ended it, 125 for a usage error, 126 if the command could not be executed and
+// 127 if it was not found, as env(1) and timeout(1) report them.
+
+#include "ChildProcess.h"
+#include "PowerManager.h"
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/resource.h>
+#endif
+
+using namespace Everon;
+
+namespace {
+
+constexpr int kExitUsage = 125;
+constexpr int kExitCannotExecute = 126;
+constexpr int kExitNotFound = 127;
+
+ChildProcess* g_child = nullptr;
+
+void PrintUsage() {
+    std::fprintf(stderr,
+                 "usage: everon run [--display] [--] <command> [args...]\n"
+                 "  Keeps the system awake while <command> runs and exits with its status.\n"
+                 "  --display   keep the display on as well\n");
+}
+
+#ifdef _WIN32
+using Char = wchar_t;
+#define EVERON_TEXT(text) L##text
+
+BOOL WINAPI OnConsoleEvent(DWORD event) {
+    // Ctrl+C and Ctrl+Break go to the child too (shared console): let it decide.
+    if (event == CTRL_C_EVENT || event == CTRL_BREAK_EVENT) {
+        return TRUE;
+    }
+    if (g_child) {
+        g_child->Signal(SIGTERM);
+    }
+    return FALSE;
+}
+
+void InstallSignalHandling() {
+    SetConsoleCtrlHandler(OnConsoleEvent, TRUE);
+}
+
+void ReportSpawnError(const std::wstring& command, int error) {
+    std::fwprintf(stderr, L"everon: cannot run %ls (error %d)\n", command.c_str(), error);
+}
+
+int SpawnErrorStatus(int error) {
+    return (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND) ? kExitNotFound : kExitCannotExecute;
+}
+
+void PropagateSignal(int /*signal*/) {
+}
+#else
+using Char = char;
+#define EVERON_TEXT(text) text
+
+void ForwardSignal(int signal) {
+    if (g_child) {
+        g_child->Signal(signal);
+    }
+}
+
+void InstallSignalHandling() {
+    // Like system(): the terminal already sends SIGINT/SIGQUIT to the child (same
+    // process group), so the wrapper just outlives it. Termination requests aimed at
+    // the wrapper alone are passed on.
+    struct sigaction ignore = {};
+    ignore.sa_handler = SIG_IGN;
+    sigaction(SIGINT, &ignore, nullptr);
+    sigaction(SIGQUIT, &ignore, nullptr);
+
+    struct sigaction forward = {};
+    forward.sa_handler = ForwardSignal;
+    sigemptyset(&forward.sa_mask);
+    sigaction(SIGTERM, &forward, nullptr);
+    sigaction(SIGHUP, &forward, nullptr);
+}
+
+void ReportSpawnError(const std::string& command, int error) {
+    std::fprintf(stderr, "everon: cannot run %s: %s\n", command.c_str(), std::strerror(error));
+}
+
+int SpawnErrorStatus(int error) {
+    return (error == ENOENT) ? kExitNotFound : kExitCannotExecute;
+}
+
+// Dies of the child's signal, so the caller sees exactly what a direct run would show.
+void PropagateSignal(int signal) {
+    const rlimit noCore = { 0, 0 };
+    setrlimit(RLIMIT_CORE, &noCore);   // the child already dumped core if it was going to
+    struct sigaction fallback = {};
+    fallback.sa_handler = SIG_DFL;
+    sigaction(signal, &fallback, nullptr);
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, signal);
+    sigprocmask(SIG_UNBLOCK, &mask, nullptr);
+    raise(signal);
+}
+#endif
+
+int Run(const std::vector<std::basic_string<Char>>& args) {
+    bool keepDisplayOn = false;
+    size_t first = 0;
+    for (; first < args.size(); ++first) {
+        if (args[first] == EVERON_TEXT("--display")) {
+            keepDisplayOn = true;
+        } else if (args[first] == EVERON_TEXT("--")) {
+            ++first;
+            break;
+        } else if (!args[first].empty() && args[first][0] == EVERON_TEXT('-')) {
+            PrintUsage();
+            return kExitUsage;
+        } else {
+            break;
+        }
+    }
+    if (first >= args.size()) {
+        PrintUsage();
+        return kExitUsage;
+    }
+
+    // The hold first, so the command never runs unprotected; a machine where nothing
+    // can hold still runs the command.
+    PowerManager power;
+    power.InitializeOnDemand();
+    // A display-only hold still counts as holding: verification keeps retrying the rest.
+    const bool sleepHeld = power.PreventSleep(keepDisplayOn);
+    const bool holding = power.IsPreventingSleep();
+    if (!holding) {
+        std::fprintf(stderr, "everon: no keep-awake mechanism works here; running unprotected\n");
+    } else if (!sleepHeld) {
+        std::fprintf(stderr, "everon: only the display is kept on; nothing here inhibits system sleep\n");
+    }
+
+    ChildProcess child;
+    g_child = &child;
+    InstallSignalHandling();
+    if (!child.Spawn(std::vector<ChildProcess::String>(args.begin() + static_cast<std::ptrdiff_t>(first), args.end()))) {
+        ReportSpawnError(args[first], child.GetError());
+        return SpawnErrorStatus(child.GetError());
+    }
+
+    // Asleep until the child exits, waking only to check the hold is still honoured
+    // (backing off to hourly while it is).
+    ULONGLONG verifyAt = Platform::GetMonotonicTicks() + power.GetVerifyInterval();
+    for (;;) {
+        DWORD timeoutMs = INFINITE;
+        if (holding) {
+            const ULONGLONG now = Platform::GetMonotonicTicks();
+            if (now >= verifyAt) {
+                power.Verify();
+                verifyAt = now + power.GetVerifyInterval();
+            }
+            timeoutMs = static_cast<DWORD>((verifyAt - now) / 10000ULL + 1);
+        }
+        if (child.Wait(timeoutMs)) {
+            break;
+        }
+    }
+    g_child = nullptr;
+
+    power.AllowSleep();
+    if (child.GetTermSignal() != 0) {
+        PropagateSignal(child.GetTermSignal());
+    }
+    return child.GetExitStatus();
+}
+
+} // namespace
+
+#ifdef _WIN32
+int wmain(int argc, wchar_t** argv) {
+#else
+int main(int argc, char** argv) {
+#endif
+    std::vector<std::basic_string<Char>> args(argv + 1, argv + argc);
+    if (args.empty() || args[0] != EVERON_TEXT("run")) {
+        PrintUsage();
+        return kExitUsage;
+    }
+    args.erase(args.begin());
+    return Run(args);
+}
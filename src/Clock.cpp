@@ -0,0 +1,47 @@
+#include "Clock.h"
+
+namespace Everon {
+
+void Clock::NowLocal(SYSTEMTIME& out) const noexcept {
+    if (!GetTimeZone()->ToLocal(NowUtc(), out)) {
+        out = {};
+    }
+}
+
+SystemClock& SystemClock::Instance() {
+    static SystemClock instance;
+    return instance;
+}
+
+ULONGLONG SystemClock::NowUtc() const noexcept {
+    return Platform::GetSystemTimeUtc();
+}
+
+ULONGLONG SystemClock::NowMonotonic() const noexcept {
+    return Platform::GetMonotonicTicks();
+}
+
+std::shared_ptr<const TimeZone> SystemClock::GetTimeZone() const noexcept {
+    return TimeZone::Current();
+}
+
+VirtualClock::VirtualClock(ULONGLONG startUtc, std::shared_ptr<const TimeZone> zone) noexcept
+    : m_utc(startUtc)
+    , m_monotonic(TICKS_PER_SEC) // arbitrary non-zero origin, like time since boot
+    , m_zone(zone ? std::move(zone) : TimeZone::Utc()) {
+}
+
+void VirtualClock::Advance(ULONGLONG ticks) noexcept {
+    m_utc += ticks;
+    m_monotonic += ticks;
+}
+
+void VirtualClock::StepWall(LONGLONG deltaTicks) noexcept {
+    m_utc = static_cast<ULONGLONG>(static_cast<LONGLONG>(m_utc) + deltaTicks);
+}
+
+void VirtualClock::SetTimeZone(std::shared_ptr<const TimeZone> zone) noexcept {
+    m_zone = zone ? std::move(zone) : TimeZone::Utc();
+}
+
+} // namespace Everon
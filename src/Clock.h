@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Platform.h"
+#include "TimeZone.h"
+#include <memory>
+
+namespace Everon {
+
+// Which of the Clock time lines a tick value belongs to.
+enum class ClockBase {
+    Wall,       // Clock::NowUtc()
+    Monotonic   // Clock::NowMonotonic()
+};
+
+// Time source for the timer logic. All tick values are 100 ns units:
+// wall time is FILETIME (UTC, since 1601-01-01), monotonic time has an unspecified origin.
+class Clock {
+public:
+    virtual ~Clock() = default;
+
+    // Wall clock (UTC). May jump (NTP step, manual change).
+    virtual ULONGLONG NowUtc() const noexcept = 0;
+
+    // Suspend-aware monotonic clock. Never jumps.
+    virtual ULONGLONG NowMonotonic() const noexcept = 0;
+
+    // Time zone that defines local calendar time.
+    virtual std::shared_ptr<const TimeZone> GetTimeZone() const noexcept = 0;
+
+    // Current local calendar time.
+    void NowLocal(SYSTEMTIME& out) const noexcept;
+
+    static constexpr ULONGLONG TICKS_PER_MS = 10000ULL;
+    static constexpr ULONGLONG TICKS_PER_SEC = 10000000ULL;
+    static constexpr ULONGLONG TICKS_PER_MIN = 60ULL * TICKS_PER_SEC;
+};
+
+// Real OS clocks (Platform layer) and the system time zone.
+class SystemClock final : public Clock {
+public:
+    static SystemClock& Instance();
+
+    ULONGLONG NowUtc() const noexcept override;
+    ULONGLONG NowMonotonic() const noexcept override;
+    std::shared_ptr<const TimeZone> GetTimeZone() const noexcept override;
+
+private:
+    SystemClock() = default;
+};
+
+// Programmatically driven clock for benchmarks and replaying clock scenarios.
+// Wall and monotonic time advance together; wall time can additionally be stepped
+// and the time zone swapped to model clock jumps and zone changes.
+class VirtualClock final : public Clock {
+public:
+    explicit VirtualClock(ULONGLONG startUtc,
+                          std::shared_ptr<const TimeZone> zone = TimeZone::Utc()) noexcept;
+
+    ULONGLONG NowUtc() const noexcept override { return m_utc; }
+    ULONGLONG NowMonotonic() const noexcept override { return m_monotonic; }
+    std::shared_ptr<const TimeZone> GetTimeZone() const noexcept override { return m_zone; }
+
+    // Elapses real time: both wall and monotonic clocks move forward.
+    void Advance(ULONGLONG ticks) noexcept;
+    void AdvanceMs(ULONGLONG milliseconds) noexcept { Advance(milliseconds * TICKS_PER_MS); }
+
+    // Steps the wall clock only (NTP correction, manual change). Monotonic time is unaffected.
+    void StepWall(LONGLONG deltaTicks) noexcept;
+
+    // Replaces the time zone (user changed zone, tzdata update).
+    void SetTimeZone(std::shared_ptr<const TimeZone> zone) noexcept;
+
+private:
+    ULONGLONG m_utc = 0;
+    ULONGLONG m_monotonic = 0;
+    std::shared_ptr<const TimeZone> m_zone;
+};
+
+} // namespace Everon
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Platform.h"
+
+namespace Everon {
+
+// Reports wall-clock steps and resume-from-suspend as they happen, so deadlines can be
+// re-armed immediately instead of on the next scheduled tick.
+// Linux: a CLOCK_REALTIME timerfd armed with TFD_TIMER_CANCEL_ON_SET becomes readable
+// whenever the kernel signals a discontinuous realtime change (settimeofday, NTP step,
+// resume); resume is told apart by CLOCK_BOOTTIME gaining on CLOCK_MONOTONIC.
+// Windows delivers the same events as WM_TIMECHANGE / WM_POWERBROADCAST (see App).
+class ClockChangeMonitor {
+public:
+    enum Event : unsigned {
+        None = 0,
+        WallClockSet = 1 << 0,  // Realtime clock stepped (manual change, NTP, RTC sync)
+        Resumed = 1 << 1        // System came back from suspend/hibernate
+    };
+
+    ClockChangeMonitor() = default;
+    ~ClockChangeMonitor();
+
+    ClockChangeMonitor(const ClockChangeMonitor&) = delete;
+    ClockChangeMonitor& operator=(const ClockChangeMonitor&) = delete;
+
+    bool Start();
+    void Stop();
+
+    // Descriptor to poll for readability, -1 when not started.
+    int GetFd() const noexcept { return m_fd; }
+
+    // Call when GetFd() is readable. Returns a mask of Event values and re-arms.
+    unsigned Consume();
+
+private:
+    bool Arm();
+
+    int m_fd = -1;
+    ULONGLONG m_suspendedTicks = 0; // CLOCK_BOOTTIME - CLOCK_MONOTONIC at last check
+};
+
+} // namespace Everon
@@ -0,0 +1,95 @@
+#include "ClockChangeMonitor.h"
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace Everon {
+
+namespace {
+
+// Suspends shorter than this are indistinguishable from scheduling noise.
+constexpr ULONGLONG kResumeThresholdTicks = 10000000ULL; // 1 s
+
+ULONGLONG ReadTicks(clockid_t id) noexcept {
+    timespec ts = {};
+    clock_gettime(id, &ts);
+    return static_cast<ULONGLONG>(ts.tv_sec) * 10000000ULL + static_cast<ULONGLONG>(ts.tv_nsec) / 100ULL;
+}
+
+// Time spent suspended since boot.
+ULONGLONG SuspendedTicks() noexcept {
+    const ULONGLONG monotonic = ReadTicks(CLOCK_MONOTONIC);
+    const ULONGLONG boottime = ReadTicks(CLOCK_BOOTTIME);
+    return boottime > monotonic ? boottime - monotonic : 0;
+}
+
+} // namespace
+
+ClockChangeMonitor::~ClockChangeMonitor() {
+    Stop();
+}
+
+bool ClockChangeMonitor::Start() {
+    if (m_fd >= 0) {
+        return true;
+    }
+
+    m_fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_fd < 0) {
+        Utils::DebugLog(L"[Everon] timerfd_create failed (errno %d)\n", errno);
+        return false;
+    }
+
+    m_suspendedTicks = SuspendedTicks();
+    if (!Arm()) {
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+void ClockChangeMonitor::Stop() {
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool ClockChangeMonitor::Arm() {
+    // An absolute expiry that never arrives; only the cancel-on-set path fires.
+    itimerspec spec = {};
+    spec.it_value.tv_sec = static_cast<time_t>(INT32_MAX);
+    if (timerfd_settime(m_fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &spec, nullptr) != 0) {
+        Utils::DebugLog(L"[Everon] timerfd_settime failed (errno %d)\n", errno);
+        return false;
+    }
+    return true;
+}
+
+unsigned ClockChangeMonitor::Consume() {
+    if (m_fd < 0) {
+        return None;
+    }
+
+    unsigned events = None;
+    uint64_t expirations = 0;
+    if (read(m_fd, &expirations, sizeof(expirations)) < 0 && errno == ECANCELED) {
+        events |= WallClockSet;
+    }
+
+    const ULONGLONG suspended = SuspendedTicks();
+    if (suspended >= m_suspendedTicks + kResumeThresholdTicks) {
+        events |= Resumed;
+    }
+    m_suspendedTicks = suspended;
+
+    // A cancelled timerfd stays cancelled until it is re-armed.
+    if (events & WallClockSet) {
+        Arm();
+    }
+    return events;
+}
+
+} // namespace Everon
@@ -0,0 +1,823 @@
+#include "DBusConnection.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+namespace Everon {
+
+namespace {
+
+constexpr size_t kMaxMessageSize = 128U * 1024U * 1024U;   // the spec's limit
+constexpr size_t kMaxFdsPerRead = 16;
+
+enum HeaderField : BYTE {
+    FieldPath = 1,
+    FieldInterface = 2,
+    FieldMember = 3,
+    FieldErrorName = 4,
+    FieldReplySerial = 5,
+    FieldDestination = 6,
+    FieldSender = 7,
+    FieldSignature = 8,
+    FieldUnixFds = 9
+};
+
+size_t AlignUp(size_t value, size_t alignment) noexcept {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint32_t Load32(const BYTE* p, bool bigEndian) noexcept {
+    return bigEndian
+        ? (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+          (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3])
+        : (static_cast<uint32_t>(p[3]) << 24) | (static_cast<uint32_t>(p[2]) << 16) |
+          (static_cast<uint32_t>(p[1]) << 8) | static_cast<uint32_t>(p[0]);
+}
+
+void Store32(std::vector<BYTE>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<BYTE>(value >> (8 * i)));
+    }
+}
+
+void PadTo(std::vector<BYTE>& out, size_t alignment) {
+    out.resize(AlignUp(out.size(), alignment), 0);
+}
+
+// Writes "s"/"o" (32-bit length) or "g" (8-bit length) string data.
+void StoreString(std::vector<BYTE>& out, const std::string& value, bool shortLength) {
+    if (shortLength) {
+        out.push_back(static_cast<BYTE>(value.size()));
+    } else {
+        PadTo(out, 4);
+        Store32(out, static_cast<uint32_t>(value.size()));
+    }
+    out.insert(out.end(), value.begin(), value.end());
+    out.push_back(0);
+}
+
+// Decodes %XX escapes in an address value.
+std::string Unescape(const std::string& value) {
+    std::string out;
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '%' && i + 2 < value.size()) {
+            out.push_back(static_cast<char>(std::strtol(value.substr(i + 1, 2).c_str(), nullptr, 16)));
+            i += 2;
+        } else {
+            out.push_back(value[i]);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// DBusMessage
+// ---------------------------------------------------------------------------
+
+DBusMessage::~DBusMessage() {
+    CloseFds();
+}
+
+DBusMessage::DBusMessage(DBusMessage&& other) noexcept {
+    *this = std::move(other);
+}
+
+DBusMessage& DBusMessage::operator=(DBusMessage&& other) noexcept {
+    if (this != &other) {
+        CloseFds();
+        m_type = other.m_type;
+        m_destination = std::move(other.m_destination);
+        m_path = std::move(other.m_path);
+        m_interface = std::move(other.m_interface);
+        m_member = std::move(other.m_member);
+        m_errorName = std::move(other.m_errorName);
+        m_sender = std::move(other.m_sender);
+        m_serial = other.m_serial;
+        m_replySerial = other.m_replySerial;
+        m_unixFds = other.m_unixFds;
+        m_signature = std::move(other.m_signature);
+        m_body = std::move(other.m_body);
+        m_fds = std::move(other.m_fds);
+        m_bigEndian = other.m_bigEndian;
+        m_readPos = other.m_readPos;
+        m_signaturePos = other.m_signaturePos;
+        m_variantType = other.m_variantType;
+        m_inVariant = other.m_inVariant;
+        other.m_fds.clear();
+        other.m_type = Invalid;
+    }
+    return *this;
+}
+
+void DBusMessage::CloseFds() noexcept {
+    for (int fd : m_fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    m_fds.clear();
+}
+
+DBusMessage DBusMessage::CreateMethodCall(const std::string& destination, const std::string& path,
+                                          const std::string& interface, const std::string& member) {
+    DBusMessage message;
+    message.m_type = MethodCall;
+    message.m_destination = destination;
+    message.m_path = path;
+    message.m_interface = interface;
+    message.m_member = member;
+    return message;
+}
+
+DBusMessage DBusMessage::CreateSignal(const std::string& path, const std::string& interface,
+                                      const std::string& member) {
+    DBusMessage message;
+    message.m_type = Signal;
+    message.m_path = path;
+    message.m_interface = interface;
+    message.m_member = member;
+    return message;
+}
+
+DBusMessage DBusMessage::CreateMethodReturn(const DBusMessage& call) {
+    DBusMessage message;
+    message.m_type = MethodReturn;
+    message.m_destination = call.m_sender;
+    message.m_replySerial = call.m_serial;
+    return message;
+}
+
+DBusMessage DBusMessage::CreateError(const DBusMessage& call, const std::string& errorName) {
+    DBusMessage message = CreateMethodReturn(call);
+    message.m_type = Error;
+    message.m_errorName = errorName;
+    return message;
+}
+
+void DBusMessage::Pad(size_t alignment) {
+    PadTo(m_body, alignment);
+}
+
+void DBusMessage::AddCode(char code) {
+    if (m_inVariant) {
+        m_inVariant = false;
+    } else {
+        m_signature.push_back(code);
+    }
+}
+
+void DBusMessage::AppendString(const std::string& value) {
+    StoreString(m_body, value, false);
+    AddCode('s');
+}
+
+void DBusMessage::AppendObjectPath(const std::string& value) {
+    StoreString(m_body, value, false);
+    AddCode('o');
+}
+
+void DBusMessage::AppendBool(bool value) {
+    Pad(4);
+    Store32(m_body, value ? 1U : 0U);
+    AddCode('b');
+}
+
+void DBusMessage::AppendUint32(uint32_t value) {
+    Pad(4);
+    Store32(m_body, value);
+    AddCode('u');
+}
+
+void DBusMessage::AppendUint64(uint64_t value) {
+    Pad(8);
+    Store32(m_body, static_cast<uint32_t>(value));
+    Store32(m_body, static_cast<uint32_t>(value >> 32));
+    AddCode('t');
+}
+
+bool DBusMessage::AppendUnixFd(int fd) {
+    const int copy = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (copy < 0) {
+        return false;
+    }
+    Pad(4);
+    Store32(m_body, static_cast<uint32_t>(m_fds.size()));
+    m_fds.push_back(copy);
+    AddCode('h');
+    return true;
+}
+
+void DBusMessage::AppendEmptyArray(const std::string& elementSignature) {
+    Pad(4);
+    Store32(m_body, 0);
+    // The (absent) first element's alignment padding still follows the length.
+    const char first = elementSignature.empty() ? 'y' : elementSignature[0];
+    size_t alignment = 1;
+    if (std::strchr("{(txd", first)) {
+        alignment = 8;
+    } else if (std::strchr("soiubha", first)) {
+        alignment = 4;
+    } else if (std::strchr("nq", first)) {
+        alignment = 2;
+    }
+    Pad(alignment);
+    AddCode('a');
+    m_signature += elementSignature;
+}
+
+void DBusMessage::AppendVariant(char type) {
+    AddCode('v');
+    StoreString(m_body, std::string(1, type), true);
+    m_inVariant = true;
+}
+
+bool DBusMessage::Expect(char code) {
+    if (m_variantType != 0) {
+        const bool ok = (m_variantType == code);
+        m_variantType = 0;
+        return ok;
+    }
+    if (m_signaturePos >= m_signature.size() || m_signature[m_signaturePos] != code) {
+        return false;
+    }
+    ++m_signaturePos;
+    return true;
+}
+
+bool DBusMessage::Align(size_t alignment) {
+    const size_t pos = AlignUp(m_readPos, alignment);
+    if (pos > m_body.size()) {
+        return false;
+    }
+    m_readPos = pos;
+    return true;
+}
+
+bool DBusMessage::Read32(uint32_t& value) {
+    if (!Align(4) || m_readPos + 4 > m_body.size()) {
+        return false;
+    }
+    value = Load32(&m_body[m_readPos], m_bigEndian);
+    m_readPos += 4;
+    return true;
+}
+
+bool DBusMessage::Read64(uint64_t& value) {
+    if (!Align(8) || m_readPos + 8 > m_body.size()) {
+        return false;
+    }
+    const uint64_t first = Load32(&m_body[m_readPos], m_bigEndian);
+    const uint64_t second = Load32(&m_body[m_readPos + 4], m_bigEndian);
+    value = m_bigEndian ? (first << 32) | second : (second << 32) | first;
+    m_readPos += 8;
+    return true;
+}
+
+bool DBusMessage::ReadStringData(std::string& value, bool shortLength) {
+    uint32_t length = 0;
+    if (shortLength) {
+        if (m_readPos >= m_body.size()) {
+            return false;
+        }
+        length = m_body[m_readPos++];
+    } else if (!Read32(length)) {
+        return false;
+    }
+    if (m_readPos + length + 1 > m_body.size()) {
+        return false;
+    }
+    value.assign(reinterpret_cast<const char*>(&m_body[m_readPos]), length);
+    m_readPos += length + 1;
+    return true;
+}
+
+bool DBusMessage::ReadString(std::string& value) {
+    return Expect('s') && ReadStringData(value, false);
+}
+
+bool DBusMessage::ReadObjectPath(std::string& value) {
+    return Expect('o') && ReadStringData(value, false);
+}
+
+bool DBusMessage::ReadBool(bool& value) {
+    uint32_t raw = 0;
+    if (!Expect('b') || !Read32(raw)) {
+        return false;
+    }
+    value = (raw != 0);
+    return true;
+}
+
+bool DBusMessage::ReadUint32(uint32_t& value) {
+    return Expect('u') && Read32(value);
+}
+
+bool DBusMessage::ReadUint64(uint64_t& value) {
+    return Expect('t') && Read64(value);
+}
+
+bool DBusMessage::ReadUnixFd(int& fd) {
+    uint32_t index = 0;
+    if (!Expect('h') || !Read32(index) || index >= m_fds.size() || m_fds[index] < 0) {
+        return false;
+    }
+    fd = m_fds[index];
+    m_fds[index] = -1;
+    return true;
+}
+
+bool DBusMessage::ReadVariant(char& type) {
+    std::string signature;
+    if (!Expect('v') || !ReadStringData(signature, true) || signature.size() != 1) {
+        return false;
+    }
+    type = signature[0];
+    m_variantType = type;
+    return true;
+}
+
+std::vector<BYTE> DBusMessage::Serialize(uint32_t serial) const {
+    std::vector<BYTE> out;
+    out.push_back('l');
+    out.push_back(m_type);
+    out.push_back(0);   // flags
+    out.push_back(1);   // protocol version
+    Store32(out, static_cast<uint32_t>(m_body.size()));
+    Store32(out, serial);
+    Store32(out, 0);    // header field array length, patched below
+
+    auto Field = [&out](BYTE code, char type, const std::string& value) {
+        PadTo(out, 8);
+        out.push_back(code);
+        out.push_back(1);
+        out.push_back(static_cast<BYTE>(type));
+        out.push_back(0);
+        StoreString(out, value, type == 'g');
+    };
+    auto NumberField = [&out](BYTE code, uint32_t value) {
+        PadTo(out, 8);
+        out.push_back(code);
+        out.push_back(1);
+        out.push_back('u');
+        out.push_back(0);
+        Store32(out, value);
+    };
+    if (!m_path.empty()) {
+        Field(FieldPath, 'o', m_path);
+    }
+    if (!m_interface.empty()) {
+        Field(FieldInterface, 's', m_interface);
+    }
+    if (!m_member.empty()) {
+        Field(FieldMember, 's', m_member);
+    }
+    if (!m_errorName.empty()) {
+        Field(FieldErrorName, 's', m_errorName);
+    }
+    if (m_replySerial != 0) {
+        NumberField(FieldReplySerial, m_replySerial);
+    }
+    if (!m_destination.empty()) {
+        Field(FieldDestination, 's', m_destination);
+    }
+    if (!m_signature.empty()) {
+        Field(FieldSignature, 'g', m_signature);
+    }
+    if (!m_fds.empty()) {
+        NumberField(FieldUnixFds, static_cast<uint32_t>(m_fds.size()));
+    }
+
+    const uint32_t fieldsLength = static_cast<uint32_t>(out.size() - 16);
+    for (int i = 0; i < 4; ++i) {
+        out[12 + i] = static_cast<BYTE>(fieldsLength >> (8 * i));
+    }
+    PadTo(out, 8);
+    out.insert(out.end(), m_body.begin(), m_body.end());
+    return out;
+}
+
+bool DBusMessage::Parse(const BYTE* data, size_t size, DBusMessage& out, size_t& consumed) {
+    consumed = 0;
+    if (size < 16) {
+        return true;
+    }
+    if ((data[0] != 'l' && data[0] != 'B') || data[3] != 1) {
+        return false;
+    }
+    const bool bigEndian = (data[0] == 'B');
+    const size_t bodyLength = Load32(data + 4, bigEndian);
+    const size_t fieldsLength = Load32(data + 12, bigEndian);
+    if (bodyLength > kMaxMessageSize || fieldsLength > kMaxMessageSize) {
+        return false;
+    }
+    const size_t fieldsEnd = 16 + fieldsLength;
+    const size_t bodyStart = AlignUp(fieldsEnd, 8);
+    const size_t total = bodyStart + bodyLength;
+    if (size < total) {
+        return true;
+    }
+
+    DBusMessage message;
+    message.m_type = static_cast<Type>(data[1]);
+    message.m_serial = Load32(data + 8, bigEndian);
+    message.m_bigEndian = bigEndian;
+
+    size_t pos = 16;
+    while (true) {
+        pos = AlignUp(pos, 8);
+        if (pos >= fieldsEnd) {
+            break;
+        }
+        if (pos + 4 > fieldsEnd || data[pos + 1] != 1 || data[pos + 3] != 0) {
+            return false;
+        }
+        const BYTE code = data[pos];
+        const char type = static_cast<char>(data[pos + 2]);
+        pos += 4;
+
+        std::string text;
+        uint32_t number = 0;
+        if (type == 's' || type == 'o' || type == 'g') {
+            size_t length = 0;
+            if (type == 'g') {
+                length = data[pos++];
+            } else {
+                pos = AlignUp(pos, 4);
+                if (pos + 4 > fieldsEnd) {
+                    return false;
+                }
+                length = Load32(data + pos, bigEndian);
+                pos += 4;
+            }
+            if (pos + length + 1 > fieldsEnd) {
+                return false;
+            }
+            text.assign(reinterpret_cast<const char*>(data + pos), length);
+            pos += length + 1;
+        } else if (type == 'u') {
+            pos = AlignUp(pos, 4);
+            if (pos + 4 > fieldsEnd) {
+                return false;
+            }
+            number = Load32(data + pos, bigEndian);
+            pos += 4;
+        } else {
+            return false;
+        }
+
+        switch (code) {
+            case FieldPath:        message.m_path = text; break;
+            case FieldInterface:   message.m_interface = text; break;
+            case FieldMember:      message.m_member = text; break;
+            case FieldErrorName:   message.m_errorName = text; break;
+            case FieldReplySerial: message.m_replySerial = number; break;
+            case FieldSender:      message.m_sender = text; break;
+            case FieldSignature:   message.m_signature = text; break;
+            case FieldUnixFds:     message.m_unixFds = number; break;
+            default:               break;
+        }
+    }
+
+    message.m_body.assign(data + bodyStart, data + total);
+    out = std::move(message);
+    consumed = total;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// DBusConnection
+// ---------------------------------------------------------------------------
+
+std::string DBusConnection::SystemBusAddress() {
+    const char* address = std::getenv("DBUS_SYSTEM_BUS_ADDRESS");
+    return (address && *address) ? address : "unix:path=/run/dbus/system_bus_socket";
+}
+
+std::string DBusConnection::SessionBusAddress() {
+    const char* address = std::getenv("DBUS_SESSION_BUS_ADDRESS");
+    if (address && *address) {
+        return address;
+    }
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    return (runtime && *runtime) ? std::string("unix:path=") + runtime + "/bus" : std::string();
+}
+
+DBusConnection::~DBusConnection() {
+    Close();
+}
+
+void DBusConnection::Close() {
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    for (int fd : m_inFds) {
+        close(fd);
+    }
+    m_inFds.clear();
+    m_in.clear();
+    m_signals.clear();
+    m_uniqueName.clear();
+}
+
+bool DBusConnection::Connect(const std::string& address) {
+    Close();
+
+    // First "unix:" entry with a path or abstract name.
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    socklen_t addrLength = 0;
+    size_t start = 0;
+    while (start <= address.size() && addrLength == 0) {
+        const size_t end = (std::min)(address.find(';', start), address.size());
+        const std::string entry = address.substr(start, end - start);
+        start = end + 1;
+        if (entry.compare(0, 5, "unix:") != 0) {
+            continue;
+        }
+
+        size_t keyStart = 5;
+        while (keyStart < entry.size()) {
+            const size_t keyEnd = (std::min)(entry.find(',', keyStart), entry.size());
+            const std::string pair = entry.substr(keyStart, keyEnd - keyStart);
+            keyStart = keyEnd + 1;
+            const bool isPath = pair.compare(0, 5, "path=") == 0;
+            const bool isAbstract = pair.compare(0, 9, "abstract=") == 0;
+            if (!isPath && !isAbstract) {
+                continue;
+            }
+            const std::string name = Unescape(pair.substr(isPath ? 5 : 9));
+            const size_t offset = isPath ? 0 : 1;   // abstract names start with a NUL byte
+            if (name.empty() || name.size() + offset >= sizeof(addr.sun_path)) {
+                continue;
+            }
+            std::memcpy(addr.sun_path + offset, name.data(), name.size());
+            addrLength = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + offset + name.size() + (isPath ? 1 : 0));
+            break;
+        }
+    }
+    if (addrLength == 0) {
+        Utils::DebugLog(L"[Everon] Unsupported D-Bus address '%s'\n", address.c_str());
+        return false;
+    }
+
+    m_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_fd < 0) {
+        return false;
+    }
+    if (connect(m_fd, reinterpret_cast<const sockaddr*>(&addr), addrLength) != 0) {
+        Utils::DebugLog(L"[Everon] D-Bus connect to '%s' failed (errno %d)\n", address.c_str(), errno);
+        Close();
+        return false;
+    }
+
+    static constexpr int kSetupTimeoutMs = 5000;
+    if (!Authenticate(kSetupTimeoutMs)) {
+        Utils::DebugLog(L"[Everon] D-Bus authentication failed\n");
+        Close();
+        return false;
+    }
+
+    DBusMessage hello = DBusMessage::CreateMethodCall("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                                      "org.freedesktop.DBus", "Hello");
+    DBusMessage reply;
+    if (!Call(hello, reply, kSetupTimeoutMs) || !reply.ReadString(m_uniqueName)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool DBusConnection::Authenticate(int timeoutMs) {
+    // SASL EXTERNAL: the server checks our uid via SO_PEERCRED; the uid is sent hex-encoded.
+    char uid[32] = {};
+    std::snprintf(uid, sizeof(uid), "%lu", static_cast<unsigned long>(getuid()));
+    std::string command("\0AUTH EXTERNAL ", 15);
+    for (const char* p = uid; *p; ++p) {
+        char hex[3] = {};
+        std::snprintf(hex, sizeof(hex), "%02x", static_cast<unsigned>(static_cast<unsigned char>(*p)));
+        command += hex;
+    }
+    command += "\r\n";
+
+    std::string line;
+    if (!SendAll(command.data(), command.size()) || !ReadLine(line, timeoutMs) || line.compare(0, 3, "OK ") != 0) {
+        return false;
+    }
+
+    // Descriptor passing is needed for logind inhibitor locks; tolerated if refused.
+    static const char kNegotiate[] = "NEGOTIATE_UNIX_FD\r\n";
+    if (!SendAll(kNegotiate, sizeof(kNegotiate) - 1) || !ReadLine(line, timeoutMs)) {
+        return false;
+    }
+
+    static const char kBegin[] = "BEGIN\r\n";
+    return SendAll(kBegin, sizeof(kBegin) - 1);
+}
+
+bool DBusConnection::SendAll(const void* data, size_t size, const std::vector<int>& fds) {
+    const char* p = static_cast<const char*>(data);
+    bool fdsSent = fds.empty();
+    while (size > 0) {
+        iovec iov = { const_cast<char*>(p), size };
+        msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        // Descriptors travel with the first byte of the message.
+        std::vector<char> control;
+        if (!fdsSent) {
+            control.resize(CMSG_SPACE(sizeof(int) * fds.size()));
+            msg.msg_control = control.data();
+            msg.msg_controllen = control.size();
+            cmsghdr* c = CMSG_FIRSTHDR(&msg);
+            c->cmsg_level = SOL_SOCKET;
+            c->cmsg_type = SCM_RIGHTS;
+            c->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+            std::memcpy(CMSG_DATA(c), fds.data(), sizeof(int) * fds.size());
+        }
+
+        const ssize_t sent = sendmsg(m_fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        fdsSent = true;
+        p += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool DBusConnection::Receive(int timeoutMs) {
+    pollfd pfd = { m_fd, POLLIN, 0 };
+    const int ready = poll(&pfd, 1, timeoutMs);
+    if (ready <= 0) {
+        return false;
+    }
+
+    BYTE buffer[4096];
+    iovec iov = { buffer, sizeof(buffer) };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxFdsPerRead)];
+    msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received = 0;
+    do {
+        received = recvmsg(m_fd, &msg, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+    if (received <= 0) {
+        return false;
+    }
+
+    for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+        if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+            const size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const int* fds = reinterpret_cast<const int*>(CMSG_DATA(c));
+            m_inFds.insert(m_inFds.end(), fds, fds + count);
+        }
+    }
+    m_in.insert(m_in.end(), buffer, buffer + received);
+    return true;
+}
+
+bool DBusConnection::ReadLine(std::string& line, int timeoutMs) {
+    for (;;) {
+        for (size_t i = 0; i + 1 < m_in.size(); ++i) {
+            if (m_in[i] == '\r' && m_in[i + 1] == '\n') {
+                line.assign(m_in.begin(), m_in.begin() + static_cast<std::ptrdiff_t>(i));
+                m_in.erase(m_in.begin(), m_in.begin() + static_cast<std::ptrdiff_t>(i + 2));
+                return true;
+            }
+        }
+        if (!Receive(timeoutMs)) {
+            return false;
+        }
+    }
+}
+
+bool DBusConnection::Send(const DBusMessage& message, uint32_t* serial) {
+    if (m_fd < 0) {
+        return false;
+    }
+
+    const uint32_t next = ++m_serial;
+    const std::vector<BYTE> bytes = message.Serialize(next);
+    if (!SendAll(bytes.data(), bytes.size(), message.m_fds)) {
+        Close();
+        return false;
+    }
+    if (serial) {
+        *serial = next;
+    }
+    return true;
+}
+
+bool DBusConnection::ReadMessage(DBusMessage& message, int timeoutMs) {
+    if (!m_signals.empty()) {
+        message = std::move(m_signals.front());
+        m_signals.pop_front();
+        return true;
+    }
+    return ReadNext(message, timeoutMs);
+}
+
+bool DBusConnection::ReadNext(DBusMessage& message, int timeoutMs) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        if (m_fd < 0) {
+            return false;
+        }
+
+        size_t consumed = 0;
+        if (!DBusMessage::Parse(m_in.data(), m_in.size(), message, consumed)) {
+            Utils::DebugLog(L"[Everon] Malformed D-Bus message\n");
+            Close();
+            return false;
+        }
+
+        if (consumed != 0) {
+            m_in.erase(m_in.begin(), m_in.begin() + static_cast<std::ptrdiff_t>(consumed));
+            const size_t fdCount = (std::min)(static_cast<size_t>(message.m_unixFds), m_inFds.size());
+            message.m_fds.assign(m_inFds.begin(), m_inFds.begin() + static_cast<std::ptrdiff_t>(fdCount));
+            m_inFds.erase(m_inFds.begin(), m_inFds.begin() + static_cast<std::ptrdiff_t>(fdCount));
+            return true;
+        }
+
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left < 0 || !Receive(static_cast<int>(left))) {
+            return false;
+        }
+    }
+}
+
+bool DBusConnection::Call(DBusMessage& call, DBusMessage& reply, int timeoutMs) {
+    uint32_t serial = 0;
+    if (!Send(call, &serial)) {
+        return false;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        DBusMessage message;
+        if (left < 0 || !ReadNext(message, static_cast<int>(left))) {
+            return false;
+        }
+
+        // Signals are kept for ReadMessage(); replies to other calls are not ours.
+        if (message.GetType() == DBusMessage::Signal) {
+            m_signals.push_back(std::move(message));
+            continue;
+        }
+        if ((message.GetType() == DBusMessage::MethodReturn || message.GetType() == DBusMessage::Error) &&
+            message.GetReplySerial() == serial) {
+            const bool ok = (message.GetType() == DBusMessage::MethodReturn);
+            if (!ok) {
+                Utils::DebugLog(L"[Everon] D-Bus call %s failed: %s\n",
+                                call.m_member.c_str(), message.GetErrorName().c_str());
+            }
+            reply = std::move(message);
+            return ok;
+        }
+    }
+}
+
+bool DBusConnection::AddMatch(const std::string& rule) {
+    DBusMessage call = DBusMessage::CreateMethodCall("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                                     "org.freedesktop.DBus", "AddMatch");
+    call.AppendString(rule);
+    DBusMessage reply;
+    return Call(call, reply);
+}
+
+bool DBusConnection::RequestName(const std::string& name) {
+    DBusMessage call = DBusMessage::CreateMethodCall("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                                     "org.freedesktop.DBus", "RequestName");
+    call.AppendString(name);
+    call.AppendUint32(4);   // DBUS_NAME_FLAG_DO_NOT_QUEUE
+    DBusMessage reply;
+    uint32_t result = 0;
+    return Call(call, reply) && reply.ReadUint32(result) && result == 1;   // PRIMARY_OWNER
+}
+
+} // namespace Everon
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Everon {
+
+// Minimal D-Bus message: enough of the wire format to call logind and read its replies
+// (basic types, single-type variants and passed file descriptors), and to answer such
+// calls (stand-in services for offline tests and benchmarks). Linux only.
+class DBusMessage {
+public:
+    enum Type : BYTE {
+        Invalid = 0,
+        MethodCall = 1,
+        MethodReturn = 2,
+        Error = 3,
+        Signal = 4
+    };
+
+    DBusMessage() = default;
+    ~DBusMessage();
+
+    DBusMessage(DBusMessage&& other) noexcept;
+    DBusMessage& operator=(DBusMessage&& other) noexcept;
+    DBusMessage(const DBusMessage&) = delete;
+    DBusMessage& operator=(const DBusMessage&) = delete;
+
+    static DBusMessage CreateMethodCall(const std::string& destination, const std::string& path,
+                                        const std::string& interface, const std::string& member);
+    static DBusMessage CreateSignal(const std::string& path, const std::string& interface,
+                                    const std::string& member);
+    static DBusMessage CreateMethodReturn(const DBusMessage& call);
+    static DBusMessage CreateError(const DBusMessage& call, const std::string& errorName);
+
+    // Body writers; each appends its type code to the body signature.
+    void AppendString(const std::string& value);
+    void AppendObjectPath(const std::string& value);
+    void AppendBool(bool value);
+    void AppendUint32(uint32_t value);
+    void AppendUint64(uint64_t value);
+    // Passes a duplicate of `fd` (type 'h'); the caller keeps its own descriptor.
+    bool AppendUnixFd(int fd);
+    // Starts a variant; the next Append* writes its value.
+    void AppendVariant(char type);
+    // An empty array of `elementSignature` (e.g. "{sv}" for an empty property dict).
+    void AppendEmptyArray(const std::string& elementSignature);
+
+    // Body readers, in signature order. False on a type mismatch or truncated body.
+    bool ReadString(std::string& value);
+    bool ReadObjectPath(std::string& value);
+    bool ReadBool(bool& value);
+    bool ReadUint32(uint32_t& value);
+    bool ReadUint64(uint64_t& value);
+    // Takes ownership of a passed descriptor (type 'h').
+    bool ReadUnixFd(int& fd);
+    // Enters a variant holding a basic type; the next Read* must match `type`.
+    bool ReadVariant(char& type);
+
+    Type GetType() const noexcept { return m_type; }
+    uint32_t GetSerial() const noexcept { return m_serial; }
+    uint32_t GetReplySerial() const noexcept { return m_replySerial; }
+    const std::string& GetSender() const noexcept { return m_sender; }
+    const std::string& GetPath() const noexcept { return m_path; }
+    const std::string& GetInterface() const noexcept { return m_interface; }
+    const std::string& GetMember() const noexcept { return m_member; }
+    const std::string& GetErrorName() const noexcept { return m_errorName; }
+    const std::string& GetSignature() const noexcept { return m_signature; }
+
+private:
+    friend class DBusConnection;
+
+    std::vector<BYTE> Serialize(uint32_t serial) const;
+    // Parses one complete message from `data`; `consumed` is its length, 0 if incomplete.
+    static bool Parse(const BYTE* data, size_t size, DBusMessage& out, size_t& consumed);
+
+    void Pad(size_t alignment);
+    void AddCode(char code);
+    bool Expect(char code);
+    bool Align(size_t alignment);
+    bool Read32(uint32_t& value);
+    bool Read64(uint64_t& value);
+    bool ReadStringData(std::string& value, bool shortLength);
+    void CloseFds() noexcept;
+
+    Type m_type = Invalid;
+    std::string m_destination;
+    std::string m_path;
+    std::string m_interface;
+    std::string m_member;
+    std::string m_errorName;
+    std::string m_sender;
+    uint32_t m_serial = 0;
+    uint32_t m_replySerial = 0;
+    uint32_t m_unixFds = 0;
+
+    std::string m_signature;
+    std::vector<BYTE> m_body;
+    std::vector<int> m_fds;       // received descriptors not yet taken, or descriptors to send
+    bool m_inVariant = false;     // writing a variant's value: its code is not in the signature
+    bool m_bigEndian = false;
+    size_t m_readPos = 0;
+    size_t m_signaturePos = 0;
+    char m_variantType = 0;
+};
+
+// Blocking connection to a message bus over a Unix socket (EXTERNAL auth, fd passing).
+class DBusConnection {
+public:
+    // $DBUS_SYSTEM_BUS_ADDRESS, else the well-known system bus socket.
+    static std::string SystemBusAddress();
+    // $DBUS_SESSION_BUS_ADDRESS, else $XDG_RUNTIME_DIR/bus; empty outside a session.
+    static std::string SessionBusAddress();
+
+    DBusConnection() = default;
+    ~DBusConnection();
+
+    DBusConnection(const DBusConnection&) = delete;
+    DBusConnection& operator=(const DBusConnection&) = delete;
+
+    // "unix:path=..." or "unix:abstract=..." (first usable entry of a ';' list).
+    bool Connect(const std::string& address);
+    void Close();
+    bool IsConnected() const noexcept { return m_fd >= 0; }
+    // Socket to poll for readability (incoming signals), -1 when not connected.
+    int GetFd() const noexcept { return m_fd; }
+    const std::string& GetUniqueName() const noexcept { return m_uniqueName; }
+
+    // Sends a method call and waits for its reply. An error reply returns false with
+    // `reply` holding it (GetErrorName()). Signals arriving meanwhile are kept for
+    // ReadMessage(); they are no longer signalled on GetFd().
+    bool Call(DBusMessage& call, DBusMessage& reply, int timeoutMs = 5000);
+
+    // Lower level, for services: sends any message (with its descriptors) and receives
+    // the next incoming one.
+    bool Send(const DBusMessage& message, uint32_t* serial = nullptr);
+    bool ReadMessage(DBusMessage& message, int timeoutMs);
+
+    // org.freedesktop.DBus.RequestName; true once this connection is the primary owner.
+    bool RequestName(const std::string& name);
+    // org.freedesktop.DBus.AddMatch: subscribes to the signals matching `rule`.
+    bool AddMatch(const std::string& rule);
+
+private:
+    bool SendAll(const void* data, size_t size, const std::vector<int>& fds = {});
+    bool Receive(int timeoutMs);
+    bool ReadNext(DBusMessage& message, int timeoutMs);
+    bool ReadLine(std::string& line, int timeoutMs);
+    bool Authenticate(int timeoutMs);
+
+    int m_fd = -1;
+    uint32_t m_serial = 0;
+    std::vector<BYTE> m_in;
+    std::vector<int> m_inFds;
+    std::deque<DBusMessage> m_signals;    // received during Call()
+    std::string m_uniqueName;
+};
+
+} // namespace Everon
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Platform.h"
+#include "Clock.h"
+
+namespace Everon {
+
+// One-shot OS timer armed for an absolute deadline. The process is woken once, when the
+// deadline is reached, however far away it is; there are no intermediate re-arms.
+// Windows: a waitable timer (absolute FILETIME for wall deadlines, relative due time for
+// monotonic ones). Linux: a timerfd on CLOCK_REALTIME or CLOCK_BOOTTIME with
+// TFD_TIMER_ABSTIME. Deadlines use SystemClock's time lines.
+class DeadlineTimer {
+public:
+#ifdef _WIN32
+    using NativeHandle = HANDLE;   // for a wait (App: RegisterWaitForSingleObject)
+#else
+    using NativeHandle = int;      // for poll()
+#endif
+
+    DeadlineTimer() = default;
+    ~DeadlineTimer();
+
+    DeadlineTimer(const DeadlineTimer&) = delete;
+    DeadlineTimer& operator=(const DeadlineTimer&) = delete;
+
+    // Arms (or re-arms) the timer. A deadline in the past fires immediately.
+    // `toleranceTicks` lets the OS delay the wakeup by up to that much to coalesce it
+    // with other timers (tolerable delay on Windows; on Linux the deadline is rounded up
+    // onto a shared power-of-two grid within the tolerance).
+    bool Arm(ClockBase base, ULONGLONG deadlineTicks, ULONGLONG toleranceTicks = 0);
+    void Cancel();
+    bool IsArmed() const noexcept { return m_armed; }
+
+    // Signaled when the deadline is reached. Created on first Arm(); on Linux the
+    // descriptor is replaced when the clock base changes. Invalid before that.
+    NativeHandle GetHandle() const noexcept { return m_handle; }
+
+    // Call once the handle is signaled. Returns true if the deadline was reached and disarms.
+    bool Consume();
+
+private:
+    bool EnsureHandle(ClockBase base);
+    void Close();
+
+#ifdef _WIN32
+    NativeHandle m_handle = nullptr;
+#else
+    NativeHandle m_handle = -1;
+#endif
+    ClockBase m_base = ClockBase::Wall;
+    bool m_armed = false;
+};
+
+} // namespace Everon
@@ -0,0 +1,117 @@
+#include "DeadlineTimer.h"
+#include "CivilTime.h"
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace Everon {
+
+namespace {
+
+constexpr ULONGLONG kEpochDeltaSec = static_cast<ULONGLONG>(Civil::UNIX_EPOCH_DELTA_SEC);
+constexpr ULONGLONG kTicksPerSec = Civil::TICKS_PER_SEC;
+
+clockid_t ClockIdFor(ClockBase base) noexcept {
+    // Platform::GetMonotonicTicks() is CLOCK_BOOTTIME, so monotonic ticks map 1:1.
+    return base == ClockBase::Wall ? CLOCK_REALTIME : CLOCK_BOOTTIME;
+}
+
+// Rounds a deadline up to the largest power-of-two millisecond grid that fits within the
+// tolerance. Grid points are shared by every timer on the same clock, so independent
+// timers with similar tolerances expire together.
+ULONGLONG CoalesceDeadline(ULONGLONG deadline, ULONGLONG tolerance) noexcept {
+    constexpr ULONGLONG kTicksPerMs = 10000ULL;
+    if (tolerance < kTicksPerMs) {
+        return deadline;
+    }
+    ULONGLONG grid = kTicksPerMs;
+    while (grid * 2 <= tolerance) {
+        grid *= 2;
+    }
+    return (deadline + grid - 1) / grid * grid;
+}
+
+timespec ToTimespec(ClockBase base, ULONGLONG ticks) noexcept {
+    ULONGLONG seconds = ticks / kTicksPerSec;
+    if (base == ClockBase::Wall) {
+        seconds = (seconds > kEpochDeltaSec) ? seconds - kEpochDeltaSec : 0;
+    }
+    timespec ts = {};
+    ts.tv_sec = static_cast<time_t>(seconds);
+    ts.tv_nsec = static_cast<long>((ticks % kTicksPerSec) * 100ULL);
+    // it_value == 0 would disarm the timer instead of firing it.
+    if (ts.tv_sec == 0 && ts.tv_nsec == 0) {
+        ts.tv_nsec = 1;
+    }
+    return ts;
+}
+
+} // namespace
+
+DeadlineTimer::~DeadlineTimer() {
+    Close();
+}
+
+bool DeadlineTimer::EnsureHandle(ClockBase base) {
+    if (m_handle >= 0 && m_base == base) {
+        return true;
+    }
+
+    Close();
+    m_handle = timerfd_create(ClockIdFor(base), TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_handle < 0) {
+        Utils::DebugLog(L"[Everon] timerfd_create failed (errno %d)\n", errno);
+        return false;
+    }
+    m_base = base;
+    return true;
+}
+
+bool DeadlineTimer::Arm(ClockBase base, ULONGLONG deadlineTicks, ULONGLONG toleranceTicks) {
+    if (!EnsureHandle(base)) {
+        return false;
+    }
+
+    itimerspec spec = {};
+    spec.it_value = ToTimespec(base, CoalesceDeadline(deadlineTicks, toleranceTicks));
+    if (timerfd_settime(m_handle, TFD_TIMER_ABSTIME, &spec, nullptr) != 0) {
+        Utils::DebugLog(L"[Everon] timerfd_settime failed (errno %d)\n", errno);
+        m_armed = false;
+        return false;
+    }
+    m_armed = true;
+    return true;
+}
+
+void DeadlineTimer::Cancel() {
+    if (m_handle >= 0) {
+        const itimerspec disarm = {};
+        timerfd_settime(m_handle, 0, &disarm, nullptr);
+    }
+    m_armed = false;
+}
+
+bool DeadlineTimer::Consume() {
+    if (m_handle < 0) {
+        return false;
+    }
+
+    uint64_t expirations = 0;
+    if (read(m_handle, &expirations, sizeof(expirations)) != static_cast<ssize_t>(sizeof(expirations))) {
+        return false; // EAGAIN: spurious wakeup
+    }
+    m_armed = false;
+    return expirations > 0;
+}
+
+void DeadlineTimer::Close() {
+    if (m_handle >= 0) {
+        close(m_handle);
+        m_handle = -1;
+    }
+    m_armed = false;
+}
+
+} // namespace Everon
@@ -0,0 +1,75 @@
+#include "DeadlineTimer.h"
+
+namespace Everon {
+
+DeadlineTimer::~DeadlineTimer() {
+    Close();
+}
+
+bool DeadlineTimer::EnsureHandle(ClockBase base) {
+    m_base = base;
+    if (m_handle) {
+        return true;
+    }
+
+    // Synchronization (auto-reset) timer: a satisfied wait resets it.
+    m_handle = CreateWaitableTimerW(nullptr, FALSE, nullptr);
+    if (!m_handle) {
+        Utils::DebugLog(L"[Everon] CreateWaitableTimerW failed (%lu)\n", GetLastError());
+        return false;
+    }
+    return true;
+}
+
+bool DeadlineTimer::Arm(ClockBase base, ULONGLONG deadlineTicks, ULONGLONG toleranceTicks) {
+    if (!EnsureHandle(base)) {
+        return false;
+    }
+
+    LARGE_INTEGER due = {};
+    if (base == ClockBase::Wall) {
+        // Positive: absolute UTC FILETIME. Tracks system time changes by itself.
+        due.QuadPart = static_cast<LONGLONG>(deadlineTicks);
+    } else {
+        // Negative: relative 100 ns interval, immune to system time changes.
+        const ULONGLONG now = SystemClock::Instance().NowMonotonic();
+        const ULONGLONG remaining = (deadlineTicks > now) ? deadlineTicks - now : 0;
+        due.QuadPart = -static_cast<LONGLONG>(remaining ? remaining : 1);
+    }
+
+    // No wake context: never wake a sleeping machine just to expire the timer.
+    const ULONGLONG toleranceMs = toleranceTicks / 10000ULL;
+    const ULONG tolerableDelay = static_cast<ULONG>(toleranceMs > 0x7FFFFFFFULL ? 0x7FFFFFFFULL : toleranceMs);
+    if (!SetWaitableTimerEx(m_handle, &due, 0, nullptr, nullptr, nullptr, tolerableDelay)) {
+        Utils::DebugLog(L"[Everon] SetWaitableTimerEx failed (%lu)\n", GetLastError());
+        m_armed = false;
+        return false;
+    }
+    m_armed = true;
+    return true;
+}
+
+void DeadlineTimer::Cancel() {
+    if (m_handle) {
+        CancelWaitableTimer(m_handle);
+    }
+    m_armed = false;
+}
+
+bool DeadlineTimer::Consume() {
+    // The wait that reported the signal has already reset the timer.
+    const bool fired = m_armed;
+    m_armed = false;
+    return fired;
+}
+
+void DeadlineTimer::Close() {
+    if (m_handle) {
+        CancelWaitableTimer(m_handle);
+        CloseHandle(m_handle);
+        m_handle = nullptr;
+    }
+    m_armed = false;
+}
+
+} // namespace Everon
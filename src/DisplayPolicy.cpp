@@ -0,0 +1,44 @@
+#include "DisplayPolicy.h"
+
+namespace Everon {
+
+bool DisplayPolicy::IsDisplayOn(const Clock& clock, ULONGLONG enabledMonotonic,
+                                ULONGLONG& nextCheckMonotonic) const noexcept {
+    nextCheckMonotonic = 0;
+    const ULONGLONG now = clock.NowMonotonic();
+
+    if (onMinutes != 0) {
+        const ULONGLONG end = enabledMonotonic + static_cast<ULONGLONG>(onMinutes) * Clock::TICKS_PER_MIN;
+        if (now >= end) {
+            return false;   // the limit has run out for this period; nothing turns it back on
+        }
+        nextCheckMonotonic = end;
+    }
+
+    if (!HasWindow()) {
+        return true;
+    }
+
+    // Position within the local day; the next boundary is re-evaluated when reached, so a
+    // DST change in between only delays the switch until that check (or a clock change).
+    SYSTEMTIME local = {};
+    clock.NowLocal(local);
+    constexpr ULONGLONG kMsPerMin = 60000ULL;
+    constexpr ULONGLONG kMsPerDay = MINUTES_PER_DAY * kMsPerMin;
+    const ULONGLONG nowMs = ((local.wHour * 60ULL + local.wMinute) * 60ULL + local.wSecond) * 1000ULL +
+                            local.wMilliseconds;
+    const ULONGLONG startMs = (windowStartMinute % MINUTES_PER_DAY) * kMsPerMin;
+    const ULONGLONG endMs = (windowEndMinute % MINUTES_PER_DAY) * kMsPerMin;
+
+    const bool inside = (startMs < endMs) ? (nowMs >= startMs && nowMs < endMs)
+                                          : (nowMs >= startMs || nowMs < endMs);
+    const ULONGLONG boundaryMs = inside ? endMs : startMs;
+    const ULONGLONG untilMs = (boundaryMs + kMsPerDay - nowMs) % kMsPerDay;
+    const ULONGLONG boundary = now + (untilMs != 0 ? untilMs : kMsPerDay) * Clock::TICKS_PER_MS;
+    if (nextCheckMonotonic == 0 || boundary < nextCheckMonotonic) {
+        nextCheckMonotonic = boundary;
+    }
+    return inside;
+}
+
+} // namespace Everon
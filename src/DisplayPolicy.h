@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Platform.h"
+#include "Clock.h"
+
+namespace Everon {
+
+// Limits "keep display on" to part of an enabled period; outside it the machine stays
+// awake with the display allowed to turn off. No limits: display on for the whole period.
+struct DisplayPolicy {
+    DWORD onMinutes = 0;            // display on for the first N minutes only (0 = no limit)
+    DWORD windowStartMinute = 0;    // local time-of-day window, minutes after midnight;
+    DWORD windowEndMinute = 0;      // start == end: no window. May wrap past midnight.
+
+    static constexpr DWORD MAX_ON_MINUTES = 10080;  // 7 days
+    static constexpr DWORD MINUTES_PER_DAY = 1440;
+
+    bool HasWindow() const noexcept { return windowStartMinute != windowEndMinute; }
+    bool IsLimited() const noexcept { return onMinutes != 0 || HasWindow(); }
+
+    // Whether the display should be on now, for a period enabled at `enabledMonotonic`.
+    // `nextCheckMonotonic` receives the moment the answer can next change (0 = never).
+    bool IsDisplayOn(const Clock& clock, ULONGLONG enabledMonotonic,
+                     ULONGLONG& nextCheckMonotonic) const noexcept;
+};
+
+} // namespace Everon
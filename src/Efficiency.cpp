@@ -0,0 +1,82 @@
+#include "Efficiency.h"
+
+namespace Everon {
+
+namespace {
+
+constexpr ULONGLONG kTicksPerSec = 10000000ULL;
+constexpr ULONGLONG kTicksPerMin = 60ULL * kTicksPerSec;
+
+} // namespace
+
+namespace Efficiency {
+
+ULONGLONG KeypressTolerance(ULONGLONG periodTicks) noexcept {
+    const ULONGLONG tolerance = periodTicks / 10;
+    const ULONGLONG cap = 30ULL * kTicksPerSec;
+    return tolerance < cap ? tolerance : cap;
+}
+
+ULONGLONG ExpiryTolerance(ULONGLONG remainingTicks) noexcept {
+    const ULONGLONG tolerance = remainingTicks / 100;
+    const ULONGLONG cap = 60ULL * kTicksPerSec;
+    return tolerance < cap ? tolerance : cap;
+}
+
+} // namespace Efficiency
+
+ULONGLONG WakeupCounter::MinuteOf(ULONGLONG ticks) noexcept {
+    // +1 so that slot minute 0 means "never used".
+    return ticks / kTicksPerMin + 1;
+}
+
+void WakeupCounter::Record(ULONGLONG nowMonotonic) noexcept {
+    const ULONGLONG minute = MinuteOf(nowMonotonic);
+    const size_t slot = static_cast<size_t>(minute % WINDOW_MINUTES);
+    if (m_minutes[slot] != minute) {
+        m_minutes[slot] = minute;
+        m_counts[slot] = 0;
+    }
+    ++m_counts[slot];
+    ++m_total;
+}
+
+DWORD WakeupCounter::GetLastHour(ULONGLONG nowMonotonic) const noexcept {
+    const ULONGLONG minute = MinuteOf(nowMonotonic);
+    DWORD count = 0;
+    for (size_t i = 0; i < WINDOW_MINUTES; ++i) {
+        if (m_minutes[i] != 0 && m_minutes[i] + WINDOW_MINUTES > minute) {
+            count += m_counts[i];
+        }
+    }
+    return count;
+}
+
+bool WakeupCounter::IsOverBudget(ULONGLONG nowMonotonic) const noexcept {
+    return m_budget != 0 && GetLastHour(nowMonotonic) >= m_budget;
+}
+
+ULONGLONG WakeupCounter::GetNextAllowed(ULONGLONG nowMonotonic) const noexcept {
+    if (!IsOverBudget(nowMonotonic)) {
+        return nowMonotonic;
+    }
+
+    // Walk the window from the oldest minute until enough wakeups would have expired.
+    const ULONGLONG minute = MinuteOf(nowMonotonic);
+    DWORD excess = GetLastHour(nowMonotonic) - m_budget + 1;
+    const ULONGLONG oldest = minute >= WINDOW_MINUTES ? minute + 1 - WINDOW_MINUTES : 1;
+    for (ULONGLONG m = oldest; m <= minute; ++m) {
+        const size_t slot = static_cast<size_t>(m % WINDOW_MINUTES);
+        if (m_minutes[slot] != m) {
+            continue;
+        }
+        if (m_counts[slot] >= excess) {
+            // Slot minute m leaves the window at the start of minute m + WINDOW_MINUTES.
+            return (m + WINDOW_MINUTES - 1) * kTicksPerMin;
+        }
+        excess -= m_counts[slot];
+    }
+    return nowMonotonic + kTicksPerMin;
+}
+
+} // namespace Everon
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstddef>
+
+namespace Everon {
+
+// Efficiency mode: timers may be delayed by a tolerance so the OS can batch wakeups,
+// and the process runs in the platform's low-power QoS class
+// (Platform::SetEfficiencyMode). All values are 100 ns ticks.
+namespace Efficiency {
+
+// Coalescing tolerance for the keypress timer: a tenth of the period, at most 30 s.
+// The schedule itself stays on its grid; only individual wakeups may slip.
+ULONGLONG KeypressTolerance(ULONGLONG periodTicks) noexcept;
+
+// Coalescing tolerance for the expiry deadline: 1% of the time left, at most 60 s.
+ULONGLONG ExpiryTolerance(ULONGLONG remainingTicks) noexcept;
+
+// Thread timer slack applied in efficiency mode (Linux PR_SET_TIMERSLACK).
+constexpr ULONGLONG TIMER_SLACK_TICKS = 50ULL * 10000ULL; // 50 ms
+
+} // namespace Efficiency
+
+// Counts timer wakeups over a sliding one-hour window (one-minute resolution) and
+// checks them against an optional budget. Times are Clock::NowMonotonic() ticks.
+class WakeupCounter {
+public:
+    static constexpr size_t WINDOW_MINUTES = 60;
+
+    void Record(ULONGLONG nowMonotonic) noexcept;
+
+    ULONGLONG GetTotal() const noexcept { return m_total; }
+    DWORD GetLastHour(ULONGLONG nowMonotonic) const noexcept;
+
+    // 0 = unlimited
+    void SetBudgetPerHour(DWORD budget) noexcept { m_budget = budget; }
+    DWORD GetBudgetPerHour() const noexcept { return m_budget; }
+    bool IsOverBudget(ULONGLONG nowMonotonic) const noexcept;
+
+    // Earliest moment at or after `nowMonotonic` when one more discretionary wakeup fits
+    // the budget (the oldest counted minute leaves the window).
+    ULONGLONG GetNextAllowed(ULONGLONG nowMonotonic) const noexcept;
+
+private:
+    static ULONGLONG MinuteOf(ULONGLONG ticks) noexcept;
+
+    DWORD m_counts[WINDOW_MINUTES] = {};
+    ULONGLONG m_minutes[WINDOW_MINUTES] = {};  // absolute minute each slot currently holds
+    ULONGLONG m_total = 0;
+    DWORD m_budget = 0;
+};
+
+} // namespace Everon
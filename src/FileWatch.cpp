@@ -0,0 +1,107 @@
+#include "FileWatch.h"
+#include <algorithm>
+
+namespace Everon {
+
+FileActivityRing::FileActivityRing(ULONGLONG bucketWidth) noexcept
+    : m_width(bucketWidth ? bucketWidth : 1) {
+}
+
+void FileActivityRing::Record(ULONGLONG now, ULONGLONG events) noexcept {
+    if (events == 0) {
+        return;
+    }
+    const ULONGLONG slot = now / m_width;
+    if (slot > m_headSlot) {
+        // Buckets skipped since the last event held nothing.
+        const ULONGLONG advance = slot - m_headSlot;
+        if (advance >= BUCKETS) {
+            std::fill(std::begin(m_counts), std::end(m_counts), 0ULL);
+        } else {
+            for (ULONGLONG s = m_headSlot + 1; s <= slot; ++s) {
+                m_counts[s % BUCKETS] = 0;
+            }
+        }
+        m_headSlot = slot;
+    } else if (m_headSlot - slot >= BUCKETS) {
+        return;   // stamped before the window (a late completion): too old to matter
+    }
+    m_counts[slot % BUCKETS] += events;
+    m_total += events;
+    m_lastEvent = (std::max)(m_lastEvent, (slot + 1) * m_width);
+}
+
+void FileActivityRing::Clear() noexcept {
+    std::fill(std::begin(m_counts), std::end(m_counts), 0ULL);
+    m_headSlot = 0;
+    m_lastEvent = 0;
+    m_total = 0;
+}
+
+ULONGLONG FileActivityRing::CountSince(ULONGLONG since, ULONGLONG now) const noexcept {
+    const ULONGLONG nowSlot = now / m_width;
+    ULONGLONG count = 0;
+    for (ULONGLONG i = 0; i < BUCKETS && i <= m_headSlot; ++i) {
+        const ULONGLONG slot = m_headSlot - i;
+        if ((slot + 1) * m_width <= since || slot + BUCKETS <= nowSlot) {
+            break;
+        }
+        count += m_counts[slot % BUCKETS];
+    }
+    return count;
+}
+
+std::vector<FileWatcher::String> FileWatcher::SplitList(const std::wstring& list) {
+    std::vector<String> out;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(L';', start);
+        if (end == std::wstring::npos) {
+            end = list.size();
+        }
+        size_t first = start;
+        size_t last = end;
+        while (first < last && (list[first] == L' ' || list[first] == L'\t')) {
+            ++first;
+        }
+        while (last > first && (list[last - 1] == L' ' || list[last - 1] == L'\t')) {
+            --last;
+        }
+        if (first < last) {
+#ifdef _WIN32
+            out.emplace_back(list, first, last - first);
+#else
+            // wchar_t is UTF-32 here; paths are UTF-8.
+            std::string path;
+            for (size_t i = first; i < last; ++i) {
+                const auto c = static_cast<unsigned long>(list[i]);
+                if (c < 0x80) {
+                    path += static_cast<char>(c);
+                } else if (c < 0x800) {
+                    path += static_cast<char>(0xC0 | (c >> 6));
+                    path += static_cast<char>(0x80 | (c & 0x3F));
+                } else if (c < 0x10000) {
+                    path += static_cast<char>(0xE0 | (c >> 12));
+                    path += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                    path += static_cast<char>(0x80 | (c & 0x3F));
+                } else {
+                    path += static_cast<char>(0xF0 | (c >> 18));
+                    path += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+                    path += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                    path += static_cast<char>(0x80 | (c & 0x3F));
+                }
+            }
+            out.push_back(std::move(path));
+#endif
+        }
+        start = end + 1;
+    }
+    return out;
+}
+
+bool FileWatcher::IsBusy(ULONGLONG now, ULONGLONG quiet) const noexcept {
+    const ULONGLONG last = GetLastEventTime();
+    return last != 0 && now < last + quiet;
+}
+
+} // namespace Everon
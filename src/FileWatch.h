@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Platform.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Everon {
+
+// Event counts of the last BUCKETS time buckets, oldest overwritten: a burst of
+// thousands of file events in one bucket is one counter, and recording never allocates.
+class FileActivityRing {
+public:
+    static constexpr size_t BUCKETS = 64;
+
+    explicit FileActivityRing(ULONGLONG bucketWidth) noexcept;
+
+    void Record(ULONGLONG now, ULONGLONG events) noexcept;
+    void Clear() noexcept;
+
+    // End of the last bucket holding events, 0 if none ever did.
+    ULONGLONG GetLastEventTime() const noexcept { return m_lastEvent; }
+    // Events recorded in buckets ending after `since` (at most BUCKETS back from `now`).
+    ULONGLONG CountSince(ULONGLONG since, ULONGLONG now) const noexcept;
+    ULONGLONG GetTotal() const noexcept { return m_total; }
+
+private:
+    ULONGLONG m_width;
+    ULONGLONG m_counts[BUCKETS] = {};
+    ULONGLONG m_headSlot = 0;       // bucket index (time / width) of m_counts[m_headSlot % BUCKETS]
+    ULONGLONG m_lastEvent = 0;
+    ULONGLONG m_total = 0;
+};
+
+// Watches directory trees for files being written (a download or sync folder) and
+// records the events in a FileActivityRing; the folders count as busy until a quiet
+// period passes without writes.
+// Windows: ReadDirectoryChangesW on each root (subtrees included), completed on the
+// thread pool; `message` is posted to `window` when notification is enabled, at most
+// once until the next Consume(). Linux: inotify, one watch per directory (new
+// subdirectories are added as they appear), polled together with the other descriptors.
+class FileWatcher {
+public:
+#ifdef _WIN32
+    using String = std::wstring;
+#else
+    using String = std::string;
+#endif
+
+    // ';' separated folder list, blanks around entries trimmed.
+    static std::vector<String> SplitList(const std::wstring& list);
+
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // True if at least one root could be watched.
+#ifdef _WIN32
+    bool Start(const std::vector<String>& roots, HWND window, UINT message);
+    // While the folders are busy the owner only checks them on its quiet timer: turning
+    // notification off leaves a running transfer with no wakeups at all.
+    void SetNotify(bool enabled);
+#else
+    bool Start(const std::vector<String>& roots);
+    // Descriptor to poll for readability, -1 when not started. While the folders are
+    // busy the owner need not poll it: the kernel queues (and merges) the events.
+    int GetFd() const noexcept;
+#endif
+    void Stop();
+    bool IsStarted() const noexcept;
+
+    // Takes pending events into the ring, stamped `now` on Linux (Windows stamps them
+    // as they complete). Returns the number taken.
+    ULONGLONG Consume(ULONGLONG now);
+
+    // A write seen less than `quiet` before `now`.
+    bool IsBusy(ULONGLONG now, ULONGLONG quiet) const noexcept;
+    ULONGLONG GetLastEventTime() const noexcept;
+    ULONGLONG GetEventCount() const noexcept;
+    // Directories watched (Linux: one inotify watch each; Windows: the roots).
+    size_t GetWatchCount() const noexcept;
+
+    static constexpr ULONGLONG BUCKET_WIDTH = 10000000ULL;   // 1 s
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace Everon
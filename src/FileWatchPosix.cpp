@@ -0,0 +1,174 @@
+#include "FileWatch.h"
+#include <cerrno>
+#include <dirent.h>
+#include <string>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace Everon {
+
+namespace {
+
+// Writes and new entries (IN_MOVED_TO: a finished ".part" renamed into place). IN_MODIFY
+// is what keeps a long single-file download busy; the kernel merges a repeat of the last
+// queued event, so one file being written while nobody reads the queue costs one entry,
+// not one per write(). IN_CLOSE_WRITE would only repeat what IN_MODIFY already said.
+constexpr uint32_t kWatchMask = IN_MODIFY | IN_CREATE | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW;
+
+} // namespace
+
+struct FileWatcher::Impl {
+    int fd = -1;
+    std::unordered_map<int, std::string> directories;   // watch descriptor -> path
+    FileActivityRing ring{ BUCKET_WIDTH };
+    ULONGLONG events = 0;
+    bool limitReported = false;
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    ~Impl() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool AddWatch(const std::string& path) {
+        const int wd = inotify_add_watch(fd, path.c_str(), kWatchMask);
+        if (wd < 0) {
+            if (errno == ENOSPC && !limitReported) {
+                // fs.inotify.max_user_watches: the rest of the tree goes unwatched.
+                Utils::DebugLog(L"[Everon] File watch: inotify watch limit reached at %zu directories\n",
+                                directories.size());
+                limitReported = true;
+            }
+            return false;
+        }
+        directories[wd] = path;
+        return true;
+    }
+
+    // `root` and every directory below it (symbolic links not followed).
+    bool AddTree(const std::string& root) {
+        if (!AddWatch(root)) {
+            return false;
+        }
+        std::vector<std::string> pending{ root };
+        while (!pending.empty() && !limitReported) {
+            const std::string path = std::move(pending.back());
+            pending.pop_back();
+            DIR* dir = opendir(path.c_str());
+            if (!dir) {
+                continue;
+            }
+            while (const dirent* entry = readdir(dir)) {
+                const char* name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                    continue;
+                }
+                std::string child = path + "/" + name;
+                bool isDirectory = entry->d_type == DT_DIR;
+                if (entry->d_type == DT_UNKNOWN) {
+                    struct stat info = {};
+                    isDirectory = lstat(child.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+                }
+                if (isDirectory && AddWatch(child)) {
+                    pending.push_back(std::move(child));
+                }
+            }
+            closedir(dir);
+        }
+        return true;
+    }
+};
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::~FileWatcher() = default;
+
+bool FileWatcher::Start(const std::vector<String>& roots) {
+    Stop();
+    auto impl = std::make_unique<Impl>();
+    impl->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (impl->fd < 0) {
+        Utils::DebugLog(L"[Everon] File watch: inotify_init1 failed (errno %d)\n", errno);
+        return false;
+    }
+    bool any = false;
+    for (const String& root : roots) {
+        if (impl->AddTree(root)) {
+            any = true;
+        } else {
+            Utils::DebugLog(L"[Everon] File watch: cannot watch %hs (errno %d)\n", root.c_str(), errno);
+        }
+    }
+    if (!any) {
+        return false;
+    }
+    m_impl = std::move(impl);
+    return true;
+}
+
+void FileWatcher::Stop() {
+    m_impl.reset();
+}
+
+bool FileWatcher::IsStarted() const noexcept {
+    return m_impl != nullptr;
+}
+
+int FileWatcher::GetFd() const noexcept {
+    return m_impl ? m_impl->fd : -1;
+}
+
+ULONGLONG FileWatcher::Consume(ULONGLONG now) {
+    if (!m_impl) {
+        return 0;
+    }
+    Impl& impl = *m_impl;
+    ULONGLONG count = 0;
+    for (;;) {
+        const ssize_t size = read(impl.fd, impl.buffer, sizeof(impl.buffer));
+        if (size <= 0) {
+            if (size < 0 && errno == EINTR) {
+                continue;
+            }
+            break;   // EAGAIN: drained
+        }
+        // Counting only: a burst of thousands of files is one pass over this buffer.
+        for (const char* p = impl.buffer; p < impl.buffer + size;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+            if (event->mask & IN_IGNORED) {
+                impl.directories.erase(event->wd);
+                continue;
+            }
+            if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)) && event->len) {
+                const auto parent = impl.directories.find(event->wd);
+                if (parent != impl.directories.end()) {
+                    impl.AddTree(parent->second + "/" + event->name);
+                }
+            }
+            // IN_Q_OVERFLOW counts too: events were lost, so there were events. (A
+            // subdirectory created in the lost part stays unwatched until Start().)
+            ++count;
+        }
+    }
+    impl.ring.Record(now, count);
+    impl.events += count;
+    return count;
+}
+
+ULONGLONG FileWatcher::GetLastEventTime() const noexcept {
+    return m_impl ? m_impl->ring.GetLastEventTime() : 0;
+}
+
+ULONGLONG FileWatcher::GetEventCount() const noexcept {
+    return m_impl ? m_impl->events : 0;
+}
+
+size_t FileWatcher::GetWatchCount() const noexcept {
+    return m_impl ? m_impl->directories.size() : 0;
+}
+
+} // namespace Everon
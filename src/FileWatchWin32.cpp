@@ -0,0 +1,207 @@
+#include "FileWatch.h"
+#include "Utils.h"
+#include <mutex>
+
+namespace Everon {
+
+namespace {
+
+constexpr DWORD kNotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                                FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+constexpr DWORD kBufferSize = 64 * 1024;   // the most a network share accepts
+
+} // namespace
+
+struct FileWatcher::Impl {
+    // One root: a directory handle with a read always outstanding, completed on the
+    // thread pool through its event.
+    struct Root {
+        Impl* owner = nullptr;
+        HANDLE directory = INVALID_HANDLE_VALUE;
+        HANDLE wait = nullptr;
+        OVERLAPPED overlapped = {};
+        alignas(DWORD) BYTE buffer[kBufferSize];
+    };
+
+    HWND window = nullptr;
+    UINT message = 0;
+    std::vector<std::unique_ptr<Root>> roots;
+
+    mutable std::mutex mutex;           // guards everything below: completions run on the pool
+    FileActivityRing ring{ BUCKET_WIDTH };
+    ULONGLONG events = 0;
+    ULONGLONG unconsumed = 0;
+    bool notify = true;
+    bool posted = false;                // a message is on its way; no more until Consume()
+
+    ~Impl() {
+        for (auto& root : roots) {
+            Close(*root);
+        }
+    }
+
+    static bool Issue(Root& root) {
+        return ReadDirectoryChangesW(root.directory, root.buffer, kBufferSize, TRUE, kNotifyFilter, nullptr,
+                                     &root.overlapped, nullptr) != FALSE;
+    }
+
+    bool Open(const std::wstring& path) {
+        auto root = std::make_unique<Root>();
+        root->owner = this;
+        root->directory = CreateFileW(path.c_str(), FILE_LIST_DIRECTORY,
+                                      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                      FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (root->directory == INVALID_HANDLE_VALUE) {
+            Utils::CheckWinApiBool(FALSE, L"CreateFileW(watched folder)");
+            return false;
+        }
+        root->overlapped.hEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!root->overlapped.hEvent || !Issue(*root) ||
+            !RegisterWaitForSingleObject(&root->wait, root->overlapped.hEvent, OnCompleted, root.get(), INFINITE,
+                                         WT_EXECUTEDEFAULT)) {
+            Utils::CheckWinApiBool(FALSE, L"ReadDirectoryChangesW");
+            Close(*root);
+            return false;
+        }
+        roots.push_back(std::move(root));
+        return true;
+    }
+
+    static void Close(Root& root) {
+        // No callback runs after UnregisterWaitEx returns, so nothing re-issues the read.
+        if (root.wait) {
+            UnregisterWaitEx(root.wait, INVALID_HANDLE_VALUE);
+            root.wait = nullptr;
+        }
+        if (root.directory != INVALID_HANDLE_VALUE) {
+            CancelIoEx(root.directory, &root.overlapped);
+            DWORD bytes = 0;
+            GetOverlappedResult(root.directory, &root.overlapped, &bytes, TRUE);
+            CloseHandle(root.directory);
+            root.directory = INVALID_HANDLE_VALUE;
+        }
+        if (root.overlapped.hEvent) {
+            CloseHandle(root.overlapped.hEvent);
+            root.overlapped.hEvent = nullptr;
+        }
+    }
+
+    static VOID CALLBACK OnCompleted(PVOID context, BOOLEAN /*timedOut*/) {
+        Root& root = *static_cast<Root*>(context);
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(root.directory, &root.overlapped, &bytes, FALSE)) {
+            return;   // cancelled by Close(), or the folder went away
+        }
+        // Counting only. Zero bytes: the buffer overflowed and the changes were lost,
+        // which still means changes.
+        ULONGLONG count = 0;
+        if (bytes == 0) {
+            count = 1;
+        } else {
+            for (DWORD offset = 0;;) {
+                const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(root.buffer + offset);
+                ++count;
+                if (info->NextEntryOffset == 0) {
+                    break;
+                }
+                offset += info->NextEntryOffset;
+            }
+        }
+        Issue(root);
+        root.owner->OnEvents(count);
+    }
+
+    void OnEvents(ULONGLONG count) {
+        bool post = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ring.Record(Platform::GetMonotonicTicks(), count);
+            events += count;
+            unconsumed += count;
+            post = notify && !posted;
+            posted |= post;
+        }
+        if (post) {
+            PostMessageW(window, message, 0, 0);
+        }
+    }
+};
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::~FileWatcher() = default;
+
+bool FileWatcher::Start(const std::vector<String>& roots, HWND window, UINT message) {
+    Stop();
+    auto impl = std::make_unique<Impl>();
+    impl->window = window;
+    impl->message = message;
+    for (const String& root : roots) {
+        if (!impl->Open(root)) {
+            Utils::DebugLog(L"[Everon] File watch: cannot watch %ls\n", root.c_str());
+        }
+    }
+    if (impl->roots.empty()) {
+        return false;
+    }
+    m_impl = std::move(impl);
+    return true;
+}
+
+void FileWatcher::SetNotify(bool enabled) {
+    if (!m_impl) {
+        return;
+    }
+    bool post = false;
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+        m_impl->notify = enabled;
+        // Events that arrived while notification was off are reported right away.
+        post = enabled && m_impl->unconsumed != 0 && !m_impl->posted;
+        m_impl->posted |= post;
+    }
+    if (post) {
+        PostMessageW(m_impl->window, m_impl->message, 0, 0);
+    }
+}
+
+void FileWatcher::Stop() {
+    m_impl.reset();
+}
+
+bool FileWatcher::IsStarted() const noexcept {
+    return m_impl != nullptr;
+}
+
+ULONGLONG FileWatcher::Consume(ULONGLONG /*now*/) {
+    if (!m_impl) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(m_impl->mutex);
+    const ULONGLONG count = m_impl->unconsumed;
+    m_impl->unconsumed = 0;
+    m_impl->posted = false;
+    return count;
+}
+
+ULONGLONG FileWatcher::GetLastEventTime() const noexcept {
+    if (!m_impl) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(m_impl->mutex);
+    return m_impl->ring.GetLastEventTime();
+}
+
+ULONGLONG FileWatcher::GetEventCount() const noexcept {
+    if (!m_impl) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(m_impl->mutex);
+    return m_impl->events;
+}
+
+size_t FileWatcher::GetWatchCount() const noexcept {
+    return m_impl ? m_impl->roots.size() : 0;
+}
+
+} // namespace Everon
@@ -0,0 +1,52 @@
+#include "HotkeyConfig.h"
+#include <cwchar>
+
+namespace Everon {
+
+namespace {
+
+// Parses an unsigned decimal field followed by `terminator` (L'\0' for the last field).
+bool ParseField(const wchar_t*& cursor, wchar_t terminator, unsigned long& out) {
+    wchar_t* end = nullptr;
+    out = std::wcstoul(cursor, &end, 10);
+    if (end == cursor || *end != terminator) {
+        return false;
+    }
+    cursor = (terminator != L'\0') ? end + 1 : end;
+    return true;
+}
+
+} // namespace
+
+HotkeyConfig HotkeyConfig::FromRegistryString(const wchar_t* str) {
+    HotkeyConfig config;
+
+    if (!str || *str == L'\0') {
+        return config;
+    }
+
+    const wchar_t* cursor = str;
+    unsigned long enabled = 0, modifiers = 0, vk = 0;
+    if (ParseField(cursor, L',', enabled) &&
+        ParseField(cursor, L',', modifiers) &&
+        ParseField(cursor, L'\0', vk)) {
+        config.enabled = (enabled != 0);
+        config.modifiers = static_cast<UINT>(modifiers);
+        config.virtualKey = static_cast<UINT>(vk);
+    }
+
+    return config;
+}
+
+std::wstring HotkeyConfig::ToRegistryString() const {
+    std::wstring result;
+    result.reserve(16);
+    result += enabled ? L'1' : L'0';
+    result += L',';
+    result += std::to_wstring(modifiers);
+    result += L',';
+    result += std::to_wstring(virtualKey);
+    return result;
+}
+
+} // namespace Everon
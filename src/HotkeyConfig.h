@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Platform.h"
+#include <string>
+
+namespace Everon {
+
+// Hotkey configuration
+struct HotkeyConfig {
+    bool enabled = false;
+    UINT modifiers = 0;  // MOD_CONTROL, MOD_SHIFT, MOD_ALT, MOD_WIN
+    UINT virtualKey = 0; // VK_*
+
+    bool IsValid() const {
+        return virtualKey != 0;
+    }
+
+    bool operator==(const HotkeyConfig& other) const {
+        return enabled == other.enabled &&
+               modifiers == other.modifiers &&
+               virtualKey == other.virtualKey;
+    }
+
+    bool operator!=(const HotkeyConfig& other) const {
+        return !(*this == other);
+    }
+
+    // Registry/string form: "enabled,modifiers,virtualKey"
+    // Example: "1,3,69" for Ctrl+Shift+E
+    static HotkeyConfig FromRegistryString(const wchar_t* str);
+    std::wstring ToRegistryString() const;
+};
+
+} // namespace Everon
@@ -83,33 +83,11 @@ std::wstring HotkeyManager::HotkeyToString(const HotkeyConfig& config) {
 }
 
 HotkeyConfig HotkeyManager::StringToHotkey(const wchar_t* str) {
-    HotkeyConfig config;
-
-    if (!str || wcslen(str) == 0) {
-        return config;
-    }
-
-    // Format: "enabled,modifiers,virtualKey"
-    // Example: "1,3,69" for Ctrl+Shift+E
-
-    int enabled = 0;
-    unsigned int modifiers = 0, vk = 0;
-    if (swscanf_s(str, L"%d,%u,%u", &enabled, &modifiers, &vk) == 3) {
-        config.enabled = (enabled != 0);
-        config.modifiers = static_cast<UINT>(modifiers);
-        config.virtualKey = static_cast<UINT>(vk);
-    }
-
-    return config;
+    return HotkeyConfig::FromRegistryString(str);
 }
 
 std::wstring HotkeyManager::HotkeyToRegistryString(const HotkeyConfig& config) {
-    wchar_t buffer[64];
-    swprintf_s(buffer, L"%d,%u,%u",
-              config.enabled ? 1 : 0,
-              config.modifiers,
-              config.virtualKey);
-    return buffer;
+    return config.ToRegistryString();
 }
 
 } // namespace Everon
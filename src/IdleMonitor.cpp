@@ -0,0 +1,22 @@
+#include "IdleMonitor.h"
+
+namespace Everon {
+
+bool IdleMonitor::ShouldInject(ULONGLONG nowMonotonic, ULONGLONG thresholdTicks, ULONGLONG& lastInputMonotonic) {
+    ULONGLONG idle = 0;
+    if (!GetIdleTicks(idle) || idle >= thresholdTicks) {
+        ++m_injected;
+        return true;
+    }
+
+    lastInputMonotonic = nowMonotonic - (idle < nowMonotonic ? idle : nowMonotonic);
+    ++m_avoided;
+    return false;
+}
+
+ULONGLONG IdleMonitor::DefaultThreshold(ULONGLONG periodTicks) noexcept {
+    constexpr ULONGLONG kSlack = 10000000ULL;  // 1 s
+    return periodTicks > 2 * kSlack ? periodTicks - kSlack : periodTicks / 2;
+}
+
+} // namespace Everon
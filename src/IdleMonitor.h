@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Platform.h"
+
+namespace Everon {
+
+// Time since the last user input, used to skip keypresses that real input already made
+// unnecessary. Windows: GetLastInputInfo (session-wide). Linux: the X11 MIT-SCREEN-SAVER
+// extension (XScreenSaverQueryInfo) on $DISPLAY, which Xvfb also provides; without X11
+// support in the build the idle time is simply unknown.
+class IdleMonitor {
+public:
+    IdleMonitor() = default;
+    ~IdleMonitor();
+
+    IdleMonitor(const IdleMonitor&) = delete;
+    IdleMonitor& operator=(const IdleMonitor&) = delete;
+
+    // False if the platform cannot tell (no display, extension missing).
+    bool GetIdleTicks(ULONGLONG& idleTicks);
+
+    // Keypress gate. Returns true if the user has been idle for at least `thresholdTicks`
+    // (or idle time is unknown) and the keypress should be injected. Otherwise the
+    // injection is counted as avoided and `lastInputMonotonic` receives the moment of the
+    // last real input, from which the next keypress should be scheduled.
+    bool ShouldInject(ULONGLONG nowMonotonic, ULONGLONG thresholdTicks, ULONGLONG& lastInputMonotonic);
+
+    // Threshold used when none is configured: one period, less a second of slack so that
+    // input just short of a period does not cause an immediate re-wake.
+    static ULONGLONG DefaultThreshold(ULONGLONG periodTicks) noexcept;
+
+    ULONGLONG GetInjectedCount() const noexcept { return m_injected; }
+    ULONGLONG GetAvoidedCount() const noexcept { return m_avoided; }
+    void ResetCounters() noexcept { m_injected = m_avoided = 0; }
+
+private:
+#ifndef _WIN32
+    void* m_display = nullptr;   // Display*, opened on first use
+    bool m_unavailable = false;  // no display or no extension: stop retrying
+#endif
+    ULONGLONG m_injected = 0;
+    ULONGLONG m_avoided = 0;
+};
+
+} // namespace Everon
@@ -0,0 +1,21 @@
+#include "IdleMonitor.h"
+
+namespace Everon {
+
+IdleMonitor::~IdleMonitor() = default;
+
+bool IdleMonitor::GetIdleTicks(ULONGLONG& idleTicks) {
+    LASTINPUTINFO info = {};
+    info.cbSize = sizeof(info);
+    if (!GetLastInputInfo(&info)) {
+        Utils::DebugLog(L"[Everon] GetLastInputInfo failed (%lu)\n", GetLastError());
+        return false;
+    }
+
+    // Both are 32-bit GetTickCount values; unsigned subtraction handles the 49.7-day wrap.
+    const DWORD idleMs = GetTickCount() - info.dwTime;
+    idleTicks = static_cast<ULONGLONG>(idleMs) * 10000ULL;
+    return true;
+}
+
+} // namespace Everon
@@ -0,0 +1,61 @@
+#include "IdleMonitor.h"
+
+#ifdef EVERON_HAVE_XSS
+#include <X11/Xlib.h>
+#include <X11/extensions/scrnsaver.h>
+#endif
+
+namespace Everon {
+
+#ifdef EVERON_HAVE_XSS
+
+IdleMonitor::~IdleMonitor() {
+    if (m_display) {
+        XCloseDisplay(static_cast<Display*>(m_display));
+    }
+}
+
+bool IdleMonitor::GetIdleTicks(ULONGLONG& idleTicks) {
+    if (m_unavailable) {
+        return false;
+    }
+
+    if (!m_display) {
+        Display* display = XOpenDisplay(nullptr);
+        int eventBase = 0;
+        int errorBase = 0;
+        if (!display || !XScreenSaverQueryExtension(display, &eventBase, &errorBase)) {
+            Utils::DebugLog(L"[Everon] X11 idle time unavailable (no display or MIT-SCREEN-SAVER)\n");
+            if (display) {
+                XCloseDisplay(display);
+            }
+            m_unavailable = true;
+            return false;
+        }
+        m_display = display;
+    }
+
+    Display* display = static_cast<Display*>(m_display);
+    XScreenSaverInfo* info = XScreenSaverAllocInfo();
+    if (!info) {
+        return false;
+    }
+    const bool ok = XScreenSaverQueryInfo(display, DefaultRootWindow(display), info) != 0;
+    if (ok) {
+        idleTicks = static_cast<ULONGLONG>(info->idle) * 10000ULL;  // milliseconds
+    }
+    XFree(info);
+    return ok;
+}
+
+#else
+
+IdleMonitor::~IdleMonitor() = default;
+
+bool IdleMonitor::GetIdleTicks(ULONGLONG& /*idleTicks*/) {
+    return false;
+}
+
+#endif
+
+} // namespace Everon
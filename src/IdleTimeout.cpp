@@ -0,0 +1,24 @@
+#include "IdleTimeout.h"
+#include "Settings.h"
+
+namespace Everon {
+namespace IdleTimeout {
+
+DWORD AdaptivePeriodSec(ULONGLONG timeoutTicks, ULONGLONG jitterTicks) noexcept {
+    constexpr ULONGLONG kTicksPerSec = 10000000ULL;
+    constexpr ULONGLONG kMinMargin = 10ULL * kTicksPerSec;
+
+    const ULONGLONG margin = (timeoutTicks / 5 > kMinMargin ? timeoutTicks / 5 : kMinMargin) + jitterTicks;
+    const ULONGLONG period = timeoutTicks > margin ? timeoutTicks - margin : timeoutTicks / 2;
+
+    ULONGLONG seconds = period / kTicksPerSec;
+    if (seconds < Settings::MIN_PERIOD_SEC) {
+        seconds = Settings::MIN_PERIOD_SEC;
+    } else if (seconds > Settings::MAX_PERIOD_SEC) {
+        seconds = Settings::MAX_PERIOD_SEC;
+    }
+    return static_cast<DWORD>(seconds);
+}
+
+} // namespace IdleTimeout
+} // namespace Everon
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Platform.h"
+
+namespace Everon {
+
+// The OS inactivity timeouts the keypress has to beat, for the adaptive period.
+// Windows: screen saver, the InactivityTimeoutSecs lock policy, and the active power
+// scheme's display-off and sleep timeouts for the current power source. Linux: the X11
+// screen saver and DPMS timeouts, and logind's IdleActionUSec (unless IdleAction=ignore).
+namespace IdleTimeout {
+
+// Shortest configured timeout. False if none is set (or none could be read).
+bool Query(ULONGLONG& timeoutTicks);
+
+// Keypress period just under `timeoutTicks`: a margin of a fifth of the timeout (at least
+// 10 s) absorbs coalescing tolerance and timer lateness, plus the configured jitter.
+// Clamped to the Settings period range.
+DWORD AdaptivePeriodSec(ULONGLONG timeoutTicks, ULONGLONG jitterTicks) noexcept;
+
+} // namespace IdleTimeout
+} // namespace Everon
@@ -0,0 +1,114 @@
+#include "IdleTimeout.h"
+#include "DBusConnection.h"
+#include <initializer_list>
+#include <string>
+
+#ifdef EVERON_HAVE_X11
+#include <X11/Xlib.h>
+#endif
+#ifdef EVERON_HAVE_DPMS
+// Xmd.h's BOOL clashes with the Platform.h shim; keep X's under another name.
+#define BOOL XBOOL
+#include <X11/extensions/dpms.h>
+#undef BOOL
+#endif
+
+namespace Everon {
+namespace IdleTimeout {
+
+namespace {
+
+constexpr ULONGLONG kTicksPerSec = 10000000ULL;
+
+void KeepShortest(ULONGLONG& shortest, ULONGLONG candidate) noexcept {
+    if (candidate != 0 && (shortest == 0 || candidate < shortest)) {
+        shortest = candidate;
+    }
+}
+
+bool GetLogindProperty(DBusConnection& bus, const char* name, DBusMessage& reply) {
+    DBusMessage call = DBusMessage::CreateMethodCall("org.freedesktop.login1", "/org/freedesktop/login1",
+                                                     "org.freedesktop.DBus.Properties", "Get");
+    call.AppendString("org.freedesktop.login1.Manager");
+    call.AppendString(name);
+    return bus.Call(call, reply);
+}
+
+// logind's own idle action (suspend, lock, ...) after IdleActionUSec without input.
+ULONGLONG QueryLogind() {
+    DBusConnection bus;
+    if (!bus.Connect(DBusConnection::SystemBusAddress())) {
+        return 0;
+    }
+
+    DBusMessage reply;
+    char type = 0;
+    std::string action;
+    if (!GetLogindProperty(bus, "IdleAction", reply) || !reply.ReadVariant(type) ||
+        !reply.ReadString(action) || action == "ignore") {
+        return 0;
+    }
+
+    uint64_t usec = 0;
+    if (!GetLogindProperty(bus, "IdleActionUSec", reply) || !reply.ReadVariant(type) ||
+        !reply.ReadUint64(usec)) {
+        return 0;
+    }
+    return static_cast<ULONGLONG>(usec) * 10ULL;
+}
+
+ULONGLONG QueryX11() {
+    ULONGLONG shortest = 0;
+#ifdef EVERON_HAVE_X11
+    Display* display = XOpenDisplay(nullptr);
+    if (!display) {
+        return 0;
+    }
+
+    int timeout = 0;
+    int interval = 0;
+    int preferBlanking = 0;
+    int allowExposures = 0;
+    XGetScreenSaver(display, &timeout, &interval, &preferBlanking, &allowExposures);
+    if (timeout > 0) {
+        KeepShortest(shortest, static_cast<ULONGLONG>(timeout) * kTicksPerSec);
+    }
+
+#ifdef EVERON_HAVE_DPMS
+    int eventBase = 0;
+    int errorBase = 0;
+    CARD16 level = 0;
+    XBOOL enabled = False;
+    if (DPMSQueryExtension(display, &eventBase, &errorBase) && DPMSCapable(display) &&
+        DPMSInfo(display, &level, &enabled) && enabled) {
+        CARD16 standby = 0;
+        CARD16 suspend = 0;
+        CARD16 off = 0;
+        if (DPMSGetTimeouts(display, &standby, &suspend, &off)) {
+            for (const CARD16 seconds : { standby, suspend, off }) {
+                KeepShortest(shortest, static_cast<ULONGLONG>(seconds) * kTicksPerSec);
+            }
+        }
+    }
+#endif
+
+    XCloseDisplay(display);
+#endif
+    return shortest;
+}
+
+} // namespace
+
+bool Query(ULONGLONG& timeoutTicks) {
+    ULONGLONG shortest = 0;
+    KeepShortest(shortest, QueryX11());
+    KeepShortest(shortest, QueryLogind());
+    if (shortest == 0) {
+        return false;
+    }
+    timeoutTicks = shortest;
+    return true;
+}
+
+} // namespace IdleTimeout
+} // namespace Everon
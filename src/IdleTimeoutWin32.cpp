@@ -0,0 +1,74 @@
+#include "IdleTimeout.h"
+#include <powrprof.h>
+
+#pragma comment(lib, "powrprof.lib")
+
+namespace Everon {
+namespace IdleTimeout {
+
+namespace {
+
+constexpr ULONGLONG kTicksPerSec = 10000000ULL;
+
+void KeepShortest(ULONGLONG& shortest, ULONGLONG candidate) noexcept {
+    if (candidate != 0 && (shortest == 0 || candidate < shortest)) {
+        shortest = candidate;
+    }
+}
+
+// Timeout in seconds from the active power scheme for the current power source (0 = never).
+DWORD ReadPowerTimeout(const GUID* subgroup, const GUID* setting) {
+    GUID* scheme = nullptr;
+    if (PowerGetActiveScheme(nullptr, &scheme) != ERROR_SUCCESS) {
+        return 0;
+    }
+
+    SYSTEM_POWER_STATUS status = {};
+    const bool onBattery = GetSystemPowerStatus(&status) && status.ACLineStatus == 0;
+
+    DWORD seconds = 0;
+    const DWORD result = onBattery
+        ? PowerReadDCValueIndex(nullptr, scheme, subgroup, setting, &seconds)
+        : PowerReadACValueIndex(nullptr, scheme, subgroup, setting, &seconds);
+    LocalFree(scheme);
+    return result == ERROR_SUCCESS ? seconds : 0;
+}
+
+// Machine inactivity limit ("Interactive logon: Machine inactivity limit"): locks the session.
+DWORD ReadInactivityPolicy() {
+    DWORD seconds = 0;
+    DWORD size = sizeof(seconds);
+    if (RegGetValueW(HKEY_LOCAL_MACHINE, L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Policies\\System",
+                     L"InactivityTimeoutSecs", RRF_RT_REG_DWORD, nullptr, &seconds, &size) != ERROR_SUCCESS) {
+        return 0;
+    }
+    return seconds;
+}
+
+} // namespace
+
+bool Query(ULONGLONG& timeoutTicks) {
+    ULONGLONG shortest = 0;
+
+    BOOL screenSaverActive = FALSE;
+    UINT screenSaverSec = 0;
+    if (SystemParametersInfoW(SPI_GETSCREENSAVEACTIVE, 0, &screenSaverActive, 0) && screenSaverActive &&
+        SystemParametersInfoW(SPI_GETSCREENSAVETIMEOUT, 0, &screenSaverSec, 0)) {
+        KeepShortest(shortest, static_cast<ULONGLONG>(screenSaverSec) * kTicksPerSec);
+    }
+
+    KeepShortest(shortest, static_cast<ULONGLONG>(ReadInactivityPolicy()) * kTicksPerSec);
+    KeepShortest(shortest, static_cast<ULONGLONG>(
+        ReadPowerTimeout(&GUID_VIDEO_SUBGROUP, &GUID_VIDEO_POWERDOWN_TIMEOUT)) * kTicksPerSec);
+    KeepShortest(shortest, static_cast<ULONGLONG>(
+        ReadPowerTimeout(&GUID_SLEEP_SUBGROUP, &GUID_STANDBY_TIMEOUT)) * kTicksPerSec);
+
+    if (shortest == 0) {
+        return false;
+    }
+    timeoutTicks = shortest;
+    return true;
+}
+
+} // namespace IdleTimeout
+} // namespace Everon
@@ -0,0 +1,302 @@
+#include "KeepAwake.h"
+#include <algorithm>
+#include <utility>
+
+namespace Everon {
+
+double KeepAwakeStats::CallsPerHour(ULONGLONG nowMonotonic) const noexcept {
+    constexpr double kTicksPerHour = 3600.0 * 10000000.0;
+    const ULONGLONG elapsed = nowMonotonic > sinceMonotonic ? nowMonotonic - sinceMonotonic : 0;
+    return elapsed ? static_cast<double>(osCalls) * kTicksPerHour / static_cast<double>(elapsed) : 0.0;
+}
+
+template <typename Fn>
+bool KeepAwakeStrategy::Measure(Fn&& fn) {
+    const ULONGLONG start = Platform::GetThreadCpuTicks();
+    const bool ok = fn();
+    m_stats.cpuTicks += Platform::GetThreadCpuTicks() - start;
+    if (!ok) {
+        ++m_stats.failures;
+    }
+    return ok;
+}
+
+bool KeepAwakeStrategy::Probe() {
+    if (m_stats.sinceMonotonic == 0) {
+        m_stats.sinceMonotonic = Platform::GetMonotonicTicks();
+    }
+    m_available = Measure([this]() { return DoProbe(); });
+    m_probed = true;
+    return m_available;
+}
+
+bool KeepAwakeStrategy::Acquire(bool keepDisplayOn) {
+    const bool wasHeld = m_held;
+    m_held = Measure([this, keepDisplayOn]() { return DoAcquire(keepDisplayOn); });
+    if (wasHeld && !m_held) {
+        // A failed mode switch may leave the previous hold in place; Release() would no
+        // longer see it, and the engine is about to fall back to another strategy.
+        Measure([this]() { DoRelease(); return true; });
+    }
+    if (!m_probed) {
+        m_probed = true;
+        m_available = m_held;
+    }
+    if (m_held) {
+        ++m_stats.holds;
+    }
+    return m_held;
+}
+
+void KeepAwakeStrategy::Release() {
+    if (!m_held) {
+        return;
+    }
+    Measure([this]() { DoRelease(); return true; });
+    m_held = false;
+}
+
+bool KeepAwakeStrategy::Pulse(WORD virtualKey) {
+    const bool ok = Measure([this, virtualKey]() { return DoPulse(virtualKey); });
+    if (!m_probed) {
+        m_probed = true;
+        m_available = ok;
+    }
+    if (ok) {
+        ++m_stats.pulses;
+    }
+    return ok;
+}
+
+VerifyResult KeepAwakeStrategy::Verify(bool keepDisplayOn) {
+    if (!m_held) {
+        return VerifyResult::Unknown;
+    }
+    const ULONGLONG start = Platform::GetThreadCpuTicks();
+    const VerifyResult result = DoVerify(keepDisplayOn);
+    m_stats.cpuTicks += Platform::GetThreadCpuTicks() - start;
+    return result;
+}
+
+void KeepAwakeStrategy::ResetStats(ULONGLONG nowMonotonic) noexcept {
+    m_stats = KeepAwakeStats();
+    m_stats.sinceMonotonic = nowMonotonic;
+}
+
+KeepAwakeEngine::KeepAwakeEngine(std::vector<std::unique_ptr<KeepAwakeStrategy>> strategies)
+    : m_strategies(std::move(strategies)) {
+}
+
+void KeepAwakeEngine::SortByCost() {
+    std::stable_sort(m_strategies.begin(), m_strategies.end(), [](const auto& a, const auto& b) {
+        return a->GetCost() < b->GetCost();
+    });
+}
+
+void KeepAwakeEngine::Probe() {
+    SortByCost();
+    for (const auto& strategy : m_strategies) {
+        const bool ok = strategy->Probe();
+        Utils::DebugLog(L"[Everon] Keep-awake strategy %ls: %ls\n", strategy->GetName(),
+                        ok ? L"available" : L"unavailable");
+    }
+    m_holder = Select(KeepAwakeStrategy::Kind::Hold, nullptr);
+    m_pulser = Select(KeepAwakeStrategy::Kind::Pulse, nullptr);
+    m_displayHolder = Select(KeepAwakeStrategy::Kind::Hold, nullptr, true);
+    Utils::DebugLog(L"[Everon] Keep-awake: hold via %ls, pulse via %ls\n",
+                    m_holder ? m_holder->GetName() : L"(none)", m_pulser ? m_pulser->GetName() : L"(none)");
+}
+
+void KeepAwakeEngine::ProbeOnDemand() {
+    SortByCost();
+    m_onDemand = true;
+    m_holder = nullptr;
+    m_pulser = nullptr;
+    m_displayHolder = nullptr;
+}
+
+KeepAwakeStrategy* KeepAwakeEngine::Select(KeepAwakeStrategy::Kind kind, const KeepAwakeStrategy* after,
+                                            bool forDisplay) const noexcept {
+    bool passed = (after == nullptr);
+    for (const auto& strategy : m_strategies) {
+        if (!passed) {
+            passed = (strategy.get() == after);
+            continue;
+        }
+        if (strategy->GetKind() != kind) {
+            continue;
+        }
+        if (kind == KeepAwakeStrategy::Kind::Hold && !(forDisplay ? strategy->HoldsDisplay() : strategy->HoldsSystem())) {
+            continue;
+        }
+        // On demand, a strategy not tried yet is a candidate: its first use probes it.
+        if (strategy->IsAvailable() || (m_onDemand && !strategy->IsProbed())) {
+            return strategy.get();
+        }
+    }
+    return nullptr;
+}
+
+bool KeepAwakeEngine::Hold(bool keepDisplayOn) {
+    // Fall back along the cost order until one strategy holds; after all of them failed
+    // once, a new hold starts over from the cheapest.
+    m_verifyInterval = VERIFY_MIN_INTERVAL;
+    m_wanted = true;
+    m_keepDisplayOn = keepDisplayOn;
+    m_holding = false;
+    if (!m_holder) {
+        m_holder = Select(KeepAwakeStrategy::Kind::Hold, nullptr);
+    }
+    while (m_holder) {
+        if (m_holder->Acquire(keepDisplayOn)) {
+            m_holding = true;
+            break;
+        }
+        Utils::DebugLog(L"[Everon] Keep-awake strategy %ls failed, falling back\n", m_holder->GetName());
+        m_holder = Select(KeepAwakeStrategy::Kind::Hold, m_holder);
+    }
+
+    if (keepDisplayOn && !(m_holding && m_holder->HoldsDisplay())) {
+        HoldDisplay();
+    } else {
+        ReleaseDisplay();
+    }
+    return m_holding;
+}
+
+void KeepAwakeEngine::HoldDisplay() {
+    m_displayHolding = false;
+    if (!m_displayHolder) {
+        m_displayHolder = Select(KeepAwakeStrategy::Kind::Hold, nullptr, true);
+    }
+    while (m_displayHolder) {
+        // The system holder already failed (or does not do displays): not it again.
+        if (m_displayHolder != m_holder) {
+            if (m_displayHolder->Acquire(true)) {
+                m_displayHolding = true;
+                return;
+            }
+            Utils::DebugLog(L"[Everon] Keep-awake strategy %ls failed, falling back\n", m_displayHolder->GetName());
+        }
+        m_displayHolder = Select(KeepAwakeStrategy::Kind::Hold, m_displayHolder, true);
+    }
+}
+
+void KeepAwakeEngine::ReleaseDisplay() {
+    if (m_displayHolding && m_displayHolder != m_holder) {
+        m_displayHolder->Release();
+    }
+    m_displayHolding = false;
+}
+
+bool KeepAwakeEngine::IsDisplayHeld() const noexcept {
+    return m_keepDisplayOn && ((m_holding && m_holder->HoldsDisplay()) || m_displayHolding);
+}
+
+void KeepAwakeEngine::Release() {
+    if (m_holder) {
+        m_holder->Release();
+    }
+    ReleaseDisplay();
+    m_wanted = false;
+    m_holding = false;
+}
+
+bool KeepAwakeEngine::Pulse(WORD virtualKey) {
+    if (!m_pulser) {
+        m_pulser = Select(KeepAwakeStrategy::Kind::Pulse, nullptr);
+    }
+    while (m_pulser) {
+        if (m_pulser->Pulse(virtualKey)) {
+            return true;
+        }
+        Utils::DebugLog(L"[Everon] Keep-awake strategy %ls failed, falling back\n", m_pulser->GetName());
+        m_pulser = Select(KeepAwakeStrategy::Kind::Pulse, m_pulser);
+    }
+    return false;
+}
+
+VerifyResult KeepAwakeEngine::Verify() {
+    if (!m_wanted) {
+        return VerifyResult::Unknown;
+    }
+
+    ++m_verifyStats.checks;
+    // A hold that could not be re-asserted last time counts as still overridden.
+    const VerifyResult system = (m_holding && m_holder) ? m_holder->Verify(m_keepDisplayOn)
+                                                        : VerifyResult::Overridden;
+    VerifyResult display = VerifyResult::Honoured;
+    if (m_keepDisplayOn && !(m_holding && m_holder->HoldsDisplay())) {
+        display = m_displayHolding ? m_displayHolder->Verify(true) : VerifyResult::Overridden;
+    }
+    // Honoured only if every part is; overridden if any part is.
+    VerifyResult result = system;
+    if (display == VerifyResult::Overridden || (display == VerifyResult::Unknown && system == VerifyResult::Honoured)) {
+        result = display;
+    }
+    switch (result) {
+        case VerifyResult::Honoured:
+            ++m_verifyStats.honoured;
+            m_verifyInterval = (std::min)(m_verifyInterval * 2, VERIFY_MAX_INTERVAL);
+            break;
+        case VerifyResult::Unknown:
+            ++m_verifyStats.unknown;
+            m_verifyInterval = VERIFY_MAX_INTERVAL;
+            break;
+        case VerifyResult::Overridden:
+            ++m_verifyStats.overridden;
+            ++m_verifyStats.reasserts;
+            if (system == VerifyResult::Overridden) {
+                Utils::DebugLog(L"[Everon] Keep-awake hold via %ls was overridden, re-asserting\n",
+                                m_holder ? m_holder->GetName() : L"(none)");
+                if (m_holder) {
+                    m_holder->Release();
+                }
+            }
+            if (display == VerifyResult::Overridden) {
+                Utils::DebugLog(L"[Everon] Display hold via %ls was overridden, re-asserting\n",
+                                m_displayHolding ? m_displayHolder->GetName() : L"(none)");
+                ReleaseDisplay();
+            }
+            {
+                const ULONGLONG previous = m_verifyInterval;
+                if (!Hold(m_keepDisplayOn)) {
+                    // Retry on the backoff rather than every minute.
+                    ++m_verifyStats.reassertFailures;
+                    m_verifyInterval = (std::min)(previous * 2, VERIFY_MAX_INTERVAL);
+                }
+            }
+            break;
+    }
+    return result;
+}
+
+void KeepAwakeEngine::LogStatistics() const {
+    const ULONGLONG now = Platform::GetMonotonicTicks();
+    if (m_verifyStats.checks != 0) {
+        Utils::DebugLog(L"[Everon] Hold verification: %llu checks, %llu honoured, %llu overridden, %llu unknown, "
+                        L"%llu re-asserts (%llu failed), next in %llus\n",
+                        static_cast<unsigned long long>(m_verifyStats.checks),
+                        static_cast<unsigned long long>(m_verifyStats.honoured),
+                        static_cast<unsigned long long>(m_verifyStats.overridden),
+                        static_cast<unsigned long long>(m_verifyStats.unknown),
+                        static_cast<unsigned long long>(m_verifyStats.reasserts),
+                        static_cast<unsigned long long>(m_verifyStats.reassertFailures),
+                        static_cast<unsigned long long>(m_verifyInterval / 10000000ULL));
+    }
+    for (const auto& strategy : m_strategies) {
+        const KeepAwakeStats& stats = strategy->GetStats();
+        if (stats.osCalls == 0 && stats.failures == 0) {
+            continue;
+        }
+        Utils::DebugLog(L"[Everon] %ls: %.1f calls/h, %llu calls, %llu failures, %llu holds, %llu pulses, cpu %lluus\n",
+                        strategy->GetName(), stats.CallsPerHour(now),
+                        static_cast<unsigned long long>(stats.osCalls),
+                        static_cast<unsigned long long>(stats.failures),
+                        static_cast<unsigned long long>(stats.holds),
+                        static_cast<unsigned long long>(stats.pulses),
+                        static_cast<unsigned long long>(stats.cpuTicks / 10));
+    }
+}
+
+} // namespace Everon
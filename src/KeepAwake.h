@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Platform.h"
+#include <memory>
+#include <vector>
+
+namespace Everon {
+
+// Per-strategy overhead counters, for comparing mechanisms on a given OS image.
+struct KeepAwakeStats {
+    ULONGLONG osCalls = 0;      // system/library calls made (syscalls, D-Bus round trips)
+    ULONGLONG failures = 0;     // operations that did not succeed
+    ULONGLONG cpuTicks = 0;     // thread CPU time spent inside the strategy (100 ns)
+    ULONGLONG holds = 0;        // successful Acquire() calls
+    ULONGLONG pulses = 0;       // successful Pulse() calls
+    ULONGLONG sinceMonotonic = 0;
+
+    // OS calls per hour of wall time since `sinceMonotonic`.
+    double CallsPerHour(ULONGLONG nowMonotonic) const noexcept;
+};
+
+// Outcome of checking that the OS still honours a held request.
+enum class VerifyResult {
+    Honoured,       // the OS reports the request in force
+    Overridden,     // the OS no longer reports it (policy, another tool, service restart)
+    Unknown         // the mechanism offers no way to ask
+};
+
+// Verification outcomes, for the statistics log.
+struct VerifyStats {
+    ULONGLONG checks = 0;
+    ULONGLONG honoured = 0;
+    ULONGLONG overridden = 0;
+    ULONGLONG unknown = 0;
+    ULONGLONG reasserts = 0;            // holds taken again after an override
+    ULONGLONG reassertFailures = 0;
+};
+
+// One way of keeping the machine (and optionally the display) awake.
+// Hold strategies keep an OS request open between Acquire() and Release() (execution
+// state, power request, inhibitor lock); pulse strategies must be repeated within the
+// idle timeout (key injection, screen saver reset). The public calls are timed and
+// counted; implementations report the OS calls they make through AddCalls().
+class KeepAwakeStrategy {
+public:
+    enum class Kind {
+        Hold,
+        Pulse
+    };
+
+    virtual ~KeepAwakeStrategy() = default;
+
+    virtual const wchar_t* GetName() const noexcept = 0;
+    virtual Kind GetKind() const noexcept = 0;
+    // Static cost rank (lower is cheaper): OS calls per hour of keeping awake.
+    virtual unsigned GetCost() const noexcept = 0;
+    // What a hold keeps awake. One that does not hold the system is only taken next to
+    // one that does, to keep the display on; one that does not hold the display gets
+    // such a partner when the display must stay on.
+    virtual bool HoldsSystem() const noexcept { return true; }
+    virtual bool HoldsDisplay() const noexcept { return true; }
+
+    // Checks the mechanism works here, leaving nothing held.
+    bool Probe();
+    bool Acquire(bool keepDisplayOn);
+    void Release();
+    bool Pulse(WORD virtualKey);
+    // Asks the OS whether the held request is still in force (Unknown when not held).
+    VerifyResult Verify(bool keepDisplayOn);
+
+    bool IsAvailable() const noexcept { return m_available; }
+    // Probed, or (on demand) used once: IsAvailable() is known.
+    bool IsProbed() const noexcept { return m_probed; }
+    bool IsHeld() const noexcept { return m_held; }
+    const KeepAwakeStats& GetStats() const noexcept { return m_stats; }
+    void ResetStats(ULONGLONG nowMonotonic) noexcept;
+
+protected:
+    virtual bool DoProbe() = 0;
+    virtual bool DoAcquire(bool /*keepDisplayOn*/) { return false; }
+    virtual void DoRelease() {}
+    virtual bool DoPulse(WORD /*virtualKey*/) { return false; }
+    virtual VerifyResult DoVerify(bool /*keepDisplayOn*/) { return VerifyResult::Unknown; }
+
+    void AddCalls(ULONGLONG count = 1) noexcept { m_stats.osCalls += count; }
+
+private:
+    template <typename Fn>
+    bool Measure(Fn&& fn);
+
+    KeepAwakeStats m_stats;
+    bool m_available = false;
+    bool m_probed = false;
+    bool m_held = false;
+};
+
+// Platform strategies (KeepAwakeWin32.cpp / KeepAwakePosix.cpp).
+std::vector<std::unique_ptr<KeepAwakeStrategy>> CreateKeepAwakeStrategies();
+
+// Picks the cheapest working hold and pulse strategies and falls back to the next one
+// when the chosen strategy stops working. A display hold whose system holder cannot
+// keep the display on is completed by a second, display-only hold.
+class KeepAwakeEngine {
+public:
+    KeepAwakeEngine() = default;
+    explicit KeepAwakeEngine(std::vector<std::unique_ptr<KeepAwakeStrategy>> strategies);
+
+    // Probes every strategy (once at start-up) and selects the cheapest working ones.
+    void Probe();
+    // Probes nothing up front: each strategy is tried in cost order when first needed.
+    // For short-lived holders, where probing everything would cost more than the hold.
+    void ProbeOnDemand();
+
+    // True if system sleep is held off. The display part may hold without it (a machine
+    // with nothing but display-side mechanisms): see IsDisplayHeld().
+    bool Hold(bool keepDisplayOn);
+    void Release();
+    bool Pulse(WORD virtualKey);
+
+    // Checks the current hold is still honoured and takes it again if the OS dropped it
+    // (or if it could not be taken before).
+    // Meant to run every GetVerifyInterval(): the interval doubles after each check that
+    // finds the hold in force (up to VERIFY_MAX_INTERVAL), jumps to the maximum when the
+    // mechanism cannot be checked, and drops back to VERIFY_MIN_INTERVAL after an
+    // override or a new hold.
+    VerifyResult Verify();
+    ULONGLONG GetVerifyInterval() const noexcept { return m_verifyInterval; }
+    const VerifyStats& GetVerifyStats() const noexcept { return m_verifyStats; }
+
+    static constexpr ULONGLONG VERIFY_MIN_INTERVAL = 60ULL * 10000000ULL;      // 1 min
+    static constexpr ULONGLONG VERIFY_MAX_INTERVAL = 3600ULL * 10000000ULL;    // 1 h
+
+    bool IsHolding() const noexcept { return m_holding; }
+    bool IsDisplayHeld() const noexcept;
+    KeepAwakeStrategy* GetHolder() const noexcept { return m_holder; }
+    KeepAwakeStrategy* GetDisplayHolder() const noexcept { return m_displayHolding ? m_displayHolder : nullptr; }
+    KeepAwakeStrategy* GetPulser() const noexcept { return m_pulser; }
+    const std::vector<std::unique_ptr<KeepAwakeStrategy>>& GetStrategies() const noexcept { return m_strategies; }
+
+    void LogStatistics() const;
+
+private:
+    void SortByCost();
+    // Hold candidates must hold the system, or with `forDisplay` the display.
+    KeepAwakeStrategy* Select(KeepAwakeStrategy::Kind kind, const KeepAwakeStrategy* after,
+                              bool forDisplay = false) const noexcept;
+    void HoldDisplay();
+    void ReleaseDisplay();
+
+    std::vector<std::unique_ptr<KeepAwakeStrategy>> m_strategies;
+    KeepAwakeStrategy* m_holder = nullptr;
+    KeepAwakeStrategy* m_pulser = nullptr;
+    KeepAwakeStrategy* m_displayHolder = nullptr;   // keeps the display on for m_holder
+    bool m_displayHolding = false;
+    bool m_onDemand = false;        // ProbeOnDemand(): untried strategies are candidates
+    bool m_wanted = false;          // between Hold() and Release(), even if holding failed
+    bool m_holding = false;
+    bool m_keepDisplayOn = false;
+    ULONGLONG m_verifyInterval = VERIFY_MIN_INTERVAL;
+    VerifyStats m_verifyStats;
+};
+
+} // namespace Everon
@@ -0,0 +1,399 @@
+#include "KeepAwake.h"
+#include "DBusConnection.h"
+#include "LogindInhibitor.h"
+#include <cstdint>
+#include <string>
+
+#ifdef EVERON_HAVE_X11
+#include <X11/Xlib.h>
+#endif
+#ifdef EVERON_HAVE_DPMS
+// Xmd.h's BOOL clashes with the Platform.h shim; keep X's under another name.
+#define BOOL XBOOL
+#include <X11/extensions/dpms.h>
+#undef BOOL
+#endif
+#ifdef EVERON_HAVE_XTEST
+#include <X11/keysym.h>
+#include <X11/extensions/XTest.h>
+#endif
+
+namespace Everon {
+
+namespace {
+
+#ifdef EVERON_HAVE_X11
+
+// Owning X display connection; each strategy keeps its own.
+class X11Display {
+public:
+    X11Display() = default;
+    ~X11Display() { Reset(); }
+
+    X11Display(X11Display&& other) noexcept : m_display(other.m_display) { other.m_display = nullptr; }
+    X11Display& operator=(X11Display&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            m_display = other.m_display;
+            other.m_display = nullptr;
+        }
+        return *this;
+    }
+
+    static X11Display Open() {
+        X11Display display;
+        display.m_display = XOpenDisplay(nullptr);
+        return display;
+    }
+
+    Display* get() const noexcept { return m_display; }
+    explicit operator bool() const noexcept { return m_display != nullptr; }
+
+private:
+    void Reset() noexcept {
+        if (m_display) {
+            XCloseDisplay(m_display);
+            m_display = nullptr;
+        }
+    }
+
+    Display* m_display = nullptr;
+};
+
+#endif
+
+// systemd-logind inhibitor lock: one D-Bus call returns a descriptor; the lock holds
+// until it is closed, with no ongoing cost. It cannot keep the display from blanking,
+// so display holds pair it with ScreenSaverInhibit or X11DisplayHold.
+class LogindInhibitStrategy final : public KeepAwakeStrategy {
+public:
+    const wchar_t* GetName() const noexcept override { return L"LogindInhibit"; }
+    Kind GetKind() const noexcept override { return Kind::Hold; }
+    unsigned GetCost() const noexcept override { return 10; }
+    bool HoldsDisplay() const noexcept override { return false; }
+
+protected:
+    bool DoProbe() override {
+        if (!DoAcquire(false)) {
+            return false;
+        }
+        DoRelease();
+        return true;
+    }
+
+    bool DoAcquire(bool keepDisplayOn) override {
+        const unsigned before = m_inhibitor.GetCallCount();
+        const bool ok = m_inhibitor.Acquire(keepDisplayOn);
+        AddCalls(m_inhibitor.GetCallCount() - before);
+        return ok;
+    }
+
+    void DoRelease() override {
+        if (m_inhibitor.IsHeld()) {
+            AddCalls();
+            m_inhibitor.Release();
+        }
+    }
+
+    VerifyResult DoVerify(bool keepDisplayOn) override {
+        // A restarted logind forgets every lock; so does one that was told to ignore ours.
+        const unsigned before = m_inhibitor.GetCallCount();
+        std::string blocked;
+        const bool ok = m_inhibitor.QueryBlockInhibited(blocked);
+        AddCalls(m_inhibitor.GetCallCount() - before);
+        if (!ok) {
+            return VerifyResult::Unknown;
+        }
+        return LogindInhibitor::Covers(blocked, keepDisplayOn) ? VerifyResult::Honoured : VerifyResult::Overridden;
+    }
+
+private:
+    LogindInhibitor m_inhibitor;
+};
+
+// org.freedesktop.ScreenSaver.Inhibit on the session bus: the desktop's own idle
+// inhibitor (GNOME, KDE and others, on X11 and Wayland alike). It blocks blanking and
+// idle suspend for as long as this connection stays on the bus, so the connection is
+// kept open while held. The interface has no sleep-only lock: a system-only hold here
+// keeps the display on as well, which is why the cheaper logind lock comes first.
+class ScreenSaverInhibitStrategy final : public KeepAwakeStrategy {
+public:
+    ~ScreenSaverInhibitStrategy() override { DoRelease(); }
+
+    const wchar_t* GetName() const noexcept override { return L"ScreenSaverInhibit"; }
+    Kind GetKind() const noexcept override { return Kind::Hold; }
+    unsigned GetCost() const noexcept override { return 20; }
+
+protected:
+    bool DoProbe() override {
+        if (!DoAcquire(true)) {
+            return false;
+        }
+        DoRelease();
+        return true;
+    }
+
+    bool DoAcquire(bool /*keepDisplayOn*/) override {
+        if (m_bus.IsConnected()) {
+            return true;
+        }
+
+        const std::string address = DBusConnection::SessionBusAddress();
+        AddCalls(2);   // connect + Hello
+        if (address.empty() || !m_bus.Connect(address)) {
+            return false;
+        }
+
+        DBusMessage call = MakeCall("Inhibit");
+        call.AppendString("Everon");
+        call.AppendString("Keeping the system awake");
+        DBusMessage reply;
+        AddCalls();
+        if (!m_bus.Call(call, reply) || !reply.ReadUint32(m_cookie)) {
+            m_bus.Close();
+            return false;
+        }
+        return true;
+    }
+
+    void DoRelease() override {
+        if (!m_bus.IsConnected()) {
+            return;
+        }
+        DBusMessage call = MakeCall("UnInhibit");
+        call.AppendUint32(m_cookie);
+        DBusMessage reply;
+        AddCalls();
+        m_bus.Call(call, reply);
+        m_bus.Close();
+    }
+
+private:
+    static DBusMessage MakeCall(const char* member) {
+        return DBusMessage::CreateMethodCall("org.freedesktop.ScreenSaver", "/org/freedesktop/ScreenSaver",
+                                             "org.freedesktop.ScreenSaver", member);
+    }
+
+    DBusConnection m_bus;
+    uint32_t m_cookie = 0;
+};
+
+#ifdef EVERON_HAVE_X11
+
+// XResetScreenSaver: restarts the X server's screen saver/DPMS countdown, like input would.
+class X11ScreenSaverResetStrategy final : public KeepAwakeStrategy {
+public:
+    const wchar_t* GetName() const noexcept override { return L"X11ScreenSaverReset"; }
+    Kind GetKind() const noexcept override { return Kind::Pulse; }
+    unsigned GetCost() const noexcept override { return 50; }
+
+protected:
+    bool DoProbe() override {
+        return Open(m_display);
+    }
+
+    bool DoPulse(WORD /*virtualKey*/) override {
+        if (!Open(m_display)) {
+            return false;
+        }
+        AddCalls(2);
+        XResetScreenSaver(m_display.get());
+        XFlush(m_display.get());
+        return true;
+    }
+
+private:
+    bool Open(X11Display& display) {
+        if (!display) {
+            AddCalls();
+            display = X11Display::Open();
+        }
+        return static_cast<bool>(display);
+    }
+
+    X11Display m_display;
+};
+
+// Turns the X server's screen saver and DPMS off while held and restores the previous
+// settings on release. The X server has no notion of system sleep: display holds only,
+// taken next to a sleep inhibitor (see KeepAwakeEngine).
+class X11DisplayHoldStrategy final : public KeepAwakeStrategy {
+public:
+    ~X11DisplayHoldStrategy() override { DoRelease(); }
+
+    const wchar_t* GetName() const noexcept override { return L"X11DisplayHold"; }
+    Kind GetKind() const noexcept override { return Kind::Hold; }
+    unsigned GetCost() const noexcept override { return 30; }
+    bool HoldsSystem() const noexcept override { return false; }
+
+protected:
+    bool DoProbe() override {
+        if (!m_display) {
+            AddCalls();
+            m_display = X11Display::Open();
+        }
+        return static_cast<bool>(m_display);
+    }
+
+    bool DoAcquire(bool keepDisplayOn) override {
+        // Screen saver and DPMS only: nothing here stops the system from suspending, so a
+        // system-only hold must fall through to a strategy that can inhibit sleep.
+        if (!keepDisplayOn) {
+            return false;
+        }
+        if (m_applied) {
+            return true;
+        }
+        if (!DoProbe()) {
+            return false;
+        }
+
+        Display* display = m_display.get();
+        AddCalls(2);
+        XGetScreenSaver(display, &m_timeout, &m_interval, &m_preferBlanking, &m_allowExposures);
+        XSetScreenSaver(display, 0, m_interval, m_preferBlanking, m_allowExposures);
+#ifdef EVERON_HAVE_DPMS
+        int eventBase = 0;
+        int errorBase = 0;
+        CARD16 level = 0;
+        XBOOL enabled = False;
+        AddCalls(2);
+        m_dpmsWasEnabled = DPMSQueryExtension(display, &eventBase, &errorBase) && DPMSCapable(display) &&
+                           DPMSInfo(display, &level, &enabled) && enabled;
+        if (m_dpmsWasEnabled) {
+            AddCalls();
+            DPMSDisable(display);
+        }
+#endif
+        AddCalls();
+        XFlush(display);
+        m_applied = true;
+        return true;
+    }
+
+    void DoRelease() override {
+        if (!m_applied) {
+            return;
+        }
+        Display* display = m_display.get();
+        AddCalls(2);
+        XSetScreenSaver(display, m_timeout, m_interval, m_preferBlanking, m_allowExposures);
+#ifdef EVERON_HAVE_DPMS
+        if (m_dpmsWasEnabled) {
+            AddCalls();
+            DPMSEnable(display);
+        }
+#endif
+        XFlush(display);
+        m_applied = false;
+    }
+
+    VerifyResult DoVerify(bool /*keepDisplayOn*/) override {
+        // `xset s on` / `xset +dpms` or a session restoring its defaults turns them back on.
+        Display* display = m_display.get();
+        int timeout = 0;
+        int interval = 0;
+        int preferBlanking = 0;
+        int allowExposures = 0;
+        AddCalls();
+        XGetScreenSaver(display, &timeout, &interval, &preferBlanking, &allowExposures);
+        bool overridden = (timeout != 0);
+#ifdef EVERON_HAVE_DPMS
+        CARD16 level = 0;
+        XBOOL enabled = False;
+        AddCalls();
+        if (m_dpmsWasEnabled && DPMSInfo(display, &level, &enabled) && enabled) {
+            overridden = true;
+        }
+#endif
+        if (overridden) {
+            // Skip the restore in the release that precedes re-asserting: the settings now
+            // in place become the ones to restore later.
+            m_applied = false;
+        }
+        return overridden ? VerifyResult::Overridden : VerifyResult::Honoured;
+    }
+
+private:
+    X11Display m_display;
+    bool m_applied = false;         // our settings are in place, the saved ones to restore
+    int m_timeout = 0;
+    int m_interval = 0;
+    int m_preferBlanking = 0;
+    int m_allowExposures = 0;
+    bool m_dpmsWasEnabled = false;
+};
+
+#endif
+
+#ifdef EVERON_HAVE_XTEST
+
+// XTest fake key press and release: real input as far as the X server and every idle
+// watcher on it are concerned (the X11 counterpart of SendInput).
+class X11KeyInjectionStrategy final : public KeepAwakeStrategy {
+public:
+    const wchar_t* GetName() const noexcept override { return L"X11KeyInjection"; }
+    Kind GetKind() const noexcept override { return Kind::Pulse; }
+    unsigned GetCost() const noexcept override { return 60; }
+
+protected:
+    bool DoProbe() override {
+        if (!m_display) {
+            AddCalls();
+            m_display = X11Display::Open();
+        }
+        int eventBase = 0;
+        int errorBase = 0;
+        int major = 0;
+        int minor = 0;
+        AddCalls();
+        return m_display && XTestQueryExtension(m_display.get(), &eventBase, &errorBase, &major, &minor);
+    }
+
+    bool DoPulse(WORD virtualKey) override {
+        if (!m_display) {
+            return false;
+        }
+        const KeySym keysym = KeySymFromVirtualKey(virtualKey);
+        AddCalls();
+        const KeyCode keycode = keysym != NoSymbol ? XKeysymToKeycode(m_display.get(), keysym) : 0;
+        if (keycode == 0) {
+            return false;
+        }
+        AddCalls(3);
+        XTestFakeKeyEvent(m_display.get(), keycode, True, CurrentTime);
+        XTestFakeKeyEvent(m_display.get(), keycode, False, CurrentTime);
+        XFlush(m_display.get());
+        return true;
+    }
+
+private:
+    // The configurable keys are F13-F24-style virtual keys; VK_F1 is 0x70.
+    static KeySym KeySymFromVirtualKey(WORD virtualKey) noexcept {
+        constexpr WORD kVkF1 = 0x70;
+        constexpr WORD kVkF24 = 0x87;
+        return (virtualKey >= kVkF1 && virtualKey <= kVkF24) ? XK_F1 + (virtualKey - kVkF1) : NoSymbol;
+    }
+
+    X11Display m_display;
+};
+
+#endif
+
+} // namespace
+
+std::vector<std::unique_ptr<KeepAwakeStrategy>> CreateKeepAwakeStrategies() {
+    std::vector<std::unique_ptr<KeepAwakeStrategy>> strategies;
+    strategies.push_back(std::make_unique<LogindInhibitStrategy>());
+    strategies.push_back(std::make_unique<ScreenSaverInhibitStrategy>());
+#ifdef EVERON_HAVE_X11
+    strategies.push_back(std::make_unique<X11DisplayHoldStrategy>());
+    strategies.push_back(std::make_unique<X11ScreenSaverResetStrategy>());
+#endif
+#ifdef EVERON_HAVE_XTEST
+    strategies.push_back(std::make_unique<X11KeyInjectionStrategy>());
+#endif
+    return strategies;
+}
+
+} // namespace Everon
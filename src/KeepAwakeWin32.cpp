@@ -0,0 +1,224 @@
+#include "KeepAwake.h"
+#include <powrprof.h>
+
+#pragma comment(lib, "powrprof.lib")
+
+namespace Everon {
+
+namespace {
+
+// Execution state the power manager applies (every requester combined): whether the
+// system, and the display, are currently required.
+VerifyResult CheckSystemExecutionState(bool keepDisplayOn) {
+    ULONG state = 0;
+    if (CallNtPowerInformation(SystemExecutionState, nullptr, 0, &state, sizeof(state)) != 0) {
+        return VerifyResult::Unknown;
+    }
+    const ULONG required = ES_SYSTEM_REQUIRED | (keepDisplayOn ? ES_DISPLAY_REQUIRED : 0);
+    return (state & required) == required ? VerifyResult::Honoured : VerifyResult::Overridden;
+}
+
+// SetThreadExecutionState: one call per transition, nothing to clean up.
+class ExecutionStateStrategy final : public KeepAwakeStrategy {
+public:
+    const wchar_t* GetName() const noexcept override { return L"ExecutionState"; }
+    Kind GetKind() const noexcept override { return Kind::Hold; }
+    unsigned GetCost() const noexcept override { return 10; }
+
+protected:
+    bool DoProbe() override {
+        AddCalls();
+        return SetThreadExecutionState(ES_CONTINUOUS) != 0;
+    }
+
+    bool DoAcquire(bool keepDisplayOn) override {
+        EXECUTION_STATE flags = ES_CONTINUOUS | ES_SYSTEM_REQUIRED;
+        if (keepDisplayOn) {
+            flags |= ES_DISPLAY_REQUIRED;
+        }
+        AddCalls();
+        if (SetThreadExecutionState(flags) == 0) {
+            Utils::DebugLog(L"[Everon] Failed to prevent sleep: %lu\n", GetLastError());
+            return false;
+        }
+        return true;
+    }
+
+    void DoRelease() override {
+        AddCalls();
+        if (SetThreadExecutionState(ES_CONTINUOUS) == 0) {
+            Utils::DebugLog(L"[Everon] SetThreadExecutionState(ES_CONTINUOUS) failed: %lu\n", GetLastError());
+        }
+    }
+
+    VerifyResult DoVerify(bool keepDisplayOn) override {
+        AddCalls();
+        return CheckSystemExecutionState(keepDisplayOn);
+    }
+};
+
+// Power request object: visible (with its reason) in `powercfg /requests`.
+class PowerRequestStrategy final : public KeepAwakeStrategy {
+public:
+    ~PowerRequestStrategy() override { Close(); }
+
+    const wchar_t* GetName() const noexcept override { return L"PowerRequest"; }
+    Kind GetKind() const noexcept override { return Kind::Hold; }
+    unsigned GetCost() const noexcept override { return 20; }
+
+protected:
+    bool DoProbe() override {
+        if (!Open()) {
+            return false;
+        }
+        Close();
+        return true;
+    }
+
+    bool DoAcquire(bool keepDisplayOn) override {
+        if (!m_request && !Open()) {
+            return false;
+        }
+        if (!m_system) {
+            AddCalls();
+            if (!PowerSetRequest(m_request, PowerRequestSystemRequired)) {
+                Utils::DebugLog(L"[Everon] PowerSetRequest(System) failed: %lu\n", GetLastError());
+                return false;
+            }
+            m_system = true;
+        }
+        if (keepDisplayOn != m_display) {
+            AddCalls();
+            const BOOL ok = keepDisplayOn ? PowerSetRequest(m_request, PowerRequestDisplayRequired)
+                                          : PowerClearRequest(m_request, PowerRequestDisplayRequired);
+            if (!ok) {
+                Utils::DebugLog(L"[Everon] Power request (Display) failed: %lu\n", GetLastError());
+                return false;
+            }
+            m_display = keepDisplayOn;
+        }
+        return true;
+    }
+
+    void DoRelease() override {
+        Close();
+    }
+
+    VerifyResult DoVerify(bool keepDisplayOn) override {
+        AddCalls();
+        return CheckSystemExecutionState(keepDisplayOn);
+    }
+
+private:
+    bool Open() {
+        REASON_CONTEXT reason = {};
+        reason.Version = POWER_REQUEST_CONTEXT_VERSION;
+        reason.Flags = POWER_REQUEST_CONTEXT_SIMPLE_STRING;
+        reason.Reason.SimpleReasonString = const_cast<LPWSTR>(L"Everon keeps the computer awake");
+        AddCalls();
+        m_request = PowerCreateRequest(&reason);
+        if (m_request == INVALID_HANDLE_VALUE) {
+            m_request = nullptr;
+            Utils::DebugLog(L"[Everon] PowerCreateRequest failed: %lu\n", GetLastError());
+            return false;
+        }
+        return true;
+    }
+
+    void Close() {
+        if (!m_request) {
+            return;
+        }
+        // Closing the handle clears every request set on it.
+        AddCalls();
+        CloseHandle(m_request);
+        m_request = nullptr;
+        m_system = false;
+        m_display = false;
+    }
+
+    HANDLE m_request = nullptr;
+    bool m_system = false;
+    bool m_display = false;
+};
+
+// SendInput key press/release: resets the idle timers that power requests do not
+// (screen saver, lock, presence in other apps). Needs access to the input desktop.
+class KeyInjectionStrategy final : public KeepAwakeStrategy {
+public:
+    const wchar_t* GetName() const noexcept override { return L"KeyInjection"; }
+    Kind GetKind() const noexcept override { return Kind::Pulse; }
+    unsigned GetCost() const noexcept override { return 100; }
+
+protected:
+    bool DoProbe() override {
+        // Session 0 (a service) never has an input desktop to send to.
+        DWORD session = 0;
+        AddCalls();
+        if (ProcessIdToSessionId(GetCurrentProcessId(), &session) && session == 0) {
+            return false;
+        }
+        // The secure desktop and the lock screen come and go (autostart can run before
+        // logon completes): without an input desktop now, look again on the next pulse.
+        m_desktopPending = !HasInputDesktop();
+        return true;
+    }
+
+    bool DoPulse(WORD virtualKey) override {
+        if (virtualKey == 0) {
+            return false;
+        }
+        if (m_desktopPending) {
+            if (!HasInputDesktop()) {
+                return false;
+            }
+            m_desktopPending = false;
+        }
+
+        INPUT inputs[2] = {};
+
+        // Key down
+        inputs[0].type = INPUT_KEYBOARD;
+        inputs[0].ki.wVk = virtualKey;
+        inputs[0].ki.dwFlags = 0;
+
+        // Key up
+        inputs[1].type = INPUT_KEYBOARD;
+        inputs[1].ki.wVk = virtualKey;
+        inputs[1].ki.dwFlags = KEYEVENTF_KEYUP;
+
+        AddCalls();
+        const UINT sent = SendInput(2, inputs, sizeof(INPUT));
+        if (sent != 2) {
+            Utils::DebugLog(L"[Everon] SendInput failed/sent %u: %lu\n", sent, GetLastError());
+            m_desktopPending = true;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool HasInputDesktop() {
+        AddCalls(2);
+        HDESK desktop = OpenInputDesktop(0, FALSE, DESKTOP_READOBJECTS);
+        if (!desktop) {
+            return false;
+        }
+        CloseDesktop(desktop);
+        return true;
+    }
+
+    bool m_desktopPending = false;      // no input desktop when last seen: check before sending
+};
+
+} // namespace
+
+std::vector<std::unique_ptr<KeepAwakeStrategy>> CreateKeepAwakeStrategies() {
+    std::vector<std::unique_ptr<KeepAwakeStrategy>> strategies;
+    strategies.push_back(std::make_unique<ExecutionStateStrategy>());
+    strategies.push_back(std::make_unique<PowerRequestStrategy>());
+    strategies.push_back(std::make_unique<KeyInjectionStrategy>());
+    return strategies;
+}
+
+} // namespace Everon
@@ -0,0 +1,96 @@
+#include "LatencyHistogram.h"
+#include <cwchar>
+
+namespace Everon {
+
+namespace {
+
+constexpr ULONGLONG kTicksPerUs = 10ULL;
+
+double TicksToMs(ULONGLONG ticks) noexcept {
+    return static_cast<double>(ticks) / 10000.0;
+}
+
+} // namespace
+
+size_t LatencyHistogram::BucketOf(ULONGLONG ticks) noexcept {
+    ULONGLONG us = ticks / kTicksPerUs;
+    size_t bucket = 0;
+    while (us != 0 && bucket < BUCKET_COUNT - 1) {
+        us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+ULONGLONG LatencyHistogram::GetBucketUpperBound(size_t bucket) noexcept {
+    if (bucket >= BUCKET_COUNT - 1) {
+        return ~0ULL;
+    }
+    return (1ULL << bucket) * kTicksPerUs;
+}
+
+void LatencyHistogram::Record(ULONGLONG ticks) noexcept {
+    ++m_buckets[BucketOf(ticks)];
+    if (m_count == 0 || ticks < m_min) {
+        m_min = ticks;
+    }
+    if (ticks > m_max) {
+        m_max = ticks;
+    }
+    ++m_count;
+    m_sum += ticks;
+}
+
+void LatencyHistogram::Reset() noexcept {
+    *this = LatencyHistogram();
+}
+
+ULONGLONG LatencyHistogram::GetPercentile(double percentile) const noexcept {
+    if (m_count == 0) {
+        return 0;
+    }
+
+    if (percentile < 0.0) {
+        percentile = 0.0;
+    } else if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+
+    ULONGLONG rank = static_cast<ULONGLONG>(percentile / 100.0 * static_cast<double>(m_count) + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    ULONGLONG seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            const ULONGLONG bound = GetBucketUpperBound(i);
+            return bound < m_max ? bound : m_max;
+        }
+    }
+    return m_max;
+}
+
+ULONGLONG LatencyHistogram::CountAbove(ULONGLONG ticks) const noexcept {
+    if (ticks >= m_max) {
+        return 0;
+    }
+    ULONGLONG above = 0;
+    for (size_t i = BucketOf(ticks); i < BUCKET_COUNT; ++i) {
+        above += m_buckets[i];
+    }
+    return above;
+}
+
+std::wstring LatencyHistogram::Format() const {
+    wchar_t buffer[160] = {};
+    std::swprintf(buffer, sizeof(buffer) / sizeof(buffer[0]),
+                  L"n=%llu min=%.3fms p50=%.3fms p99=%.3fms max=%.3fms",
+                  static_cast<unsigned long long>(m_count), TicksToMs(GetMin()),
+                  TicksToMs(GetPercentile(50.0)), TicksToMs(GetPercentile(99.0)), TicksToMs(m_max));
+    return buffer;
+}
+
+} // namespace Everon
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstddef>
+#include <string>
+
+namespace Everon {
+
+// Fixed-size log2 histogram of latencies (100 ns ticks, bucketed in microseconds).
+// Bucket 0 holds values below 1 us, bucket i >= 1 holds [2^(i-1), 2^i) us; the last
+// bucket is open-ended. Recording is O(1) and allocation-free.
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKET_COUNT = 40;  // up to ~3 days in the last closed bucket
+
+    void Record(ULONGLONG ticks) noexcept;
+    void Reset() noexcept;
+
+    ULONGLONG GetCount() const noexcept { return m_count; }
+    ULONGLONG GetMin() const noexcept { return m_count ? m_min : 0; }
+    ULONGLONG GetMax() const noexcept { return m_max; }
+    ULONGLONG GetMean() const noexcept { return m_count ? m_sum / m_count : 0; }
+
+    // Upper bound (ticks) of the bucket holding the p-th percentile (0..100), clamped to max.
+    ULONGLONG GetPercentile(double percentile) const noexcept;
+
+    // Number of samples strictly above `ticks` (bucket resolution, conservative).
+    ULONGLONG CountAbove(ULONGLONG ticks) const noexcept;
+
+    ULONGLONG GetBucketCount(size_t bucket) const noexcept { return m_buckets[bucket]; }
+    static ULONGLONG GetBucketUpperBound(size_t bucket) noexcept;
+
+    // One-line summary in milliseconds for logs: "n=.. min=.. p50=.. p99=.. max=..".
+    std::wstring Format() const;
+
+private:
+    static size_t BucketOf(ULONGLONG ticks) noexcept;
+
+    ULONGLONG m_buckets[BUCKET_COUNT] = {};
+    ULONGLONG m_count = 0;
+    ULONGLONG m_sum = 0;
+    ULONGLONG m_min = 0;
+    ULONGLONG m_max = 0;
+};
+
+} // namespace Everon
@@ -48,7 +48,7 @@ static const wchar_t* const kStrings[kStrCount][kLangCount] = {
     { L"Indefinitely", L"Бесконечно", L"Indéfiniment", L"Unbegrenzt", L"Indefinitamente", L"Indefinidamente" }, // SettingsTimerIndefinite
     { L"For duration:", L"На время:", L"Pour durée:", L"Für Dauer:", L"Per durata:", L"Por duración:" }, // SettingsTimerDuration
     { L"Until time:", L"До времени:", L"Jusqu'à:", L"Bis:", L"Fino a:", L"Hasta:" }, // SettingsTimerUntilTime
-    { L"minutes (5-1440)", L"минут (5-1440)", L"minutes (5-1440)", L"Minuten (5-1440)", L"minuti (5-1440)", L"minutos (5-1440)" }, // SettingsTimerMinutes
+    { L"minutes (5-10080)", L"минут (5-10080)", L"minutes (5-10080)", L"Minuten (5-10080)", L"minuti (5-10080)", L"minutos (5-10080)" }, // SettingsTimerMinutes
     { L"Until", L"До", L"Jusqu'à", L"Bis", L"Fino a", L"Hasta" }, // SettingsTimerUntil
 
     // Buttons
@@ -78,12 +78,12 @@ static const wchar_t* const kStrings[kStrCount][kLangCount] = {
       L"El período debe estar entre 1 y 86400 segundos.\n\n1 segundo = mínimo\n86400 segundos = 24 horas (máximo)" }, // ErrorInvalidPeriod
     { L"Invalid Period", L"Неверный период", L"Période invalide", L"Ungültige Periode", L"Periodo non valido", L"Período inválido" }, // ErrorInvalidPeriodTitle
     { L"Invalid Timer", L"Неверный таймер", L"Minuteur invalide", L"Ungültiger Timer", L"Timer non valido", L"Temporizador inválido" }, // ErrorInvalidTimerTitle
-    { L"Please enter duration between 5 and 1440 minutes.",
-      L"Введите длительность от 5 до 1440 минут.",
-      L"Veuillez saisir une durée entre 5 et 1440 minutes.",
-      L"Bitte geben Sie eine Dauer zwischen 5 und 1440 Minuten ein.",
-      L"Inserisci una durata tra 5 e 1440 minuti.",
-      L"Introduce una duración entre 5 y 1440 minutos." }, // ErrorInvalidTimerDuration
+    { L"Please enter duration between 5 and 10080 minutes.",
+      L"Введите длительность от 5 до 10080 минут.",
+      L"Veuillez saisir une durée entre 5 et 10080 minutes.",
+      L"Bitte geben Sie eine Dauer zwischen 5 und 10080 Minuten ein.",
+      L"Inserisci una durata tra 5 e 10080 minuti.",
+      L"Introduce una duración entre 5 y 10080 minutos." }, // ErrorInvalidTimerDuration
     { L"Please select a time in the future.",
       L"Выберите время в будущем.",
       L"Veuillez sélectionner une heure dans le futur.",
@@ -106,6 +106,8 @@ static const wchar_t* const kStrings[kStrCount][kLangCount] = {
     // Tooltips
     { L"Everon - Disabled", L"Everon - Отключено", L"Everon - Désactivé", L"Everon - Deaktiviert", L"Everon - Disattivato", L"Everon - Desactivado" }, // TooltipDisabled
     { L"Everon - Enabled",  L"Everon - Включено",  L"Everon - Activé",    L"Everon - Aktiviert",   L"Everon - Attivato",   L"Everon - Activado" }, // TooltipEnabled
+    { L"Display may turn off", L"Экран может выключиться", L"L'écran peut s'éteindre", L"Display darf ausgehen", L"Lo schermo può spegnersi", L"La pantalla puede apagarse" }, // TooltipSystemOnly
+    { L"Paused on battery", L"Пауза на батарее", L"En pause sur batterie", L"Pausiert im Akkubetrieb", L"In pausa a batteria", L"En pausa con batería" }, // TooltipBatteryPaused
 
     // Notifications
     { L"Everon enabled", L"Everon включен", L"Everon activé", L"Everon aktiviert", L"Everon attivato", L"Everon activado" }, // NotifyEnabled
@@ -186,17 +188,7 @@ const wchar_t* Localization::GetLanguageName(Language lang) {
 }
 
 Language Localization::DetectSystemLanguage() {
-    LANGID langId = GetUserDefaultUILanguage();
-    WORD primaryLang = PRIMARYLANGID(langId);
-
-    switch (primaryLang) {
-        case LANG_RUSSIAN:  return Language::Russian;
-        case LANG_FRENCH:   return Language::French;
-        case LANG_GERMAN:   return Language::German;
-        case LANG_ITALIAN:  return Language::Italian;
-        case LANG_SPANISH:  return Language::Spanish;
-        default:            return Language::English;
-    }
+    return StringToLanguage(Platform::GetUserLanguageCode());
 }
 
 const wchar_t* Localization::LanguageToString(Language lang) {
@@ -212,11 +204,11 @@ Language Localization::StringToLanguage(const wchar_t* str) {
         return Language::English;
     }
 
-    if (_wcsicmp(str, L"ru") == 0) return Language::Russian;
-    if (_wcsicmp(str, L"fr") == 0) return Language::French;
-    if (_wcsicmp(str, L"de") == 0) return Language::German;
-    if (_wcsicmp(str, L"it") == 0) return Language::Italian;
-    if (_wcsicmp(str, L"es") == 0) return Language::Spanish;
+    if (Platform::CompareNoCase(str, L"ru") == 0) return Language::Russian;
+    if (Platform::CompareNoCase(str, L"fr") == 0) return Language::French;
+    if (Platform::CompareNoCase(str, L"de") == 0) return Language::German;
+    if (Platform::CompareNoCase(str, L"it") == 0) return Language::Italian;
+    if (Platform::CompareNoCase(str, L"es") == 0) return Language::Spanish;
     return Language::English;
 }
 
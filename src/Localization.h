@@ -1,6 +1,6 @@
 #pragma once
 
-#include <windows.h>
+#include "Platform.h"
 
 namespace Everon {
 
@@ -76,6 +76,8 @@ enum class StringID : unsigned short {
     // Tooltips
     TooltipDisabled,
     TooltipEnabled,
+    TooltipSystemOnly,
+    TooltipBatteryPaused,
 
     // Notifications
     NotifyEnabled,
@@ -0,0 +1,96 @@
+#include "LogindInhibitor.h"
+#include "DBusConnection.h"
+#include <unistd.h>
+#include <utility>
+
+namespace Everon {
+
+LogindInhibitor::LogindInhibitor()
+    : m_busAddress(DBusConnection::SystemBusAddress()) {
+}
+
+LogindInhibitor::LogindInhibitor(std::string busAddress)
+    : m_busAddress(std::move(busAddress)) {
+}
+
+LogindInhibitor::~LogindInhibitor() {
+    Release();
+}
+
+const char* LogindInhibitor::WhatFor(bool keepDisplayOn) noexcept {
+    return keepDisplayOn ? "sleep:idle" : "sleep";
+}
+
+bool LogindInhibitor::Acquire(bool keepDisplayOn) {
+    if (m_fd >= 0 && m_keepDisplayOn == keepDisplayOn) {
+        return true;
+    }
+
+    DBusConnection bus;
+    m_calls += 2;   // connect + Hello
+    if (!bus.Connect(m_busAddress)) {
+        return false;
+    }
+
+    DBusMessage call = DBusMessage::CreateMethodCall("org.freedesktop.login1", "/org/freedesktop/login1",
+                                                     "org.freedesktop.login1.Manager", "Inhibit");
+    call.AppendString(WhatFor(keepDisplayOn));
+    call.AppendString("Everon");
+    call.AppendString("Keeping the system awake");
+    call.AppendString("block");
+    DBusMessage reply;
+    int fd = -1;
+    ++m_calls;
+    if (!bus.Call(call, reply) || !reply.ReadUnixFd(fd)) {
+        Utils::DebugLog(L"[Everon] logind Inhibit(%s) failed\n", WhatFor(keepDisplayOn));
+        return false;
+    }
+
+    // The bus connection can go: logind keeps the lock for as long as the descriptor lives.
+    Release();
+    m_fd = fd;
+    m_keepDisplayOn = keepDisplayOn;
+    return true;
+}
+
+bool LogindInhibitor::QueryBlockInhibited(std::string& what) {
+    DBusConnection bus;
+    m_calls += 3;   // connect + Hello + Get
+    if (!bus.Connect(m_busAddress)) {
+        return false;
+    }
+
+    DBusMessage call = DBusMessage::CreateMethodCall("org.freedesktop.login1", "/org/freedesktop/login1",
+                                                     "org.freedesktop.DBus.Properties", "Get");
+    call.AppendString("org.freedesktop.login1.Manager");
+    call.AppendString("BlockInhibited");
+    DBusMessage reply;
+    char type = 0;
+    return bus.Call(call, reply) && reply.ReadVariant(type) && reply.ReadString(what);
+}
+
+bool LogindInhibitor::Covers(const std::string& blocked, bool keepDisplayOn) {
+    const std::string padded = ":" + blocked + ":";
+    const std::string wanted = WhatFor(keepDisplayOn);
+    size_t start = 0;
+    while (start <= wanted.size()) {
+        size_t end = wanted.find(':', start);
+        if (end == std::string::npos) {
+            end = wanted.size();
+        }
+        if (padded.find(":" + wanted.substr(start, end - start) + ":") == std::string::npos) {
+            return false;
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+void LogindInhibitor::Release() {
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+} // namespace Everon
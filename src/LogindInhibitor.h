@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+
+namespace Everon {
+
+// systemd-logind inhibitor lock (org.freedesktop.login1.Manager.Inhibit). The lock is a
+// descriptor returned by logind and held until it is closed; nothing runs while it is
+// held. Linux only.
+class LogindInhibitor {
+public:
+    // Talks to logind on `busAddress`; the default is the system bus (overridden by
+    // $DBUS_SYSTEM_BUS_ADDRESS, which lets a stand-in logind on a private bus answer).
+    LogindInhibitor();
+    explicit LogindInhibitor(std::string busAddress);
+    ~LogindInhibitor();
+
+    LogindInhibitor(const LogindInhibitor&) = delete;
+    LogindInhibitor& operator=(const LogindInhibitor&) = delete;
+
+    // Inhibitor "what" for a mode: system sleep only, or also logind's idle action
+    // (IdleAction after IdleActionUSec) when the display must stay on. The idle lock does
+    // not reach the X server's screen saver or DPMS, nor most desktops' blanking: the
+    // display itself needs a separate hold.
+    static const char* WhatFor(bool keepDisplayOn) noexcept;
+
+    // Takes the lock for the mode. Switching modes takes the new lock before dropping the
+    // old one, so there is no unprotected gap. No-op if that mode is already held.
+    bool Acquire(bool keepDisplayOn);
+    void Release();
+
+    // logind's BlockInhibited property: the union of every active blocking lock's "what"
+    // (e.g. "sleep:idle"). One D-Bus connection and round trip.
+    bool QueryBlockInhibited(std::string& what);
+    // Whether `blocked` (a BlockInhibited value) covers the mode's "what".
+    static bool Covers(const std::string& blocked, bool keepDisplayOn);
+
+    bool IsHeld() const noexcept { return m_fd >= 0; }
+    bool IsDisplayHeld() const noexcept { return m_fd >= 0 && m_keepDisplayOn; }
+    // D-Bus round trips made (connect + Hello + Inhibit per lock taken).
+    unsigned GetCallCount() const noexcept { return m_calls; }
+
+private:
+    std::string m_busAddress;
+    int m_fd = -1;
+    bool m_keepDisplayOn = false;
+    unsigned m_calls = 0;
+};
+
+} // namespace Everon
@@ -0,0 +1,78 @@
+#include "PeriodicScheduler.h"
+#include "PhaseSpread.h"
+
+namespace Everon {
+
+void PeriodicScheduler::Start(ULONGLONG nowMonotonic, ULONGLONG periodTicks, LatePolicy policy) noexcept {
+    m_period = periodTicks ? periodTicks : 1;
+    m_next = nowMonotonic + m_period;
+    m_lastFire = 0;
+    m_policy = policy;
+    m_running = true;
+    m_jitter = DrawJitter();
+}
+
+void PeriodicScheduler::StartAligned(ULONGLONG nowMonotonic, ULONGLONG periodTicks, ULONGLONG phaseTicks,
+                                     LatePolicy policy) noexcept {
+    Start(nowMonotonic, periodTicks, policy);
+
+    // First grid point strictly after now.
+    ULONGLONG next = nowMonotonic - nowMonotonic % m_period + phaseTicks % m_period;
+    if (next <= nowMonotonic) {
+        next += m_period;
+    }
+    m_next = next;
+}
+
+void PeriodicScheduler::SetJitter(ULONGLONG maxTicks, ULONGLONG seed) noexcept {
+    m_jitterMax = maxTicks;
+    m_jitterState = seed;
+    m_jitter = m_running ? DrawJitter() : 0;
+}
+
+void PeriodicScheduler::Defer(ULONGLONG nextDeadline) noexcept {
+    m_next = nextDeadline;
+    m_jitter = DrawJitter();
+}
+
+ULONGLONG PeriodicScheduler::DrawJitter() noexcept {
+    return m_jitterMax ? PhaseSpread::NextJitter(m_jitterState, PhaseSpread::ClampJitter(m_jitterMax, m_period)) : 0;
+}
+
+unsigned PeriodicScheduler::OnWake(ULONGLONG nowMonotonic) noexcept {
+    if (!m_running || nowMonotonic < m_next + m_jitter) {
+        return 0;
+    }
+
+    m_lateness.Record(nowMonotonic - (m_next + m_jitter));
+
+    if (m_lastFire != 0 && nowMonotonic - m_lastFire > m_maxInterval) {
+        m_maxInterval = nowMonotonic - m_lastFire;
+    }
+    m_lastFire = nowMonotonic;
+
+    // Grid points that passed entirely while we were late.
+    const ULONGLONG missed = (nowMonotonic - m_next) / m_period;
+    m_next += (missed + 1) * m_period;
+    m_jitter = DrawJitter();
+
+    unsigned fires = 1;
+    if (m_policy == LatePolicy::CatchUp) {
+        const ULONGLONG extra = missed < MAX_CATCH_UP ? missed : MAX_CATCH_UP;
+        fires += static_cast<unsigned>(extra);
+        m_skipped += missed - extra;
+    } else {
+        m_skipped += missed;
+    }
+    m_fired += fires;
+    return fires;
+}
+
+void PeriodicScheduler::ResetStatistics() noexcept {
+    m_lateness.Reset();
+    m_maxInterval = 0;
+    m_fired = 0;
+    m_skipped = 0;
+}
+
+} // namespace Everon
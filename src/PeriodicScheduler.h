@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Platform.h"
+#include "LatencyHistogram.h"
+
+namespace Everon {
+
+// Fixed-rate schedule on the monotonic time line. Deadlines sit on an absolute grid
+// (start + k * period), so message-queue delays never accumulate into drift.
+// Pure bookkeeping: the caller arms an OS timer for GetNextDeadline() and reports
+// wakeups through OnWake(), which makes the schedule replayable on a VirtualClock.
+class PeriodicScheduler {
+public:
+    enum class LatePolicy {
+        Skip,     // Fire once for a late wakeup; missed grid points are dropped
+        CatchUp   // Fire once per missed grid point (bounded by MAX_CATCH_UP)
+    };
+
+    static constexpr unsigned MAX_CATCH_UP = 4;
+
+    void Start(ULONGLONG nowMonotonic, ULONGLONG periodTicks, LatePolicy policy = LatePolicy::Skip) noexcept;
+
+    // Like Start(), but the grid is phaseTicks + k * period on the monotonic time line
+    // itself. Sessions on one host share that time line, so distinct phases stay spread
+    // out no matter when each session started (see PhaseSpread).
+    void StartAligned(ULONGLONG nowMonotonic, ULONGLONG periodTicks, ULONGLONG phaseTicks,
+                      LatePolicy policy = LatePolicy::Skip) noexcept;
+
+    // Delays each fire by a pseudo-random amount in [0, maxTicks] (at most half the
+    // period), drawn from a stream seeded with `seed`. The grid itself does not move.
+    void SetJitter(ULONGLONG maxTicks, ULONGLONG seed) noexcept;
+    void Stop() noexcept { m_running = false; }
+    bool IsRunning() const noexcept { return m_running; }
+
+    ULONGLONG GetPeriod() const noexcept { return m_period; }
+    ULONGLONG GetNextDeadline() const noexcept { return m_next + m_jitter; }
+
+    // Moves the next grid point to `nextDeadline` and continues the grid from there
+    // (e.g. one period after real user input, which already did the keypress's job).
+    void Defer(ULONGLONG nextDeadline) noexcept;
+
+    // Reports a wakeup at `nowMonotonic`. Returns how many times the action should run
+    // now (0 for an early/spurious wakeup) and advances the deadline along the grid.
+    unsigned OnWake(ULONGLONG nowMonotonic) noexcept;
+
+    // Lateness of each on-time-or-late wakeup versus its intended (jittered) deadline.
+    const LatencyHistogram& GetLateness() const noexcept { return m_lateness; }
+
+    // Longest observed interval between two consecutive fires; compare with the
+    // OS idle timeout to show every send lands inside the idle window.
+    ULONGLONG GetMaxInterval() const noexcept { return m_maxInterval; }
+
+    ULONGLONG GetFiredCount() const noexcept { return m_fired; }
+    ULONGLONG GetSkippedCount() const noexcept { return m_skipped; }
+
+    void ResetStatistics() noexcept;
+
+private:
+    ULONGLONG DrawJitter() noexcept;
+
+    ULONGLONG m_period = 0;
+    ULONGLONG m_next = 0;          // grid point
+    ULONGLONG m_jitter = 0;        // delay of the current grid point's fire
+    ULONGLONG m_jitterMax = 0;
+    ULONGLONG m_jitterState = 0;
+    ULONGLONG m_lastFire = 0;
+    LatePolicy m_policy = LatePolicy::Skip;
+    bool m_running = false;
+
+    LatencyHistogram m_lateness;
+    ULONGLONG m_maxInterval = 0;
+    ULONGLONG m_fired = 0;
+    ULONGLONG m_skipped = 0;
+};
+
+} // namespace Everon
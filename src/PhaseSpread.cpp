@@ -0,0 +1,56 @@
+#include "PhaseSpread.h"
+
+namespace Everon {
+namespace PhaseSpread {
+
+namespace {
+
+constexpr ULONGLONG kFnvOffsetBasis = 14695981039346656037ULL;
+constexpr ULONGLONG kFnvPrime = 1099511628211ULL;
+constexpr ULONGLONG kTicksPerMs = 10000ULL;
+
+ULONGLONG Mix(ULONGLONG value) noexcept {
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ULL;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBULL;
+    value ^= value >> 31;
+    return value;
+}
+
+} // namespace
+
+ULONGLONG HashIdentity(const std::wstring& identity) noexcept {
+    ULONGLONG hash = kFnvOffsetBasis;
+    for (const wchar_t ch : identity) {
+        // UTF-16 code units, low byte first, so both platforms hash the same text alike.
+        const unsigned unit = static_cast<unsigned>(ch) & 0xFFFFU;
+        hash = (hash ^ (unit & 0xFFU)) * kFnvPrime;
+        hash = (hash ^ (unit >> 8)) * kFnvPrime;
+    }
+    return hash;
+}
+
+ULONGLONG PhaseOffset(ULONGLONG identityHash, ULONGLONG periodTicks) noexcept {
+    const ULONGLONG periodMs = periodTicks / kTicksPerMs;
+    if (periodMs == 0) {
+        return 0;
+    }
+    return (Mix(identityHash) % periodMs) * kTicksPerMs;
+}
+
+ULONGLONG NextJitter(ULONGLONG& state, ULONGLONG maxTicks) noexcept {
+    state += 0x9E3779B97F4A7C15ULL;
+    if (maxTicks == 0) {
+        return 0;
+    }
+    return Mix(state) % (maxTicks + 1);
+}
+
+ULONGLONG ClampJitter(ULONGLONG jitterTicks, ULONGLONG periodTicks) noexcept {
+    const ULONGLONG limit = periodTicks / 2;
+    return jitterTicks < limit ? jitterTicks : limit;
+}
+
+} // namespace PhaseSpread
+} // namespace Everon
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Platform.h"
+#include <string>
+
+namespace Everon {
+
+// De-synchronizes the keypress schedule of many sessions on one host (RDS/VDI): each
+// session gets a deterministic phase on the shared monotonic grid, derived from its
+// identity, plus optional bounded per-fire jitter. All values are 100 ns ticks.
+namespace PhaseSpread {
+
+// FNV-1a (64-bit) over the UTF-16 code units of `identity`.
+ULONGLONG HashIdentity(const std::wstring& identity) noexcept;
+
+// Phase in [0, periodTicks), at millisecond granularity. The hash is mixed first so
+// sessions with near-identical identities still land far apart.
+ULONGLONG PhaseOffset(ULONGLONG identityHash, ULONGLONG periodTicks) noexcept;
+
+// Next value in [0, maxTicks] from a splitmix64 stream; `state` is advanced.
+ULONGLONG NextJitter(ULONGLONG& state, ULONGLONG maxTicks) noexcept;
+
+// Jitter must leave the next grid point untouched: at most half the period.
+ULONGLONG ClampJitter(ULONGLONG jitterTicks, ULONGLONG periodTicks) noexcept;
+
+} // namespace PhaseSpread
+} // namespace Everon
@@ -0,0 +1,96 @@
+#pragma once
+
+// Thin OS layer for the platform-neutral core (everon-core).
+// On Windows this is just <windows.h>; elsewhere it provides the small subset of Win32
+// types and constants the core relies on, so timer math, settings and localization
+// compile unchanged on both.
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+#else
+
+#include <cstdint>
+
+typedef unsigned char  BYTE;
+typedef unsigned short WORD;
+typedef std::uint32_t  DWORD;
+typedef unsigned int   UINT;
+typedef std::int32_t   LONG;
+typedef int            BOOL;
+typedef std::uint64_t  ULONGLONG;
+typedef std::int64_t   LONGLONG;
+
+typedef struct _SYSTEMTIME {
+    WORD wYear;
+    WORD wMonth;
+    WORD wDayOfWeek;
+    WORD wDay;
+    WORD wHour;
+    WORD wMinute;
+    WORD wSecond;
+    WORD wMilliseconds;
+} SYSTEMTIME;
+
+#ifndef INFINITE
+#define INFINITE 0xFFFFFFFFUL
+#endif
+
+// RegisterHotKey modifiers
+#define MOD_ALT     0x0001
+#define MOD_CONTROL 0x0002
+#define MOD_SHIFT   0x0004
+#define MOD_WIN     0x0008
+
+// Virtual keys used by the core (settings validation)
+#define VK_F15 0x7E
+#define VK_F16 0x7F
+#define VK_F17 0x80
+
+#endif // _WIN32
+
+#include <string>
+
+namespace Everon {
+namespace Platform {
+
+// Current UTC time as FILETIME ticks (100 ns since 1601-01-01).
+ULONGLONG GetSystemTimeUtc() noexcept;
+
+// Suspend-aware monotonic time, 100 ns ticks since an unspecified origin (boot).
+ULONGLONG GetMonotonicTicks() noexcept;
+
+// CPU time (user + kernel) consumed by the calling thread, 100 ns ticks.
+ULONGLONG GetThreadCpuTicks() noexcept;
+
+// Current local calendar time.
+void GetLocalTime(SYSTEMTIME& out) noexcept;
+
+// Moves the process into (or out of) the platform's low-power QoS class: EcoQoS power
+// throttling on Windows; SCHED_BATCH, nice +10 and PR_SET_TIMERSLACK on Linux.
+bool SetEfficiencyMode(bool enabled, ULONGLONG timerSlackTicks) noexcept;
+
+// Stable identity of the current login session ("user#session"), distinct for concurrent
+// sessions on one host (RDS/VDI, multi-seat) and unchanged across restarts within one.
+std::wstring GetSessionIdentity();
+
+// Two-letter UI language code of the current user ("en", "ru", ...).
+const wchar_t* GetUserLanguageCode() noexcept;
+
+// Case-insensitive comparison (ASCII semantics are sufficient for the core).
+int CompareNoCase(const wchar_t* a, const wchar_t* b) noexcept;
+
+} // namespace Platform
+
+namespace Utils {
+
+// Debug logging (debugger output on Windows, stderr elsewhere)
+#ifdef _DEBUG
+void DebugLog(const wchar_t* format, ...);
+#else
+inline void DebugLog(const wchar_t*, ...) {}
+#endif
+
+} // namespace Utils
+} // namespace Everon
@@ -0,0 +1,166 @@
+#include "Platform.h"
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <cwchar>
+#include <cwctype>
+#include <sched.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace Everon {
+namespace Platform {
+
+namespace {
+
+// Seconds between 1601-01-01 (FILETIME epoch) and 1970-01-01 (Unix epoch).
+constexpr ULONGLONG kEpochDeltaSec = 11644473600ULL;
+constexpr ULONGLONG kTicksPerSec = 10000000ULL;
+
+void TmToSystemTime(const std::tm& tm, WORD milliseconds, SYSTEMTIME& out) noexcept {
+    out.wYear = static_cast<WORD>(tm.tm_year + 1900);
+    out.wMonth = static_cast<WORD>(tm.tm_mon + 1);
+    out.wDayOfWeek = static_cast<WORD>(tm.tm_wday);
+    out.wDay = static_cast<WORD>(tm.tm_mday);
+    out.wHour = static_cast<WORD>(tm.tm_hour);
+    out.wMinute = static_cast<WORD>(tm.tm_min);
+    out.wSecond = static_cast<WORD>(tm.tm_sec);
+    out.wMilliseconds = milliseconds;
+}
+
+} // namespace
+
+ULONGLONG GetSystemTimeUtc() noexcept {
+    timespec ts = {};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (static_cast<ULONGLONG>(ts.tv_sec) + kEpochDeltaSec) * kTicksPerSec +
+           static_cast<ULONGLONG>(ts.tv_nsec) / 100ULL;
+}
+
+ULONGLONG GetMonotonicTicks() noexcept {
+    // CLOCK_BOOTTIME keeps counting while the system is suspended (CLOCK_MONOTONIC does not).
+    timespec ts = {};
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<ULONGLONG>(ts.tv_sec) * kTicksPerSec + static_cast<ULONGLONG>(ts.tv_nsec) / 100ULL;
+}
+
+ULONGLONG GetThreadCpuTicks() noexcept {
+    timespec ts = {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<ULONGLONG>(ts.tv_sec) * kTicksPerSec + static_cast<ULONGLONG>(ts.tv_nsec) / 100ULL;
+}
+
+void GetLocalTime(SYSTEMTIME& out) noexcept {
+    timespec ts = {};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    std::tm tm = {};
+    localtime_r(&ts.tv_sec, &tm);
+    TmToSystemTime(tm, static_cast<WORD>(ts.tv_nsec / 1000000L), out);
+}
+
+bool SetEfficiencyMode(bool enabled, ULONGLONG timerSlackTicks) noexcept {
+    // Nice value in effect before efficiency mode; raising priority again may need
+    // CAP_SYS_NICE, so restoring is best effort.
+    static int s_savedNice = 0;
+    static bool s_active = false;
+
+    bool ok = true;
+
+    // Timer slack lets the kernel batch this process's timer expirations
+    // (0 restores the default slack inherited at start-up).
+    const unsigned long slackNs = enabled ? static_cast<unsigned long>(timerSlackTicks * 100ULL) : 0UL;
+    if (prctl(PR_SET_TIMERSLACK, slackNs, 0, 0, 0) != 0) {
+        Utils::DebugLog(L"[Everon] PR_SET_TIMERSLACK failed (errno %d)\n", errno);
+        ok = false;
+    }
+
+    sched_param param = {};
+    if (sched_setscheduler(0, enabled ? SCHED_BATCH : SCHED_OTHER, &param) != 0) {
+        Utils::DebugLog(L"[Everon] sched_setscheduler failed (errno %d)\n", errno);
+        ok = false;
+    }
+
+    if (enabled && !s_active) {
+        errno = 0;
+        const int current = getpriority(PRIO_PROCESS, 0);
+        if (errno == 0) {
+            s_savedNice = current;
+            s_active = true;
+            if (setpriority(PRIO_PROCESS, 0, current < 10 ? 10 : current) != 0) {
+                ok = false;
+            }
+        }
+    } else if (!enabled && s_active) {
+        s_active = false;
+        if (setpriority(PRIO_PROCESS, 0, s_savedNice) != 0) {
+            Utils::DebugLog(L"[Everon] Could not restore nice %d (errno %d)\n", s_savedNice, errno);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+std::wstring GetSessionIdentity() {
+    // logind session id when present (set by pam_systemd), else the session leader.
+    wchar_t identity[128] = {};
+    const char* session = std::getenv("XDG_SESSION_ID");
+    if (session && *session) {
+        std::swprintf(identity, sizeof(identity) / sizeof(identity[0]), L"%lu#%s",
+                      static_cast<unsigned long>(getuid()), session);
+    } else {
+        std::swprintf(identity, sizeof(identity) / sizeof(identity[0]), L"%lu#%ld",
+                      static_cast<unsigned long>(getuid()), static_cast<long>(getsid(0)));
+    }
+    return identity;
+}
+
+const wchar_t* GetUserLanguageCode() noexcept {
+    // POSIX precedence: LC_ALL > LC_MESSAGES > LANG, e.g. "ru_RU.UTF-8".
+    const char* locale = std::getenv("LC_ALL");
+    if (!locale || !*locale) {
+        locale = std::getenv("LC_MESSAGES");
+    }
+    if (!locale || !*locale) {
+        locale = std::getenv("LANG");
+    }
+    if (!locale || !locale[0] || !locale[1]) {
+        return L"en";
+    }
+
+    static const struct { char code[3]; const wchar_t* wide; } kCodes[] = {
+        { "ru", L"ru" }, { "fr", L"fr" }, { "de", L"de" }, { "it", L"it" }, { "es", L"es" }
+    };
+    for (const auto& entry : kCodes) {
+        if (locale[0] == entry.code[0] && locale[1] == entry.code[1]) {
+            return entry.wide;
+        }
+    }
+    return L"en";
+}
+
+int CompareNoCase(const wchar_t* a, const wchar_t* b) noexcept {
+    return wcscasecmp(a, b);
+}
+
+} // namespace Platform
+
+namespace Utils {
+
+#ifdef _DEBUG
+void DebugLog(const wchar_t* format, ...) {
+    wchar_t buffer[512] = {};
+
+    va_list args;
+    va_start(args, format);
+    vswprintf(buffer, sizeof(buffer) / sizeof(buffer[0]), format, args);
+    va_end(args);
+
+    std::fprintf(stderr, "%ls", buffer);
+}
+#endif
+
+} // namespace Utils
+} // namespace Everon
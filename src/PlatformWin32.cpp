@@ -0,0 +1,112 @@
+#include "Platform.h"
+#include <strsafe.h>
+#include <stdarg.h>
+
+namespace Everon {
+namespace Platform {
+
+ULONGLONG GetSystemTimeUtc() noexcept {
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    ULARGE_INTEGER u;
+    u.LowPart = ft.dwLowDateTime;
+    u.HighPart = ft.dwHighDateTime;
+    return u.QuadPart;
+}
+
+ULONGLONG GetMonotonicTicks() noexcept {
+    // GetTickCount64 keeps counting across sleep/hibernate, unlike QueryUnbiasedInterruptTime.
+    return GetTickCount64() * 10000ULL;
+}
+
+ULONGLONG GetThreadCpuTicks() noexcept {
+    FILETIME creation;
+    FILETIME exit;
+    FILETIME kernel;
+    FILETIME user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    ULARGE_INTEGER k;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    ULARGE_INTEGER u;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return k.QuadPart + u.QuadPart;
+}
+
+void GetLocalTime(SYSTEMTIME& out) noexcept {
+    ::GetLocalTime(&out);
+}
+
+bool SetEfficiencyMode(bool enabled, ULONGLONG /*timerSlackTicks*/) noexcept {
+    // EcoQoS: the scheduler prefers efficient cores and low frequencies, and timer
+    // resolution requests are ignored. Timer slack is per timer on Windows
+    // (SetWaitableTimerEx / SetCoalescableTimer tolerances).
+    PROCESS_POWER_THROTTLING_STATE state = {};
+    state.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+    state.ControlMask = PROCESS_POWER_THROTTLING_EXECUTION_SPEED |
+                        PROCESS_POWER_THROTTLING_IGNORE_TIMER_RESOLUTION;
+    state.StateMask = enabled ? state.ControlMask : 0;
+
+    if (!SetProcessInformation(GetCurrentProcess(), ProcessPowerThrottling, &state, sizeof(state))) {
+        Utils::DebugLog(L"[Everon] SetProcessInformation(ProcessPowerThrottling) failed (%lu)\n", GetLastError());
+        return false;
+    }
+    return true;
+}
+
+std::wstring GetSessionIdentity() {
+    wchar_t user[256 + 1] = {};
+    DWORD userLength = _countof(user);
+    if (!GetUserNameW(user, &userLength)) {
+        user[0] = L'\0';
+    }
+
+    DWORD sessionId = 0;
+    if (!ProcessIdToSessionId(GetCurrentProcessId(), &sessionId)) {
+        sessionId = 0;
+    }
+
+    wchar_t identity[300] = {};
+    StringCchPrintfW(identity, _countof(identity), L"%s#%lu", user, sessionId);
+    return identity;
+}
+
+const wchar_t* GetUserLanguageCode() noexcept {
+    const LANGID langId = GetUserDefaultUILanguage();
+
+    switch (PRIMARYLANGID(langId)) {
+        case LANG_RUSSIAN:  return L"ru";
+        case LANG_FRENCH:   return L"fr";
+        case LANG_GERMAN:   return L"de";
+        case LANG_ITALIAN:  return L"it";
+        case LANG_SPANISH:  return L"es";
+        default:            return L"en";
+    }
+}
+
+int CompareNoCase(const wchar_t* a, const wchar_t* b) noexcept {
+    return _wcsicmp(a, b);
+}
+
+} // namespace Platform
+
+namespace Utils {
+
+#ifdef _DEBUG
+void DebugLog(const wchar_t* format, ...) {
+    wchar_t buffer[512] = {};
+
+    va_list args;
+    va_start(args, format);
+    StringCchVPrintfW(buffer, _countof(buffer), format, args);
+    va_end(args);
+
+    OutputDebugStringW(buffer);
+}
+#endif
+
+} // namespace Utils
+} // namespace Everon
@@ -1,30 +1,39 @@
 #include "PowerManager.h"
-#include "Utils.h"
 
 namespace Everon {
 
+PowerManager::PowerManager()
+    : m_engine(CreateKeepAwakeStrategies()) {
+}
+
 PowerManager::~PowerManager() {
     AllowSleep();
 }
 
-void PowerManager::PreventSleep(bool keepDisplayOn) {
-    if (m_isActive && m_keepDisplayOn == keepDisplayOn) {
-        return;
-    }
+void PowerManager::Initialize() {
+    m_engine.Probe();
+}
 
-    EXECUTION_STATE flags = ES_CONTINUOUS | ES_SYSTEM_REQUIRED;
-    if (keepDisplayOn) {
-        flags |= ES_DISPLAY_REQUIRED;
+bool PowerManager::PreventSleep(bool keepDisplayOn) {
+    if (m_isActive && m_keepDisplayOn == keepDisplayOn) {
+        return m_engine.IsHolding();
     }
 
-    EXECUTION_STATE result = SetThreadExecutionState(flags);
-    if (result == 0) {
-        Utils::DebugLog(L"[Everon] Failed to prevent sleep: %lu\n", GetLastError());
-        return;
+    if (!m_engine.Hold(keepDisplayOn)) {
+        if (!m_engine.IsDisplayHeld()) {
+            Utils::DebugLog(L"[Everon] Failed to prevent sleep: no keep-awake strategy works\n");
+            return false;
+        }
+        // Keep the display hold (and let Verify() retry the rest), but say it is not enough.
+        Utils::DebugLog(L"[Everon] Display kept on only: no keep-awake strategy inhibits system sleep\n");
+        m_isActive = true;
+        m_keepDisplayOn = keepDisplayOn;
+        return false;
     }
 
     m_isActive = true;
     m_keepDisplayOn = keepDisplayOn;
+    return true;
 }
 
 
@@ -32,10 +41,7 @@ void PowerManager::AllowSleep() {
     if (!m_isActive) {
         return;
     }
-    const EXECUTION_STATE prev = SetThreadExecutionState(ES_CONTINUOUS);
-    if (prev == 0) {
-		Utils::DebugLog(L"[Everon] SetThreadExecutionState(ES_CONTINUOUS) failed: %lu\n", GetLastError());
-    }
+    m_engine.Release();
     m_isActive = false;
     m_keepDisplayOn = false;
 }
@@ -45,21 +51,8 @@ void PowerManager::SendKeyPress(WORD virtualKey) {
         return;
     }
 
-    INPUT inputs[2] = {};
-
-    // Key down
-    inputs[0].type = INPUT_KEYBOARD;
-    inputs[0].ki.wVk = virtualKey;
-    inputs[0].ki.dwFlags = 0;
-
-    // Key up
-    inputs[1].type = INPUT_KEYBOARD;
-    inputs[1].ki.wVk = virtualKey;
-    inputs[1].ki.dwFlags = KEYEVENTF_KEYUP;
-
-    const UINT sent = SendInput(2, inputs, sizeof(INPUT));
-    if (sent != 2) {
-		Utils::DebugLog(L"[Everon] SendInput failed/sent %u: %lu\n", sent, GetLastError());
+    if (!m_engine.Pulse(virtualKey)) {
+        Utils::DebugLog(L"[Everon] Key press not sent: no input strategy works\n");
     }
 }
 
@@ -1,17 +1,25 @@
 #pragma once
 
-#include <windows.h>
+#include "Platform.h"
+#include "KeepAwake.h"
 
 namespace Everon {
 
-// Manages power state and prevents system sleep
+// Manages power state and prevents system sleep, through the cheapest keep-awake
+// strategy that works on this machine (see KeepAwakeEngine).
 class PowerManager {
 public:
-    PowerManager() = default;
+    PowerManager();
     ~PowerManager();
 
-    // Prevent system sleep
-    void PreventSleep(bool keepDisplayOn);
+    // Probe the keep-awake strategies (once, at start-up)
+    void Initialize();
+    // Probe lazily instead, only as far as the first strategy that works (everon run)
+    void InitializeOnDemand() { m_engine.ProbeOnDemand(); }
+
+    // Prevent system sleep; false if no strategy could, even when the display is still
+    // kept on (IsPreventingSleep() is then true so that AllowSleep() releases it)
+    bool PreventSleep(bool keepDisplayOn);
 
     // Allow system sleep
     void AllowSleep();
@@ -19,10 +27,19 @@ public:
     // Send virtual key press
     void SendKeyPress(WORD virtualKey);
 
+    // Check the OS still honours the hold and re-assert it if not; run every
+    // GetVerifyInterval() (backs off while the hold stays in force)
+    VerifyResult Verify() { return m_engine.Verify(); }
+    ULONGLONG GetVerifyInterval() const noexcept { return m_engine.GetVerifyInterval(); }
+
     // Check if currently preventing sleep
     bool IsPreventingSleep() const noexcept { return m_isActive; }
 
+    // Per-strategy overhead counters (debug log)
+    void LogStatistics() const { m_engine.LogStatistics(); }
+
 private:
+    KeepAwakeEngine m_engine;
     bool m_isActive = false;
     bool m_keepDisplayOn = false;
 };
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Platform.h"
+
+namespace Everon {
+
+// Reports power_supply changes (AC plugged or unplugged, battery charge steps) as the
+// kernel announces them, so the battery policy is re-evaluated without polling.
+// Linux: kernel uevents on a NETLINK_KOBJECT_UEVENT socket, filtered to
+// SUBSYSTEM=power_supply. Windows delivers the same events as WM_POWERBROADCAST (see App).
+class PowerSupplyMonitor {
+public:
+    PowerSupplyMonitor() = default;
+    ~PowerSupplyMonitor();
+
+    PowerSupplyMonitor(const PowerSupplyMonitor&) = delete;
+    PowerSupplyMonitor& operator=(const PowerSupplyMonitor&) = delete;
+
+    bool Start();
+    void Stop();
+
+    // Descriptor to poll for readability, -1 when not started.
+    int GetFd() const noexcept { return m_fd; }
+
+    // Call when GetFd() is readable. Drains pending uevents; true if any was a
+    // power_supply change.
+    bool Consume();
+
+private:
+    int m_fd = -1;
+};
+
+} // namespace Everon
@@ -0,0 +1,141 @@
+#include "BatteryPolicy.h"
+#include "PowerSupplyMonitor.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <linux/netlink.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Everon {
+
+namespace {
+
+// First line of a sysfs attribute, without the newline; empty if unreadable.
+std::string ReadAttribute(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "r");
+    if (!file) {
+        return {};
+    }
+    char line[64] = {};
+    const bool ok = std::fgets(line, sizeof(line), file) != nullptr;
+    std::fclose(file);
+    if (!ok) {
+        return {};
+    }
+    line[std::strcspn(line, "\n")] = '\0';
+    return line;
+}
+
+} // namespace
+
+namespace PowerSupply {
+
+bool QuerySysfs(const char* root, PowerSupplyStatus& status) {
+    DIR* dir = opendir(root);
+    if (!dir) {
+        return false;
+    }
+
+    bool hasMains = false;
+    bool mainsOnline = false;
+    bool discharging = false;
+    int batteries = 0;
+    int percentSum = 0;
+    int percentCount = 0;
+    while (const dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        const std::string base = std::string(root) + "/" + entry->d_name + "/";
+        const std::string type = ReadAttribute(base + "type");
+        if (type == "Mains" || type == "USB") {
+            hasMains = true;
+            mainsOnline |= (ReadAttribute(base + "online") == "1");
+        } else if (type == "Battery" && ReadAttribute(base + "scope") != "Device") {
+            // scope=Device: a peripheral's battery (mouse, headset), not the system's.
+            ++batteries;
+            discharging |= (ReadAttribute(base + "status") == "Discharging");
+            const std::string capacity = ReadAttribute(base + "capacity");
+            if (!capacity.empty()) {
+                percentSum += std::atoi(capacity.c_str());
+                ++percentCount;
+            }
+        }
+    }
+    closedir(dir);
+
+    status.hasBattery = batteries > 0;
+    // Without a mains supply entry, the battery's own status tells.
+    status.onBattery = status.hasBattery && (hasMains ? !mainsOnline : discharging);
+    status.percent = percentCount ? percentSum / percentCount : -1;
+    return true;
+}
+
+bool Query(PowerSupplyStatus& status) {
+    return QuerySysfs("/sys/class/power_supply", status);
+}
+
+} // namespace PowerSupply
+
+PowerSupplyMonitor::~PowerSupplyMonitor() {
+    Stop();
+}
+
+bool PowerSupplyMonitor::Start() {
+    if (m_fd >= 0) {
+        return true;
+    }
+
+    m_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (m_fd < 0) {
+        Utils::DebugLog(L"[Everon] uevent socket failed (errno %d)\n", errno);
+        return false;
+    }
+
+    sockaddr_nl addr = {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = 1;     // kernel uevents (group 2 is udev's re-broadcast)
+    if (bind(m_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        Utils::DebugLog(L"[Everon] uevent bind failed (errno %d)\n", errno);
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+void PowerSupplyMonitor::Stop() {
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool PowerSupplyMonitor::Consume() {
+    bool changed = false;
+    char buffer[4096];
+    for (;;) {
+        const ssize_t size = recv(m_fd, buffer, sizeof(buffer) - 1, 0);
+        if (size < 0 && errno == EINTR) {
+            continue;
+        }
+        if (size <= 0) {
+            break;
+        }
+        buffer[size] = '\0';
+
+        // "action@devpath\0KEY=VALUE\0..."
+        for (size_t pos = 0; pos < static_cast<size_t>(size); pos += std::strlen(buffer + pos) + 1) {
+            if (std::strcmp(buffer + pos, "SUBSYSTEM=power_supply") == 0) {
+                changed = true;
+                break;
+            }
+        }
+    }
+    return changed;
+}
+
+} // namespace Everon
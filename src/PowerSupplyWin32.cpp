@@ -0,0 +1,20 @@
+#include "BatteryPolicy.h"
+
+namespace Everon {
+namespace PowerSupply {
+
+bool Query(PowerSupplyStatus& status) {
+    SYSTEM_POWER_STATUS power = {};
+    if (!GetSystemPowerStatus(&power)) {
+        return false;
+    }
+
+    // BatteryFlag 128: no system battery; 255: unknown.
+    status.hasBattery = (power.BatteryFlag & 128) == 0 && power.BatteryFlag != 255;
+    status.onBattery = status.hasBattery && power.ACLineStatus == 0;
+    status.percent = power.BatteryLifePercent <= 100 ? power.BatteryLifePercent : -1;
+    return true;
+}
+
+} // namespace PowerSupply
+} // namespace Everon
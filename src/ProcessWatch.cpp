@@ -0,0 +1,103 @@
+#include "ProcessWatch.h"
+
+namespace Everon {
+
+void ProcessWatchList::Normalize(const std::string& image, std::string& out) {
+    const size_t slash = image.find_last_of("/\\");
+    const size_t start = (slash == std::string::npos) ? 0 : slash + 1;
+    size_t length = image.size() - start;
+    if (length > 4 && (image[image.size() - 4] == '.') &&
+        (image[image.size() - 3] | 0x20) == 'e' && (image[image.size() - 2] | 0x20) == 'x' &&
+        (image[image.size() - 1] | 0x20) == 'e') {
+        length -= 4;
+    }
+    out.assign(image, start, length);
+    for (char& c : out) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+}
+
+void ProcessWatchList::SetNames(const std::wstring& list) {
+    m_names.clear();
+    m_running.clear();
+    m_lengths = 0;
+
+    std::string current;
+    auto flush = [this, &current]() {
+        while (!current.empty() && current.back() == ' ') {
+            current.pop_back();
+        }
+        if (!current.empty()) {
+            std::string name;
+            Normalize(current, name);
+            m_lengths |= (name.size() < 64) ? (1ULL << name.size()) : (1ULL << 63);
+            m_names.insert(std::move(name));
+        }
+        current.clear();
+    };
+    for (wchar_t c : list) {
+        if (c == L';' || c == L',') {
+            flush();
+        } else if (c == L' ' && current.empty()) {
+            continue;
+        } else if (c > 0 && c < 0x80) {
+            current += static_cast<char>(c);   // image names in rules are ASCII
+        }
+    }
+    flush();
+}
+
+bool ProcessWatchList::MatchScratch(const std::string& image) const {
+    if (m_names.empty()) {
+        return false;
+    }
+    Normalize(image, m_scratch);
+    // Most starts are rejected on length alone, without hashing.
+    const ULONGLONG bit = (m_scratch.size() < 64) ? (1ULL << m_scratch.size()) : (1ULL << 63);
+    return (m_lengths & bit) != 0 && m_names.count(m_scratch) != 0;
+}
+
+bool ProcessWatchList::Matches(const std::string& image) const {
+    return MatchScratch(image);
+}
+
+bool ProcessWatchList::OnStart(DWORD pid, const std::string& image) {
+    if (!MatchScratch(image)) {
+        // A reused pid now runs something else.
+        if (!m_running.empty()) {
+            m_running.erase(pid);
+        }
+        return false;
+    }
+    m_running[pid] = m_scratch;
+    return true;
+}
+
+void ProcessWatchList::OnFork(DWORD parent, DWORD child) {
+    const auto it = m_running.find(parent);
+    if (it != m_running.end()) {
+        std::string name = it->second;
+        m_running[child] = std::move(name);
+    }
+}
+
+void ProcessWatchList::OnExit(DWORD pid) {
+    if (!m_running.empty()) {
+        m_running.erase(pid);
+    }
+}
+
+std::string ProcessWatchList::DescribeRunning() const {
+    std::string out;
+    for (const auto& [pid, name] : m_running) {
+        if (!out.empty()) {
+            out += ", ";
+        }
+        out += name + " (" + std::to_string(pid) + ")";
+    }
+    return out;
+}
+
+} // namespace Everon
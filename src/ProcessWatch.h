@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Platform.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Everon {
+
+// Which watched jobs (backups, renders, copies) are running. Names are image names
+// matched case-insensitively on the file name alone, with or without ".exe", so one
+// rule list ("robocopy;ffmpeg;rsync") works on every platform. Fed by ProcessWatcher.
+class ProcessWatchList {
+public:
+    // Replaces the rules with a ';' or ',' separated list; forgets tracked processes.
+    void SetNames(const std::wstring& list);
+    bool IsEmpty() const noexcept { return m_names.empty(); }
+    const std::unordered_set<std::string>& GetNames() const noexcept { return m_names; }
+
+    // `image` may be a bare name or a path.
+    bool Matches(const std::string& image) const;
+
+    // Process events; OnStart returns true if the process matched and is now tracked.
+    bool OnStart(DWORD pid, const std::string& image);
+    // A child of a tracked process (a job's worker) is tracked under the parent's name.
+    void OnFork(DWORD parent, DWORD child);
+    void OnExit(DWORD pid);
+    void ClearRunning() noexcept { m_running.clear(); }
+
+    bool IsAnyRunning() const noexcept { return !m_running.empty(); }
+    size_t GetRunningCount() const noexcept { return m_running.size(); }
+    // "ffmpeg (4711), rsync (4712)", for the log.
+    std::string DescribeRunning() const;
+
+    // Lower-case file name without ".exe", written to `out` (reusing its storage).
+    static void Normalize(const std::string& image, std::string& out);
+
+private:
+    // Normalizes into m_scratch: matching a start allocates nothing.
+    bool MatchScratch(const std::string& image) const;
+
+    std::unordered_set<std::string> m_names;
+    std::unordered_map<DWORD, std::string> m_running;
+    ULONGLONG m_lengths = 0;            // bit n set: some name is n characters long (n < 64)
+    mutable std::string m_scratch;
+};
+
+// Feeds a ProcessWatchList from OS process events, without walking the process list
+// on every change.
+// Windows: WMI Win32_ProcessStartTrace, filtered by name in the query, for starts and
+// a registered wait on each matched process for its exit; events are queued and
+// `message` is posted to `window`. There is no fork event: when a tracked process
+// exits, its children still running are tracked in its place. Linux: the netlink process connector (exec and exit
+// events, CAP_NET_ADMIN), polled together with the other descriptors.
+class ProcessWatcher {
+public:
+    explicit ProcessWatcher(ProcessWatchList& list);
+    ~ProcessWatcher();
+
+    ProcessWatcher(const ProcessWatcher&) = delete;
+    ProcessWatcher& operator=(const ProcessWatcher&) = delete;
+
+#ifdef _WIN32
+    bool Start(HWND window, UINT message);
+#else
+    bool Start();
+    // Descriptor to poll for readability, -1 when not started.
+    int GetFd() const noexcept { return m_fd; }
+#endif
+    void Stop();
+    bool IsStarted() const noexcept;
+
+    // Applies pending events to the list. True if IsAnyRunning() changed.
+    bool Consume();
+    // Rebuilds the tracked set from one walk of the process list: at start, after a
+    // rule change, and when events were lost.
+    bool Scan();
+
+    ULONGLONG GetEventCount() const noexcept { return m_events; }
+    ULONGLONG GetScanCount() const noexcept { return m_scans; }
+
+private:
+    ProcessWatchList& m_list;
+    ULONGLONG m_events = 0;
+    ULONGLONG m_scans = 0;
+#ifdef _WIN32
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+#else
+    int m_fd = -1;
+#endif
+};
+
+} // namespace Everon
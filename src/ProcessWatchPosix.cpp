@@ -0,0 +1,195 @@
+#include "ProcessWatch.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Everon {
+
+namespace {
+
+constexpr size_t kCommLength = 15;     // TASK_COMM_LEN - 1: longer names are cut
+
+// Image name of `pid`: comm, or the executable's file name when comm may be truncated.
+// Empty once the process is gone.
+std::string ReadImageName(DWORD pid) {
+    const std::string dir = "/proc/" + std::to_string(pid);
+    const int fd = open((dir + "/comm").c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {};
+    }
+    char comm[32];
+    const ssize_t size = read(fd, comm, sizeof(comm));
+    close(fd);
+    if (size <= 0) {
+        return {};
+    }
+    std::string name(comm, static_cast<size_t>(size));
+    if (!name.empty() && name.back() == '\n') {
+        name.pop_back();
+    }
+    if (name.size() == kCommLength) {
+        char path[4096];
+        const ssize_t length = readlink((dir + "/exe").c_str(), path, sizeof(path) - 1);
+        if (length > 0) {
+            return std::string(path, static_cast<size_t>(length));
+        }
+    }
+    return name;
+}
+
+// Subscribes to or unsubscribes from the kernel's process events.
+bool SendControl(int fd, proc_cn_mcast_op op) {
+    alignas(nlmsghdr) char request[NLMSG_SPACE(sizeof(cn_msg) + sizeof(op))] = {};
+    auto* header = reinterpret_cast<nlmsghdr*>(request);
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(op));
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = static_cast<__u32>(getpid());
+    auto* message = static_cast<cn_msg*>(NLMSG_DATA(header));
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof(op);
+    std::memcpy(message->data, &op, sizeof(op));
+    return send(fd, request, header->nlmsg_len, 0) == static_cast<ssize_t>(header->nlmsg_len);
+}
+
+} // namespace
+
+ProcessWatcher::ProcessWatcher(ProcessWatchList& list)
+    : m_list(list) {
+}
+
+ProcessWatcher::~ProcessWatcher() {
+    Stop();
+}
+
+bool ProcessWatcher::Start() {
+    if (m_fd >= 0) {
+        return true;
+    }
+
+    m_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (m_fd < 0) {
+        Utils::DebugLog(L"[Everon] Process connector socket failed (errno %d)\n", errno);
+        return false;
+    }
+
+    // Bursts of short-lived processes come in faster than we may be scheduled.
+    const int bufferSize = 1 << 20;
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    sockaddr_nl addr = {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    addr.nl_pid = static_cast<__u32>(getpid());
+    if (bind(m_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        !SendControl(m_fd, PROC_CN_MCAST_LISTEN)) {
+        Utils::DebugLog(L"[Everon] Process connector unavailable (errno %d)\n", errno);
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+void ProcessWatcher::Stop() {
+    if (m_fd >= 0) {
+        SendControl(m_fd, PROC_CN_MCAST_IGNORE);
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool ProcessWatcher::IsStarted() const noexcept {
+    return m_fd >= 0;
+}
+
+bool ProcessWatcher::Consume() {
+    const bool before = m_list.IsAnyRunning();
+    bool lost = false;
+    alignas(nlmsghdr) char buffer[16384];
+    for (;;) {
+        sockaddr_nl from = {};
+        socklen_t fromLength = sizeof(from);
+        const ssize_t size = recvfrom(m_fd, buffer, sizeof(buffer), 0,
+                                      reinterpret_cast<sockaddr*>(&from), &fromLength);
+        if (size < 0 && errno == EINTR) {
+            continue;
+        }
+        if (size < 0 && errno == ENOBUFS) {
+            lost = true;    // the socket overflowed: resynchronise below
+            continue;
+        }
+        if (size <= 0) {
+            break;
+        }
+        if (from.nl_pid != 0) {
+            continue;       // not from the kernel
+        }
+
+        int remaining = static_cast<int>(size);
+        for (const nlmsghdr* header = reinterpret_cast<const nlmsghdr*>(buffer); NLMSG_OK(header, remaining);
+             header = NLMSG_NEXT(header, remaining)) {
+            const auto* message = static_cast<const cn_msg*>(NLMSG_DATA(header));
+            if (header->nlmsg_type != NLMSG_DONE || message->id.idx != CN_IDX_PROC ||
+                message->len < sizeof(proc_event)) {
+                continue;
+            }
+            const auto* event = reinterpret_cast<const proc_event*>(message->data);
+            ++m_events;
+            switch (event->what) {
+                case proc_event::PROC_EVENT_EXEC:
+                    if (event->event_data.exec.process_pid == event->event_data.exec.process_tgid) {
+                        const DWORD pid = static_cast<DWORD>(event->event_data.exec.process_tgid);
+                        m_list.OnStart(pid, ReadImageName(pid));
+                    }
+                    break;
+                case proc_event::PROC_EVENT_FORK:
+                    // A watched job's worker processes (rsync) count as the job.
+                    if (event->event_data.fork.child_pid == event->event_data.fork.child_tgid) {
+                        m_list.OnFork(static_cast<DWORD>(event->event_data.fork.parent_tgid),
+                                      static_cast<DWORD>(event->event_data.fork.child_tgid));
+                    }
+                    break;
+                case proc_event::PROC_EVENT_EXIT:
+                    if (event->event_data.exit.process_pid == event->event_data.exit.process_tgid) {
+                        m_list.OnExit(static_cast<DWORD>(event->event_data.exit.process_tgid));
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    if (lost) {
+        Scan();
+    }
+    return m_list.IsAnyRunning() != before;
+}
+
+bool ProcessWatcher::Scan() {
+    const bool before = m_list.IsAnyRunning();
+    DIR* dir = opendir("/proc");
+    if (!dir) {
+        return false;
+    }
+    ++m_scans;
+    m_list.ClearRunning();
+    while (const dirent* entry = readdir(dir)) {
+        char* end = nullptr;
+        const unsigned long pid = std::strtoul(entry->d_name, &end, 10);
+        if (pid != 0 && end && *end == '\0') {
+            m_list.OnStart(static_cast<DWORD>(pid), ReadImageName(static_cast<DWORD>(pid)));
+        }
+    }
+    closedir(dir);
+    return m_list.IsAnyRunning() != before;
+}
+
+} // namespace Everon
@@ -0,0 +1,447 @@
+#include "ProcessWatch.h"
+#include "Utils.h"
+#include <wbemidl.h>
+#include <tlhelp32.h>
+#include <mutex>
+#include <vector>
+
+namespace Everon {
+
+namespace {
+
+struct ProcessEvent {
+    enum Kind {
+        Started,
+        Exited,
+        QueryFailed     // WMI ended the subscription (e.g. the trace class needs admin rights)
+    };
+    Kind kind;
+    DWORD pid;
+    std::string image;
+};
+
+// Filled by WMI and thread-pool callbacks, drained on the window thread. Shared with
+// the callbacks so a late delivery after Stop() finds it alive.
+class EventQueue {
+public:
+    EventQueue(HWND window, UINT message) : m_window(window), m_message(message) {}
+
+    void Push(ProcessEvent event) {
+        bool first = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            first = m_events.empty();
+            m_events.push_back(std::move(event));
+        }
+        // One message per batch: a burst costs the window a single wakeup.
+        if (first) {
+            PostMessageW(m_window, m_message, 0, 0);
+        }
+    }
+
+    std::vector<ProcessEvent> Take() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<ProcessEvent> events;
+        events.swap(m_events);
+        return events;
+    }
+
+private:
+    HWND m_window;
+    UINT m_message;
+    std::mutex m_mutex;
+    std::vector<ProcessEvent> m_events;
+};
+
+std::string ToUtf8(const wchar_t* text) {
+    if (!text || !*text) {
+        return {};
+    }
+    const int size = WideCharToMultiByte(CP_UTF8, 0, text, -1, nullptr, 0, nullptr, nullptr);
+    if (size <= 1) {
+        return {};
+    }
+    std::string out(static_cast<size_t>(size - 1), '\0');
+    WideCharToMultiByte(CP_UTF8, 0, text, -1, &out[0], size, nullptr, nullptr);
+    return out;
+}
+
+// Pid and image name of a Win32_ProcessStartTrace event, or of the Win32_Process in
+// an __InstanceCreationEvent.
+bool ReadProcess(IWbemClassObject* object, DWORD& pid, std::string& image) {
+    VARIANT value;
+    VariantInit(&value);
+    IWbemClassObject* target = nullptr;
+    if (SUCCEEDED(object->Get(L"TargetInstance", 0, &value, nullptr, nullptr)) && value.vt == VT_UNKNOWN &&
+        value.punkVal) {
+        value.punkVal->QueryInterface(IID_IWbemClassObject, reinterpret_cast<void**>(&target));
+    }
+    VariantClear(&value);
+
+    IWbemClassObject* source = target ? target : object;
+    bool ok = false;
+    if (SUCCEEDED(source->Get(target ? L"ProcessId" : L"ProcessID", 0, &value, nullptr, nullptr)) &&
+        (value.vt == VT_I4 || value.vt == VT_UI4)) {
+        pid = value.ulVal;
+        ok = true;
+    }
+    VariantClear(&value);
+    if (ok && SUCCEEDED(source->Get(target ? L"Name" : L"ProcessName", 0, &value, nullptr, nullptr)) &&
+        value.vt == VT_BSTR) {
+        image = ToUtf8(value.bstrVal);
+    }
+    VariantClear(&value);
+
+    if (target) {
+        target->Release();
+    }
+    return ok;
+}
+
+class EventSink final : public IWbemObjectSink {
+public:
+    explicit EventSink(std::shared_ptr<EventQueue> queue) : m_queue(std::move(queue)) {}
+
+    ULONG STDMETHODCALLTYPE AddRef() override {
+        return static_cast<ULONG>(InterlockedIncrement(&m_refs));
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override {
+        const LONG refs = InterlockedDecrement(&m_refs);
+        if (refs == 0) {
+            delete this;
+        }
+        return static_cast<ULONG>(refs);
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override {
+        if (riid == IID_IUnknown || riid == IID_IWbemObjectSink) {
+            *object = static_cast<IWbemObjectSink*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    HRESULT STDMETHODCALLTYPE Indicate(LONG count, IWbemClassObject** objects) override {
+        for (LONG i = 0; i < count; ++i) {
+            ProcessEvent event = { ProcessEvent::Started, 0, {} };
+            if (ReadProcess(objects[i], event.pid, event.image)) {
+                m_queue->Push(std::move(event));
+            }
+        }
+        return WBEM_S_NO_ERROR;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetStatus(LONG /*flags*/, HRESULT result, BSTR /*param*/,
+                                        IWbemClassObject* /*object*/) override {
+        if (FAILED(result) && result != WBEM_E_CALL_CANCELLED) {
+            m_queue->Push({ ProcessEvent::QueryFailed, static_cast<DWORD>(result), {} });
+        }
+        return WBEM_S_NO_ERROR;
+    }
+
+private:
+    LONG m_refs = 1;
+    std::shared_ptr<EventQueue> m_queue;
+};
+
+} // namespace
+
+struct ProcessWatcher::Impl {
+    // Thread-pool wait on one tracked process's handle.
+    struct ExitWait {
+        std::shared_ptr<EventQueue> queue;
+        DWORD pid = 0;
+        ULONGLONG created = 0;              // FILETIME, 0 if it could not be read
+        HANDLE process = nullptr;
+        HANDLE wait = nullptr;
+    };
+
+    std::shared_ptr<EventQueue> queue;
+    bool comInitialized = false;
+    bool polling = false;                   // fell back to instance events
+    IWbemServices* services = nullptr;
+    IWbemObjectSink* stub = nullptr;        // unsecured-apartment stub handed to WMI
+    std::unordered_map<DWORD, std::unique_ptr<ExitWait>> waits;
+
+    static VOID CALLBACK OnProcessExit(PVOID context, BOOLEAN /*timedOut*/) {
+        const ExitWait* wait = static_cast<const ExitWait*>(context);
+        wait->queue->Push({ ProcessEvent::Exited, wait->pid, {} });
+    }
+
+    HRESULT Subscribe(const ProcessWatchList& list) {
+        // Let WMI filter by name: only matching starts reach this process.
+        std::wstring names;
+        for (const std::string& name : list.GetNames()) {
+            if (name.find_first_of("'\\\"") != std::string::npos) {
+                continue;
+            }
+            names += names.empty() ? L"" : L" OR ";
+            names += polling ? L"TargetInstance.Name='" : L"ProcessName='";
+            names += std::wstring(name.begin(), name.end()) + L".exe'";
+        }
+        if (names.empty()) {
+            return E_INVALIDARG;
+        }
+
+        // Win32_ProcessStartTrace is pushed by the kernel trace provider but needs admin
+        // rights; otherwise the WMI service checks its process list every 5 s for us.
+        const std::wstring query = polling
+            ? L"SELECT * FROM __InstanceCreationEvent WITHIN 5 WHERE TargetInstance ISA 'Win32_Process' AND (" +
+                  names + L")"
+            : L"SELECT ProcessID, ProcessName FROM Win32_ProcessStartTrace WHERE " + names;
+        BSTR language = SysAllocString(L"WQL");
+        BSTR text = SysAllocString(query.c_str());
+        const HRESULT hr = services->ExecNotificationQueryAsync(language, text, WBEM_FLAG_SEND_STATUS, nullptr, stub);
+        SysFreeString(text);
+        SysFreeString(language);
+        return hr;
+    }
+
+    void Unsubscribe() {
+        if (services && stub) {
+            services->CancelAsyncCall(stub);
+        }
+    }
+
+    // False if the process is already gone.
+    bool WatchExit(DWORD pid) {
+        CancelExit(pid);
+        auto wait = std::make_unique<ExitWait>();
+        wait->queue = queue;
+        wait->pid = pid;
+        wait->process = OpenProcess(SYNCHRONIZE | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (!wait->process) {
+            wait->process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+        }
+        if (!wait->process) {
+            return false;
+        }
+        FILETIME created, exited, kernel, user;
+        if (GetProcessTimes(wait->process, &created, &exited, &kernel, &user)) {
+            wait->created = (static_cast<ULONGLONG>(created.dwHighDateTime) << 32) | created.dwLowDateTime;
+        }
+        if (!RegisterWaitForSingleObject(&wait->wait, wait->process, OnProcessExit, wait.get(), INFINITE,
+                                         WT_EXECUTEONLYONCE | WT_EXECUTEINWAITTHREAD)) {
+            Utils::CheckWinApiBool(FALSE, L"RegisterWaitForSingleObject");
+            CloseHandle(wait->process);
+            return false;
+        }
+        waits[pid] = std::move(wait);
+        return true;
+    }
+
+    ULONGLONG GetCreated(DWORD pid) const {
+        const auto it = waits.find(pid);
+        return it != waits.end() ? it->second->created : 0;
+    }
+
+    // A launcher that exits after starting its worker would drop the hold: its children
+    // still running are tracked in its place, as OnFork does on Linux. Children of the
+    // pid's earlier owner are told apart by being older than the process that exited.
+    void AdoptChildren(ProcessWatchList& list, DWORD parent, ULONGLONG parentCreated) {
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        if (snapshot == INVALID_HANDLE_VALUE) {
+            Utils::CheckWinApiBool(FALSE, L"CreateToolhelp32Snapshot");
+            return;
+        }
+        PROCESSENTRY32W entry = {};
+        entry.dwSize = sizeof(entry);
+        for (BOOL ok = Process32FirstW(snapshot, &entry); ok; ok = Process32NextW(snapshot, &entry)) {
+            const DWORD child = entry.th32ProcessID;
+            if (entry.th32ParentProcessID != parent || child == parent) {
+                continue;
+            }
+            if (!WatchExit(child)) {
+                continue;
+            }
+            const ULONGLONG childCreated = GetCreated(child);
+            if (parentCreated != 0 && childCreated != 0 && childCreated < parentCreated) {
+                CancelExit(child);
+                continue;
+            }
+            list.OnFork(parent, child);
+        }
+        CloseHandle(snapshot);
+    }
+
+    void CancelExit(DWORD pid) {
+        const auto it = waits.find(pid);
+        if (it == waits.end()) {
+            return;
+        }
+        // Waits for a running callback, so the ExitWait outlives it.
+        UnregisterWaitEx(it->second->wait, INVALID_HANDLE_VALUE);
+        CloseHandle(it->second->process);
+        waits.erase(it);
+    }
+
+    void CancelAllExits() {
+        while (!waits.empty()) {
+            CancelExit(waits.begin()->first);
+        }
+    }
+};
+
+ProcessWatcher::ProcessWatcher(ProcessWatchList& list)
+    : m_list(list) {
+}
+
+ProcessWatcher::~ProcessWatcher() {
+    Stop();
+}
+
+bool ProcessWatcher::Start(HWND window, UINT message) {
+    if (m_impl) {
+        return true;
+    }
+
+    m_impl = std::make_unique<Impl>();
+    m_impl->queue = std::make_shared<EventQueue>(window, message);
+
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+    m_impl->comInitialized = SUCCEEDED(hr);
+    if (FAILED(hr) && hr != RPC_E_CHANGED_MODE) {
+        Utils::DebugLog(L"[Everon] Process watcher: CoInitializeEx failed (0x%08lx)\n", static_cast<unsigned long>(hr));
+        Stop();
+        return false;
+    }
+    // Process-wide; RPC_E_TOO_LATE when already set, which is fine.
+    CoInitializeSecurity(nullptr, -1, nullptr, nullptr, RPC_C_AUTHN_LEVEL_DEFAULT, RPC_C_IMP_LEVEL_IMPERSONATE,
+                         nullptr, EOAC_NONE, nullptr);
+
+    IWbemLocator* locator = nullptr;
+    hr = CoCreateInstance(CLSID_WbemLocator, nullptr, CLSCTX_INPROC_SERVER, IID_IWbemLocator,
+                          reinterpret_cast<void**>(&locator));
+    if (SUCCEEDED(hr)) {
+        BSTR space = SysAllocString(L"ROOT\\CIMV2");
+        hr = locator->ConnectServer(space, nullptr, nullptr, nullptr, 0, nullptr, nullptr, &m_impl->services);
+        SysFreeString(space);
+        locator->Release();
+    }
+    if (SUCCEEDED(hr)) {
+        hr = CoSetProxyBlanket(m_impl->services, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, nullptr, RPC_C_AUTHN_LEVEL_CALL,
+                               RPC_C_IMP_LEVEL_IMPERSONATE, nullptr, EOAC_NONE);
+    }
+
+    // WMI calls the sink from its own process: hand it a stub from the unsecured
+    // apartment rather than demanding it authenticate to us.
+    IUnsecuredApartment* apartment = nullptr;
+    if (SUCCEEDED(hr)) {
+        hr = CoCreateInstance(CLSID_UnsecuredApartment, nullptr, CLSCTX_LOCAL_SERVER, IID_IUnsecuredApartment,
+                              reinterpret_cast<void**>(&apartment));
+    }
+    if (SUCCEEDED(hr)) {
+        EventSink* sink = new EventSink(m_impl->queue);
+        IUnknown* stub = nullptr;
+        hr = apartment->CreateObjectStub(sink, &stub);
+        sink->Release();
+        apartment->Release();
+        if (SUCCEEDED(hr)) {
+            hr = stub->QueryInterface(IID_IWbemObjectSink, reinterpret_cast<void**>(&m_impl->stub));
+            stub->Release();
+        }
+    }
+    if (SUCCEEDED(hr)) {
+        hr = m_impl->Subscribe(m_list);
+        if (FAILED(hr) && hr != E_INVALIDARG) {
+            // The start trace can be refused right away (access denied without admin
+            // rights) rather than through SetStatus: fall back to instance events now.
+            Utils::DebugLog(L"[Everon] Process watcher: start trace refused (0x%08lx), using instance events\n",
+                            static_cast<unsigned long>(hr));
+            m_impl->polling = true;
+            hr = m_impl->Subscribe(m_list);
+        }
+    }
+    if (FAILED(hr)) {
+        Utils::DebugLog(L"[Everon] Process watcher: WMI unavailable (0x%08lx)\n", static_cast<unsigned long>(hr));
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+void ProcessWatcher::Stop() {
+    if (!m_impl) {
+        return;
+    }
+    m_impl->Unsubscribe();
+    if (m_impl->stub) {
+        m_impl->stub->Release();
+    }
+    if (m_impl->services) {
+        m_impl->services->Release();
+    }
+    m_impl->CancelAllExits();
+    if (m_impl->comInitialized) {
+        CoUninitialize();
+    }
+    m_impl.reset();
+}
+
+bool ProcessWatcher::IsStarted() const noexcept {
+    return m_impl != nullptr;
+}
+
+bool ProcessWatcher::Consume() {
+    if (!m_impl) {
+        return false;
+    }
+    const bool before = m_list.IsAnyRunning();
+    for (ProcessEvent& event : m_impl->queue->Take()) {
+        ++m_events;
+        switch (event.kind) {
+            case ProcessEvent::Started:
+                if (m_list.OnStart(event.pid, event.image) && !m_impl->WatchExit(event.pid)) {
+                    m_list.OnExit(event.pid);
+                }
+                break;
+            case ProcessEvent::Exited: {
+                const ULONGLONG created = m_impl->GetCreated(event.pid);
+                m_impl->CancelExit(event.pid);
+                m_impl->AdoptChildren(m_list, event.pid, created);
+                m_list.OnExit(event.pid);
+                break;
+            }
+            case ProcessEvent::QueryFailed:
+                Utils::DebugLog(L"[Everon] Process watcher: %ls query ended (0x%08lx)\n",
+                                m_impl->polling ? L"instance" : L"start trace", static_cast<unsigned long>(event.pid));
+                if (!m_impl->polling) {
+                    m_impl->Unsubscribe();
+                    m_impl->polling = true;
+                    m_impl->Subscribe(m_list);
+                }
+                break;
+        }
+    }
+    return m_list.IsAnyRunning() != before;
+}
+
+bool ProcessWatcher::Scan() {
+    const bool before = m_list.IsAnyRunning();
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) {
+        return Utils::CheckWinApiBool(FALSE, L"CreateToolhelp32Snapshot");
+    }
+    ++m_scans;
+    m_list.ClearRunning();
+    if (m_impl) {
+        m_impl->CancelAllExits();
+    }
+
+    PROCESSENTRY32W entry = {};
+    entry.dwSize = sizeof(entry);
+    for (BOOL ok = Process32FirstW(snapshot, &entry); ok; ok = Process32NextW(snapshot, &entry)) {
+        if (m_list.OnStart(entry.th32ProcessID, ToUtf8(entry.szExeFile)) &&
+            !(m_impl && m_impl->WatchExit(entry.th32ProcessID))) {
+            // Without an exit wait it would stay tracked forever.
+            m_list.OnExit(entry.th32ProcessID);
+        }
+    }
+    CloseHandle(snapshot);
+    return m_list.IsAnyRunning() != before;
+}
+
+} // namespace Everon
@@ -0,0 +1,169 @@
+#include "SensorSampler.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace Everon {
+
+SensorSampler::SensorSampler(ULONGLONG tick) noexcept
+    : m_tick(tick ? tick : DEFAULT_TICK) {
+}
+
+ULONGLONG SensorSampler::RoundInterval(ULONGLONG interval) const noexcept {
+    ULONGLONG lower = m_tick;
+    while (lower * 2 <= interval && lower * 2 > lower) {
+        lower *= 2;
+    }
+    if (interval <= lower) {
+        return lower;
+    }
+    return (interval - lower > lower * 2 - interval) ? lower * 2 : lower;
+}
+
+ULONGLONG SensorSampler::NextGridPoint(ULONGLONG now, ULONGLONG interval) noexcept {
+    return (now / interval + 1) * interval;
+}
+
+SensorSampler::SensorId SensorSampler::Add(const std::string& name, ULONGLONG minInterval,
+                                           ULONGLONG maxInterval, ReadFn read, ULONGLONG now) {
+    // A slot still holding a callback may be the one running right now: leave it be.
+    Sensor* sensor = nullptr;
+    size_t index = 0;
+    for (; index < m_sensors.size(); ++index) {
+        if (m_sensors[index].generation == 0 && !m_sensors[index].read) {
+            sensor = &m_sensors[index];
+            break;
+        }
+    }
+    if (!sensor) {
+        m_sensors.emplace_back();
+        sensor = &m_sensors.back();
+    }
+
+    sensor->name = name;
+    sensor->read = std::move(read);
+    sensor->minInterval = RoundInterval(minInterval);
+    sensor->maxInterval = (std::max)(sensor->minInterval, RoundInterval(maxInterval));
+    sensor->stats = Stats{};
+    sensor->stats.interval = sensor->minInterval;
+    sensor->due = NextGridPoint(now, sensor->minInterval);
+    sensor->generation = m_nextGeneration++;
+    ++m_active;
+    return SensorId{ index, sensor->generation };
+}
+
+void SensorSampler::Release(Sensor& sensor) noexcept {
+    sensor.generation = 0;
+    --m_active;
+    if (!m_inRun) {
+        sensor.read = nullptr;
+    }
+}
+
+void SensorSampler::Remove(SensorId& id) noexcept {
+    if (IsActive(id)) {
+        Release(m_sensors[id.index]);
+    }
+    id = SensorId{};
+}
+
+bool SensorSampler::IsActive(const SensorId& id) const noexcept {
+    return id.IsValid() && id.index < m_sensors.size() && m_sensors[id.index].generation == id.generation;
+}
+
+size_t SensorSampler::Run(ULONGLONG now) {
+    m_inRun = true;
+    size_t count = 0;
+    // One CPU-time read per sensor: each read's end is the next one's start.
+    ULONGLONG cpuBefore = 0;
+    // Sensors added by a read are not due yet; the size may grow, addresses do not move.
+    for (size_t i = 0; i < m_sensors.size(); ++i) {
+        Sensor& sensor = m_sensors[i];
+        if (sensor.generation == 0 || sensor.due > now) {
+            continue;
+        }
+        if (count == 0) {
+            cpuBefore = Platform::GetThreadCpuTicks();
+        }
+        const ULONGLONG generation = sensor.generation;
+        const SensorTrend trend = sensor.read(now);
+        const ULONGLONG cpuAfter = Platform::GetThreadCpuTicks();
+        const ULONGLONG cpu = cpuAfter - cpuBefore;
+        cpuBefore = cpuAfter;
+        ++count;
+        if (sensor.generation != generation) {
+            continue;   // removed by its own read
+        }
+
+        Stats& stats = sensor.stats;
+        ++stats.reads;
+        stats.cpuTicks += cpu;
+        switch (trend) {
+            case SensorTrend::NearThreshold:
+                stats.interval = sensor.minInterval;
+                break;
+            case SensorTrend::Changing:
+                stats.interval = (std::max)(sensor.minInterval, stats.interval / 2);
+                break;
+            case SensorTrend::Stable:
+                stats.interval = (std::min)(sensor.maxInterval, stats.interval * 2);
+                break;
+        }
+        sensor.due = NextGridPoint(now, stats.interval);
+    }
+    m_inRun = false;
+
+    for (Sensor& sensor : m_sensors) {
+        if (sensor.generation == 0 && sensor.read) {
+            sensor.read = nullptr;
+        }
+    }
+    if (count != 0) {
+        ++m_wakeups;
+        m_reads += count;
+    }
+    return count;
+}
+
+bool SensorSampler::GetNextDeadline(ULONGLONG& deadline, ULONGLONG& tolerance) const noexcept {
+    bool found = false;
+    for (const Sensor& sensor : m_sensors) {
+        if (sensor.generation == 0) {
+            continue;
+        }
+        const ULONGLONG slack = sensor.stats.interval / 4;
+        if (!found || sensor.due < deadline) {
+            deadline = sensor.due;
+            tolerance = slack;
+            found = true;
+        } else if (sensor.due == deadline) {
+            tolerance = (std::min)(tolerance, slack);
+        }
+    }
+    return found;
+}
+
+const SensorSampler::Stats* SensorSampler::GetStats(const SensorId& id) const noexcept {
+    return IsActive(id) ? &m_sensors[id.index].stats : nullptr;
+}
+
+std::string SensorSampler::DescribeStats() const {
+    std::string out;
+    char part[128];
+    for (const Sensor& sensor : m_sensors) {
+        if (sensor.generation == 0) {
+            continue;
+        }
+        const Stats& stats = sensor.stats;
+        const double usPerRead = stats.reads ? static_cast<double>(stats.cpuTicks) / 10.0 / static_cast<double>(stats.reads) : 0.0;
+        std::snprintf(part, sizeof(part), "%s %llu reads, %.1f us/read, every %llu s", sensor.name.c_str(),
+                      static_cast<unsigned long long>(stats.reads), usPerRead,
+                      static_cast<unsigned long long>(stats.interval / 10000000ULL));
+        if (!out.empty()) {
+            out += "; ";
+        }
+        out += part;
+    }
+    return out;
+}
+
+} // namespace Everon
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Platform.h"
+#include <deque>
+#include <functional>
+#include <string>
+
+namespace Everon {
+
+// What a sensor's latest reading says about how soon it needs reading again.
+enum class SensorTrend : unsigned char {
+    Stable,         // nothing moving: back off toward the longest interval
+    Changing,       // moving, no decision close: step toward the shortest interval
+    NearThreshold   // a decision may be imminent: shortest interval right away
+};
+
+// Every polled sensor (activity rates, the OS idle timeout, ...) on one shared tick, so
+// adding a sensor does not add wakeups. Intervals are the tick times a power of two and
+// due times are multiples of the interval on one global grid: a slower sensor's read
+// always coincides with a faster one's, and one wakeup reads every sensor due. Each
+// sensor's interval adapts to its trend between its own bounds.
+class SensorSampler {
+public:
+    // Returns the trend of the reading taken at monotonic time `now`.
+    using ReadFn = std::function<SensorTrend(ULONGLONG now)>;
+
+    // Opaque handle; stale handles (removed sensors) are detected and ignored.
+    struct SensorId {
+        size_t index = 0;
+        ULONGLONG generation = 0;
+        bool IsValid() const noexcept { return generation != 0; }
+    };
+
+    struct Stats {
+        ULONGLONG reads = 0;
+        ULONGLONG cpuTicks = 0;     // thread CPU time spent reading (coarse on Windows: average many)
+        ULONGLONG interval = 0;     // current interval
+    };
+
+    explicit SensorSampler(ULONGLONG tick = DEFAULT_TICK) noexcept;
+
+    static constexpr ULONGLONG DEFAULT_TICK = 10000000ULL;   // 1 s
+
+    // Bounds are rounded to the nearest tick * 2^k. The first read is due on the next
+    // grid point of `minInterval`.
+    SensorId Add(const std::string& name, ULONGLONG minInterval, ULONGLONG maxInterval, ReadFn read,
+                 ULONGLONG now);
+    // Safe from inside a ReadFn (including the sensor's own).
+    void Remove(SensorId& id) noexcept;
+    bool IsActive(const SensorId& id) const noexcept;
+    bool IsEmpty() const noexcept { return m_active == 0; }
+
+    // Reads every sensor due at `now`, in one batch. Returns the number read.
+    size_t Run(ULONGLONG now);
+
+    // Next batch, and how late it may run: a quarter of the shortest interval due then.
+    bool GetNextDeadline(ULONGLONG& deadline, ULONGLONG& tolerance) const noexcept;
+
+    const Stats* GetStats(const SensorId& id) const noexcept;
+    ULONGLONG GetWakeupCount() const noexcept { return m_wakeups; }
+    ULONGLONG GetReadCount() const noexcept { return m_reads; }
+    // "cpu 412 reads, 5.3 us/read, every 16 s; ...", for the log.
+    std::string DescribeStats() const;
+
+    // `interval` rounded to the nearest tick * 2^k (at least one tick).
+    ULONGLONG RoundInterval(ULONGLONG interval) const noexcept;
+
+private:
+    struct Sensor {
+        std::string name;
+        ReadFn read;
+        ULONGLONG minInterval = 0;
+        ULONGLONG maxInterval = 0;
+        ULONGLONG due = 0;
+        ULONGLONG generation = 0;   // 0 = free slot
+        Stats stats;
+    };
+
+    static ULONGLONG NextGridPoint(ULONGLONG now, ULONGLONG interval) noexcept;
+    void Release(Sensor& sensor) noexcept;
+
+    ULONGLONG m_tick;
+    std::deque<Sensor> m_sensors;   // stable addresses: Add() during Run() is safe
+    size_t m_active = 0;
+    ULONGLONG m_nextGeneration = 1;
+    ULONGLONG m_wakeups = 0;
+    ULONGLONG m_reads = 0;
+    bool m_inRun = false;
+};
+
+} // namespace Everon
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Platform.h"
+#include <string>
+
+#ifndef _WIN32
+#include "DBusConnection.h"
+#endif
+
+namespace Everon {
+
+// Whether anyone can see or use this login session.
+struct SessionState {
+    bool locked = false;
+    bool active = true;     // foreground and connected (false: switched away, RDP disconnected)
+
+    // Locked or inactive: input injected here reaches nobody.
+    bool IsIdle() const noexcept { return locked || !active; }
+};
+
+#ifndef _WIN32
+
+// Follows this process's logind session: the Lock/Unlock signals, and Active/LockedHint
+// re-read whenever the session announces PropertiesChanged. Event driven: the bus socket
+// is polled together with the other descriptors and read only when it has data.
+// Windows delivers the same events as WM_WTSSESSION_CHANGE (see App).
+class SessionMonitor {
+public:
+    // Talks to logind on `busAddress` (default: the system bus).
+    SessionMonitor();
+    explicit SessionMonitor(std::string busAddress);
+
+    // Finds the session, subscribes to its signals and reads the initial state.
+    bool Start();
+    void Stop();
+
+    // Descriptor to poll for readability, -1 when not started.
+    int GetFd() const noexcept { return m_bus.GetFd(); }
+
+    // Call when GetFd() is readable. True if the state changed.
+    bool Consume();
+
+    const SessionState& GetState() const noexcept { return m_state; }
+    const std::string& GetSessionPath() const noexcept { return m_path; }
+
+private:
+    bool FindSession();
+    bool Refresh();
+    bool GetBool(const char* property, bool& value);
+
+    std::string m_busAddress;
+    DBusConnection m_bus;
+    std::string m_path;
+    SessionState m_state;
+};
+
+#endif
+
+} // namespace Everon
@@ -0,0 +1,115 @@
+#include "SessionMonitor.h"
+#include <cstdlib>
+#include <unistd.h>
+#include <utility>
+
+namespace Everon {
+
+namespace {
+
+constexpr const char* kLogind = "org.freedesktop.login1";
+constexpr const char* kSessionInterface = "org.freedesktop.login1.Session";
+
+} // namespace
+
+SessionMonitor::SessionMonitor()
+    : m_busAddress(DBusConnection::SystemBusAddress()) {
+}
+
+SessionMonitor::SessionMonitor(std::string busAddress)
+    : m_busAddress(std::move(busAddress)) {
+}
+
+bool SessionMonitor::Start() {
+    if (m_bus.IsConnected()) {
+        return true;
+    }
+    if (!m_bus.Connect(m_busAddress) || !FindSession()) {
+        Stop();
+        return false;
+    }
+
+    const std::string match = std::string("type='signal',sender='") + kLogind + "',path='" + m_path + "'";
+    if (!m_bus.AddMatch(match + ",interface='" + kSessionInterface + "'") ||
+        !m_bus.AddMatch(match + ",interface='org.freedesktop.DBus.Properties',member='PropertiesChanged'")) {
+        Stop();
+        return false;
+    }
+
+    m_state = SessionState();
+    Refresh();
+    return true;
+}
+
+void SessionMonitor::Stop() {
+    m_bus.Close();
+    m_path.clear();
+}
+
+bool SessionMonitor::FindSession() {
+    DBusMessage call = DBusMessage::CreateMethodCall(kLogind, "/org/freedesktop/login1",
+                                                     "org.freedesktop.login1.Manager", "GetSessionByPID");
+    call.AppendUint32(static_cast<uint32_t>(getpid()));
+    DBusMessage reply;
+    if (m_bus.Call(call, reply) && reply.ReadObjectPath(m_path)) {
+        return true;
+    }
+
+    // Not in a session of our own (e.g. started by a service manager): use the login's.
+    const char* id = std::getenv("XDG_SESSION_ID");
+    if (!id || !*id) {
+        return false;
+    }
+    DBusMessage byId = DBusMessage::CreateMethodCall(kLogind, "/org/freedesktop/login1",
+                                                     "org.freedesktop.login1.Manager", "GetSession");
+    byId.AppendString(id);
+    return m_bus.Call(byId, reply) && reply.ReadObjectPath(m_path);
+}
+
+bool SessionMonitor::GetBool(const char* property, bool& value) {
+    DBusMessage call = DBusMessage::CreateMethodCall(kLogind, m_path, "org.freedesktop.DBus.Properties", "Get");
+    call.AppendString(kSessionInterface);
+    call.AppendString(property);
+    DBusMessage reply;
+    char type = 0;
+    return m_bus.Call(call, reply) && reply.ReadVariant(type) && reply.ReadBool(value);
+}
+
+bool SessionMonitor::Refresh() {
+    // LockedHint is set by the screen locker; older logind versions lack it.
+    bool active = m_state.active;
+    bool locked = m_state.locked;
+    const bool ok = GetBool("Active", active);
+    GetBool("LockedHint", locked);
+    m_state.active = active;
+    m_state.locked = locked;
+    return ok;
+}
+
+bool SessionMonitor::Consume() {
+    const SessionState before = m_state;
+    DBusMessage message;
+    for (;;) {
+        bool refresh = false;
+        while (m_bus.ReadMessage(message, 0)) {
+            if (message.GetType() != DBusMessage::Signal || message.GetPath() != m_path) {
+                continue;
+            }
+            if (message.GetMember() == "Lock") {
+                m_state.locked = true;
+            } else if (message.GetMember() == "Unlock") {
+                m_state.locked = false;
+            } else if (message.GetMember() == "PropertiesChanged") {
+                refresh = true;
+            }
+        }
+        if (!refresh) {
+            break;
+        }
+        // Signals that arrive during the re-read are queued; the next pass takes them.
+        Refresh();
+    }
+    return m_state.locked != before.locked || m_state.active != before.active;
+}
+
+} // namespace Everon
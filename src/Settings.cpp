@@ -1,9 +1,8 @@
 #include "Settings.h"
 #include "Localization.h"
-#include "HotkeyManager.h"
+#include "HotkeyConfig.h"
 #include "TimerMode.h"
-#include "Utils.h"
-#include <strsafe.h>
+#include <algorithm>
 
 namespace Everon {
 
@@ -31,9 +30,11 @@ bool IsSameTimerConfig(const TimerConfig& a, const TimerConfig& b) noexcept {
 } // namespace
 
 Settings::Settings() {
+#ifdef _WIN32
     m_autoStart = IsAutoStartEnabled();
+#endif
     // Default UntilTime to current local time for a nicer UI default.
-    GetLocalTime(&m_timerConfig.untilTime);
+    Platform::GetLocalTime(m_timerConfig.untilTime);
 }
 
 Language Settings::GetLanguage() const noexcept {
@@ -67,12 +68,16 @@ void Settings::SetTimerConfig(const TimerConfig& value) noexcept {
     if (!IsSameTimerConfig(m_timerConfig, value)) {
         m_timerConfig = value;
         m_dirty = true;
+    } else {
+        // Runtime-only state is never persisted, so it does not make settings dirty.
+        m_timerConfig.endTimeMonotonic = value.endTimeMonotonic;
     }
 }
 
 void Settings::SetPeriodSec(DWORD value) noexcept {
     if (IsValidPeriod(value) && m_periodSec != value) {
         m_periodSec = value;
+        m_idleThresholdSec = (std::min)(m_idleThresholdSec, value);
         m_dirty = true;
     }
 }
@@ -98,360 +103,152 @@ void Settings::SetShowToggleNotifications(bool value) noexcept {
     }
 }
 
-void Settings::SetEnabled(bool value) noexcept {
-    if (m_enabled != value) {
-        m_enabled = value;
+void Settings::SetEfficiencyMode(bool value) noexcept {
+    if (m_efficiencyMode != value) {
+        m_efficiencyMode = value;
         m_dirty = true;
     }
 }
 
-bool Settings::IsValidPeriod(DWORD value) const noexcept {
-    return value >= MIN_PERIOD_SEC && value <= MAX_PERIOD_SEC;
-}
-
-bool Settings::IsValidVirtualKey(WORD vk) const noexcept {
-    return vk == 0 || vk == VK_F15 || vk == VK_F16 || vk == VK_F17;
-}
-
-bool Settings::LoadFromRegistry() {
-    HKEY hKey = nullptr;
-    const LONG openRes = RegOpenKeyExW(HKEY_CURRENT_USER, REG_KEY_PATH, 0, KEY_READ, &hKey);
-    if (openRes != ERROR_SUCCESS) {
-        if (openRes != ERROR_FILE_NOT_FOUND) {
-            Utils::CheckWinApiStatus(openRes, L"RegOpenKeyExW(HKCU\\\\Software\\\\Everon)");
-        }
-        // First run (or settings cleared). Keep defaults but ensure language/autostart are initialized.
-        SetLanguage(Localization::DetectSystemLanguage());
-        m_autoStart = IsAutoStartEnabled();
-        m_dirty = false;
-        return true;
+void Settings::SetWakeupBudgetPerHour(DWORD value) noexcept {
+    if (m_wakeupBudgetPerHour != value) {
+        m_wakeupBudgetPerHour = value;
+        m_dirty = true;
     }
+}
 
-    auto ReadDword = [hKey](const wchar_t* name, DWORD& outValue) -> bool {
-        DWORD type = 0;
-        DWORD size = sizeof(DWORD);
-        DWORD value = 0;
-        const LONG res = RegQueryValueExW(hKey, name, nullptr, &type,
-                                          reinterpret_cast<LPBYTE>(&value), &size);
-        if (res == ERROR_SUCCESS && type == REG_DWORD) {
-            outValue = value;
-            return true;
-        }
-        if (res != ERROR_SUCCESS && res != ERROR_FILE_NOT_FOUND) {
-            Utils::CheckWinApiStatus(res, L"RegQueryValueExW(REG_DWORD)");
-        }
-        return false;
-    };
-
-    auto ReadQword = [hKey](const wchar_t* name, ULONGLONG& outValue) -> bool {
-        DWORD type = 0;
-        DWORD size = sizeof(ULONGLONG);
-        ULONGLONG value = 0;
-        const LONG res = RegQueryValueExW(hKey, name, nullptr, &type,
-                                          reinterpret_cast<LPBYTE>(&value), &size);
-        if (res == ERROR_SUCCESS && type == REG_QWORD) {
-            outValue = value;
-            return true;
-        }
-        if (res != ERROR_SUCCESS && res != ERROR_FILE_NOT_FOUND) {
-            Utils::CheckWinApiStatus(res, L"RegQueryValueExW(REG_QWORD)");
-        }
-        return false;
-    };
-
-    auto ReadString = [hKey](const wchar_t* name, wchar_t* buffer, DWORD bufferSize) -> bool {
-        DWORD type = 0;
-        DWORD size = bufferSize;
-        const LONG res = RegQueryValueExW(hKey, name, nullptr, &type,
-                                          reinterpret_cast<LPBYTE>(buffer), &size);
-        if (res == ERROR_SUCCESS && (type == REG_SZ || type == REG_EXPAND_SZ)) {
-            return true;
-        }
-        if (res != ERROR_SUCCESS && res != ERROR_FILE_NOT_FOUND) {
-            Utils::CheckWinApiStatus(res, L"RegQueryValueExW(REG_SZ)");
-        }
-        return false;
-    };
-
-    DWORD tempDword = 0;
-    if (ReadDword(L"PeriodSec", tempDword)) {
-        SetPeriodSec(tempDword);
-    }
-    if (ReadDword(L"VkKey", tempDword)) {
-        SetVirtualKey(static_cast<WORD>(tempDword));
-    }
-    if (ReadDword(L"KeepDisplayOn", tempDword)) {
-        m_keepDisplayOn = (tempDword != 0);
-    }
-    if (ReadDword(L"ShowToggleNotifications", tempDword)) {
-        m_showToggleNotifications = (tempDword != 0);
-    }
-    if (ReadDword(L"Enabled", tempDword)) {
-        m_enabled = (tempDword != 0);
+void Settings::SetKeypressJitterSec(DWORD value) noexcept {
+    if (m_keypressJitterSec != value) {
+        m_keypressJitterSec = value;
+        m_dirty = true;
     }
+}
 
-    wchar_t langBuffer[16] = {};
-    if (ReadString(L"Language", langBuffer, sizeof(langBuffer))) {
-        SetLanguage(Localization::StringToLanguage(langBuffer));
-    } else {
-        SetLanguage(Localization::DetectSystemLanguage());
+void Settings::SetIdleThresholdSec(DWORD value) noexcept {
+    // Longer than the period, an active user could never be told apart from an idle one.
+    value = (std::min)(value, m_periodSec);
+    if (m_idleThresholdSec != value) {
+        m_idleThresholdSec = value;
+        m_dirty = true;
     }
+}
 
-
-    // Hotkey
-    wchar_t hotkeyBuffer[128] = {};
-    if (ReadString(L"Hotkey", hotkeyBuffer, sizeof(hotkeyBuffer))) {
-        m_hotkeyConfig = HotkeyManager::StringToHotkey(hotkeyBuffer);
+void Settings::SetAdaptivePeriod(bool value) noexcept {
+    if (m_adaptivePeriod != value) {
+        m_adaptivePeriod = value;
+        m_dirty = true;
     }
+}
 
-    // Timer
-    TimerConfig timer = m_timerConfig;
-
-    DWORD tempMode = 0;
-    if (ReadDword(L"TimerMode", tempMode)) {
-        timer.mode = static_cast<TimerMode>(tempMode);
-    }
-    DWORD tempDuration = timer.durationMinutes;
-    if (ReadDword(L"TimerDuration", tempDuration)) {
-        timer.durationMinutes = tempDuration;
+void Settings::SetKeepAwakeWhenLocked(bool value) noexcept {
+    if (m_keepAwakeWhenLocked != value) {
+        m_keepAwakeWhenLocked = value;
+        m_dirty = true;
     }
+}
 
-    DWORD type = 0;
-    DWORD size = sizeof(SYSTEMTIME);
-    SYSTEMTIME st = {};
-
-    LONG qRes = RegQueryValueExW(hKey, L"TimerUntilTime", nullptr, &type,
-                                 reinterpret_cast<LPBYTE>(&st), &size);
-    if (qRes == ERROR_SUCCESS && type == REG_BINARY && size == sizeof(SYSTEMTIME)) {
-        timer.untilTime = st;
-    } else if (qRes != ERROR_SUCCESS && qRes != ERROR_FILE_NOT_FOUND) {
-        Utils::CheckWinApiStatus(qRes, L"RegQueryValueExW(TimerUntilTime)");
+void Settings::SetWatchProcesses(const std::wstring& value) {
+    if (m_watchProcesses != value) {
+        m_watchProcesses = value;
+        m_dirty = true;
     }
+}
 
-    size = sizeof(SYSTEMTIME);
-    st = {};
-    qRes = RegQueryValueExW(hKey, L"TimerStartTime", nullptr, &type,
-                            reinterpret_cast<LPBYTE>(&st), &size);
-    if (qRes == ERROR_SUCCESS && type == REG_BINARY && size == sizeof(SYSTEMTIME)) {
-        timer.startTime = st;
-    } else if (qRes != ERROR_SUCCESS && qRes != ERROR_FILE_NOT_FOUND) {
-        Utils::CheckWinApiStatus(qRes, L"RegQueryValueExW(TimerStartTime)");
+void Settings::SetCpuActivityPercent(DWORD value) noexcept {
+    value = (std::min)(value, DWORD{ 100 });
+    if (m_cpuActivityPercent != value) {
+        m_cpuActivityPercent = value;
+        m_dirty = true;
     }
+}
 
-    // Timer runtime end moment (UTC) - preferred over legacy startTime for DST robustness
-    ULONGLONG tempQword = 0;
-    if (ReadQword(L"TimerEndUtc", tempQword)) {
-        timer.endTimeUtc = tempQword;
-    } else if (timer.mode == TimerMode::Duration && timer.startTime.wYear != 0) {
-        // Backward compatibility: compute endTimeUtc from legacy startTime
-        SYSTEMTIME startUtc = {};
-        if (!TzSpecificLocalTimeToSystemTime(nullptr, &timer.startTime, &startUtc)) {
-            startUtc = timer.startTime;
-        }
-        FILETIME startFt = {};
-        if (SystemTimeToFileTime(&startUtc, &startFt)) {
-            ULARGE_INTEGER u;
-            u.LowPart = startFt.dwLowDateTime;
-            u.HighPart = startFt.dwHighDateTime;
-            timer.endTimeUtc = u.QuadPart + (static_cast<ULONGLONG>(timer.durationMinutes) * 60ULL * 10000000ULL);
-        }
+void Settings::SetDiskActivityKBps(DWORD value) noexcept {
+    if (m_diskActivityKBps != value) {
+        m_diskActivityKBps = value;
+        m_dirty = true;
     }
+}
 
-    // Sanity check
-    if (!timer.IsValid()) {
-        timer = TimerConfig{};
-        GetLocalTime(&timer.untilTime);
+void Settings::SetNetworkActivityKBps(DWORD value) noexcept {
+    if (m_networkActivityKBps != value) {
+        m_networkActivityKBps = value;
+        m_dirty = true;
     }
-    m_timerConfig = timer;
-
-    const LONG closeRes = RegCloseKey(hKey);
-    Utils::CheckWinApiStatus(closeRes, L"RegCloseKey(HKCU\\\\Software\\\\Everon)");
-    m_autoStart = IsAutoStartEnabled();
-    m_dirty = false;
-    return true;
 }
 
-bool Settings::SaveToRegistry() {
-    if (!m_dirty) {
-        return true;
+void Settings::SetActivitySustainSec(DWORD value) noexcept {
+    value = (std::max)(MIN_ACTIVITY_SUSTAIN_SEC, (std::min)(value, MAX_ACTIVITY_SUSTAIN_SEC));
+    if (m_activitySustainSec != value) {
+        m_activitySustainSec = value;
+        m_dirty = true;
     }
+}
 
-    HKEY hKey = nullptr;
-    const LONG createRes = RegCreateKeyExW(HKEY_CURRENT_USER, REG_KEY_PATH, 0, nullptr, 0,
-                                           KEY_WRITE, nullptr, &hKey, nullptr);
-    if (!Utils::CheckWinApiStatus(createRes, L"RegCreateKeyExW(HKCU\\\\Software\\\\Everon)")) {
-        return false;
+void Settings::SetWatchFolders(const std::wstring& value) {
+    if (m_watchFolders != value) {
+        m_watchFolders = value;
+        m_dirty = true;
     }
+}
 
-    auto WriteDword = [hKey](const wchar_t* name, DWORD value) -> bool {
-        const LONG res = RegSetValueExW(hKey, name, 0, REG_DWORD,
-                                        reinterpret_cast<const BYTE*>(&value),
-                                        sizeof(value));
-        if (!Utils::CheckWinApiStatus(res, L"RegSetValueExW(REG_DWORD)")) {
-            Utils::DebugLog(L"[Everon][Reg] Failed to write DWORD value '%s'\n", name);
-            return false;
-        }
-        return true;
-    };
-
-    auto WriteString = [hKey](const wchar_t* name, const wchar_t* value) -> bool {
-        DWORD size = static_cast<DWORD>((wcslen(value) + 1) * sizeof(wchar_t));
-        const LONG res = RegSetValueExW(hKey, name, 0, REG_SZ,
-                                        reinterpret_cast<const BYTE*>(value),
-                                        size);
-        if (!Utils::CheckWinApiStatus(res, L"RegSetValueExW(REG_SZ)")) {
-            Utils::DebugLog(L"[Everon][Reg] Failed to write string value '%s'\n", name);
-            return false;
-        }
-        return true;
-    };
-
-    auto WriteQword = [hKey](const wchar_t* name, ULONGLONG value) -> bool {
-        const LONG res = RegSetValueExW(hKey, name, 0, REG_QWORD,
-                                        reinterpret_cast<const BYTE*>(&value),
-                                        sizeof(value));
-        if (!Utils::CheckWinApiStatus(res, L"RegSetValueExW(REG_QWORD)")) {
-            Utils::DebugLog(L"[Everon][Reg] Failed to write QWORD value '%s'\n", name);
-            return false;
-        }
-        return true;
-    };
-
-    bool success = true;
-    success &= WriteDword(L"PeriodSec", m_periodSec);
-    success &= WriteDword(L"VkKey", static_cast<DWORD>(m_vkKey));
-    success &= WriteDword(L"KeepDisplayOn", m_keepDisplayOn ? 1 : 0);
-    success &= WriteDword(L"ShowToggleNotifications", m_showToggleNotifications ? 1 : 0);
-    success &= WriteDword(L"Enabled", m_enabled ? 1 : 0);
-    success &= WriteString(L"Language", Localization::LanguageToString(GetLanguage()));
-
-    success &= WriteString(L"Hotkey", HotkeyManager::HotkeyToRegistryString(m_hotkeyConfig).c_str());
-
-    const TimerConfig& timer = m_timerConfig;
-    success &= WriteDword(L"TimerMode", static_cast<DWORD>(timer.mode));
-    success &= WriteDword(L"TimerDuration", timer.durationMinutes);
-    LONG res = RegSetValueExW(hKey, L"TimerUntilTime", 0, REG_BINARY,
-                              reinterpret_cast<const BYTE*>(&timer.untilTime),
-                              sizeof(SYSTEMTIME));
-    if (!Utils::CheckWinApiStatus(res, L"RegSetValueExW(TimerUntilTime)")) {
-        success = false;
+void Settings::SetFolderQuietSec(DWORD value) noexcept {
+    value = (std::max)(MIN_FOLDER_QUIET_SEC, (std::min)(value, MAX_FOLDER_QUIET_SEC));
+    if (m_folderQuietSec != value) {
+        m_folderQuietSec = value;
+        m_dirty = true;
     }
+}
 
-    res = RegSetValueExW(hKey, L"TimerStartTime", 0, REG_BINARY,
-                         reinterpret_cast<const BYTE*>(&timer.startTime),
-                         sizeof(SYSTEMTIME));
-    if (!Utils::CheckWinApiStatus(res, L"RegSetValueExW(TimerStartTime)")) {
-        success = false;
+void Settings::SetDisplayPolicy(const DisplayPolicy& value) noexcept {
+    DisplayPolicy policy = value;
+    if (policy.onMinutes > DisplayPolicy::MAX_ON_MINUTES) {
+        policy.onMinutes = 0;
     }
-
-    // Store end moment only for the currently enabled run; avoid stale values when disabled.
-    ULONGLONG endUtcToSave = 0;
-    if (m_enabled && timer.mode != TimerMode::Indefinite) {
-        endUtcToSave = timer.endTimeUtc;
+    if (policy.windowStartMinute >= DisplayPolicy::MINUTES_PER_DAY ||
+        policy.windowEndMinute >= DisplayPolicy::MINUTES_PER_DAY) {
+        policy.windowStartMinute = policy.windowEndMinute = 0;
     }
-    success &= WriteQword(L"TimerEndUtc", endUtcToSave);
-
-    const LONG closeRes = RegCloseKey(hKey);
-    Utils::CheckWinApiStatus(closeRes, L"RegCloseKey(HKCU\\\\Software\\\\Everon)");
 
-    if (success) {
-        m_dirty = false;
+    if (policy.onMinutes != m_displayPolicy.onMinutes ||
+        policy.windowStartMinute != m_displayPolicy.windowStartMinute ||
+        policy.windowEndMinute != m_displayPolicy.windowEndMinute) {
+        m_displayPolicy = policy;
+        m_dirty = true;
     }
-    return success;
 }
 
-bool Settings::IsAutoStartEnabled() {
-    HKEY hKey = nullptr;
-    const LONG openRes = RegOpenKeyExW(HKEY_CURRENT_USER, RUN_KEY_PATH, 0, KEY_READ, &hKey);
-    if (openRes != ERROR_SUCCESS) {
-        if (openRes != ERROR_FILE_NOT_FOUND) {
-            Utils::CheckWinApiStatus(openRes, L"RegOpenKeyExW(HKCU\\\\Run)");
-        }
-        return false;
-    }
-
-    wchar_t value[2048] = {};
-    DWORD type = 0;
-    DWORD size = sizeof(value);
-    LONG result = RegQueryValueExW(hKey, APP_NAME, nullptr, &type,
-                                   reinterpret_cast<LPBYTE>(value), &size);
-    const LONG closeRes = RegCloseKey(hKey);
-    Utils::CheckWinApiStatus(closeRes, L"RegCloseKey(HKCU\\\\Run)");
-
-    if (result != ERROR_SUCCESS || (type != REG_SZ && type != REG_EXPAND_SZ)) {
-        if (result != ERROR_FILE_NOT_FOUND) {
-            Utils::CheckWinApiStatus(result, L"RegQueryValueExW(HKCU\\\\Run\\\\Everon)");
-        }
-        return false;
+void Settings::SetBatteryPolicy(const BatteryPolicy& value) noexcept {
+    BatteryPolicy policy = value;
+    if (policy.onBattery > BatteryAction::Suspend) {
+        policy.onBattery = BatteryAction::None;
     }
-
-    wchar_t exePath[MAX_PATH] = {};
-    GetModuleFileNameW(nullptr, exePath, MAX_PATH);
-
-    // Expand environment variables if needed, then parse the first token.
-    std::wstring stored;
-    if (type == REG_EXPAND_SZ) {
-        wchar_t expanded[4096] = {};
-        DWORD expandedLen = ExpandEnvironmentStringsW(value, expanded, _countof(expanded));
-        if (expandedLen != 0 && expandedLen <= _countof(expanded)) {
-            stored = expanded;
-        } else {
-            stored = value;
-        }
-    } else {
-        stored = value;
+    if (policy.whenLow > BatteryAction::Suspend) {
+        policy.whenLow = BatteryAction::Suspend;
     }
-
-    std::wstring first;
-    if (!stored.empty() && stored[0] == L'"') {
-        size_t end = stored.find(L'"', 1);
-        if (end != std::wstring::npos) {
-            first = stored.substr(1, end - 1);
-        }
-    } else {
-        size_t end = stored.find_first_of(L" \t");
-        first = stored.substr(0, end);
+    if (policy.lowPercent > BatteryPolicy::MAX_LOW_PERCENT) {
+        policy.lowPercent = 0;
     }
 
-    if (first.empty()) {
-        return false;
+    if (policy.onBattery != m_batteryPolicy.onBattery || policy.lowPercent != m_batteryPolicy.lowPercent ||
+        policy.whenLow != m_batteryPolicy.whenLow) {
+        m_batteryPolicy = policy;
+        m_dirty = true;
     }
-
-    return _wcsicmp(first.c_str(), exePath) == 0;
 }
 
-bool Settings::SetAutoStartEnabled(bool enable) {
-    HKEY hKey = nullptr;
-    const LONG createRes = RegCreateKeyExW(HKEY_CURRENT_USER, RUN_KEY_PATH, 0, nullptr, 0,
-                                           KEY_WRITE, nullptr, &hKey, nullptr);
-    if (!Utils::CheckWinApiStatus(createRes, L"RegCreateKeyExW(HKCU\\\\Run)")) {
-        return false;
+void Settings::SetEnabled(bool value) noexcept {
+    if (m_enabled != value) {
+        m_enabled = value;
+        m_dirty = true;
     }
+}
 
-    bool success = false;
-    if (enable) {
-        wchar_t exePath[MAX_PATH] = {};
-        GetModuleFileNameW(nullptr, exePath, MAX_PATH);
-        wchar_t quotedPath[2048] = {};
-        StringCchPrintfW(quotedPath, _countof(quotedPath), L"\"%s\"", exePath);
-        DWORD size = static_cast<DWORD>((wcslen(quotedPath) + 1) * sizeof(wchar_t));
-        LONG setRes = RegSetValueExW(hKey, APP_NAME, 0, REG_SZ,
-                                     reinterpret_cast<const BYTE*>(quotedPath),
-                                     size);
-        success = Utils::CheckWinApiStatus(setRes, L"RegSetValueExW(HKCU\\\\Run\\\\Everon)");
-    } else {
-        LONG delRes = RegDeleteValueW(hKey, APP_NAME);
-        if (delRes == ERROR_SUCCESS || delRes == ERROR_FILE_NOT_FOUND) {
-            success = true;
-        } else {
-            Utils::CheckWinApiStatus(delRes, L"RegDeleteValueW(HKCU\\\\Run\\\\Everon)");
-            success = false;
-        }
-    }
+bool Settings::IsValidPeriod(DWORD value) const noexcept {
+    return value >= MIN_PERIOD_SEC && value <= MAX_PERIOD_SEC;
+}
 
-    const LONG closeRes = RegCloseKey(hKey);
-    Utils::CheckWinApiStatus(closeRes, L"RegCloseKey(HKCU\\\\Run)");
-    return success;
+bool Settings::IsValidVirtualKey(WORD vk) const noexcept {
+    return vk == 0 || vk == VK_F15 || vk == VK_F16 || vk == VK_F17;
 }
 
 } // namespace Everon
@@ -1,9 +1,11 @@
 #pragma once
 
-#include <windows.h>
+#include "Platform.h"
 #include <string>
 
-#include "HotkeyManager.h"
+#include "BatteryPolicy.h"
+#include "DisplayPolicy.h"
+#include "HotkeyConfig.h"
 #include "TimerMode.h"
 
 namespace Everon {
@@ -17,6 +19,12 @@ public:
     static constexpr DWORD MIN_PERIOD_SEC = 1;
     static constexpr DWORD MAX_PERIOD_SEC = 86400; // 24 hours
     static constexpr DWORD DEFAULT_PERIOD_SEC = 59;
+    static constexpr DWORD MIN_ACTIVITY_SUSTAIN_SEC = 5;
+    static constexpr DWORD MAX_ACTIVITY_SUSTAIN_SEC = 3600;
+    static constexpr DWORD DEFAULT_ACTIVITY_SUSTAIN_SEC = 60;
+    static constexpr DWORD MIN_FOLDER_QUIET_SEC = 5;
+    static constexpr DWORD MAX_FOLDER_QUIET_SEC = 3600;
+    static constexpr DWORD DEFAULT_FOLDER_QUIET_SEC = 60;
 
     Settings();
 
@@ -26,10 +34,25 @@ public:
     bool GetKeepDisplayOn() const noexcept { return m_keepDisplayOn; }
     bool GetShowToggleNotifications() const noexcept { return m_showToggleNotifications; }
     bool GetAutoStart() const noexcept { return m_autoStart; }
+    bool GetEfficiencyMode() const noexcept { return m_efficiencyMode; }
+    DWORD GetWakeupBudgetPerHour() const noexcept { return m_wakeupBudgetPerHour; }
+    DWORD GetKeypressJitterSec() const noexcept { return m_keypressJitterSec; }
+    DWORD GetIdleThresholdSec() const noexcept { return m_idleThresholdSec; }
+    bool GetAdaptivePeriod() const noexcept { return m_adaptivePeriod; }
+    bool GetKeepAwakeWhenLocked() const noexcept { return m_keepAwakeWhenLocked; }
+    const std::wstring& GetWatchProcesses() const noexcept { return m_watchProcesses; }
+    DWORD GetCpuActivityPercent() const noexcept { return m_cpuActivityPercent; }
+    DWORD GetDiskActivityKBps() const noexcept { return m_diskActivityKBps; }
+    DWORD GetNetworkActivityKBps() const noexcept { return m_networkActivityKBps; }
+    DWORD GetActivitySustainSec() const noexcept { return m_activitySustainSec; }
+    const std::wstring& GetWatchFolders() const noexcept { return m_watchFolders; }
+    DWORD GetFolderQuietSec() const noexcept { return m_folderQuietSec; }
     bool IsEnabled() const noexcept { return m_enabled; }
     Language GetLanguage() const noexcept;
     HotkeyConfig GetHotkeyConfig() const noexcept;
     TimerConfig GetTimerConfig() const noexcept;
+    DisplayPolicy GetDisplayPolicy() const noexcept { return m_displayPolicy; }
+    BatteryPolicy GetBatteryPolicy() const noexcept { return m_batteryPolicy; }
 
     // Setters
     void SetPeriodSec(DWORD value) noexcept;
@@ -37,14 +60,31 @@ public:
     void SetKeepDisplayOn(bool value) noexcept;
     void SetShowToggleNotifications(bool value) noexcept;
     void SetAutoStart(bool value) noexcept { m_autoStart = value; }
+    void SetEfficiencyMode(bool value) noexcept;
+    void SetWakeupBudgetPerHour(DWORD value) noexcept;  // 0 = unlimited
+    void SetKeypressJitterSec(DWORD value) noexcept;    // 0 = off; capped at half the period
+    void SetIdleThresholdSec(DWORD value) noexcept;     // 0 = automatic (about one period); at most the period
+    void SetAdaptivePeriod(bool value) noexcept;        // period from the OS idle timeout
+    void SetKeepAwakeWhenLocked(bool value) noexcept;   // false: release while locked/disconnected
+    void SetWatchProcesses(const std::wstring& value);  // "robocopy;ffmpeg": awake while one runs
+    void SetCpuActivityPercent(DWORD value) noexcept;   // 0 = off; awake while CPU load stays above
+    void SetDiskActivityKBps(DWORD value) noexcept;     // 0 = off; awake while disk I/O stays above
+    void SetNetworkActivityKBps(DWORD value) noexcept;  // 0 = off; awake while throughput stays above
+    void SetActivitySustainSec(DWORD value) noexcept;   // how long a level must hold to switch
+    void SetWatchFolders(const std::wstring& value);    // "D:\Downloads;...": awake while files land
+    void SetFolderQuietSec(DWORD value) noexcept;       // no writes this long: the transfer is over
     void SetEnabled(bool value) noexcept;
     void SetLanguage(Language value) noexcept;
     void SetHotkeyConfig(const HotkeyConfig& value) noexcept;
     void SetTimerConfig(const TimerConfig& value) noexcept;
+    void SetDisplayPolicy(const DisplayPolicy& value) noexcept;  // out-of-range fields are cleared
+    void SetBatteryPolicy(const BatteryPolicy& value) noexcept;  // out-of-range fields are cleared
 
-    // Registry operations
+#ifdef _WIN32
+    // Registry operations (SettingsRegistry.cpp)
     bool LoadFromRegistry();
     bool SaveToRegistry();
+#endif
     bool IsDirty() const noexcept { return m_dirty; }
     void SetDirty(bool value) noexcept { m_dirty = value; }
 
@@ -52,9 +92,11 @@ public:
     bool IsValidPeriod(DWORD value) const noexcept;
     bool IsValidVirtualKey(WORD vk) const noexcept;
 
+#ifdef _WIN32
     // Auto-start registry management
     static bool IsAutoStartEnabled();
     static bool SetAutoStartEnabled(bool enable);
+#endif
 
 private:
     DWORD m_periodSec = DEFAULT_PERIOD_SEC;
@@ -62,14 +104,31 @@ private:
     bool m_keepDisplayOn = false;
     bool m_showToggleNotifications = false;
     bool m_autoStart = false;
+    bool m_efficiencyMode = false;
+    DWORD m_wakeupBudgetPerHour = 0;
+    DWORD m_keypressJitterSec = 0;
+    DWORD m_idleThresholdSec = 0;
+    bool m_adaptivePeriod = false;
+    bool m_keepAwakeWhenLocked = true;
+    std::wstring m_watchProcesses;
+    DWORD m_cpuActivityPercent = 0;
+    DWORD m_diskActivityKBps = 0;
+    DWORD m_networkActivityKBps = 0;
+    DWORD m_activitySustainSec = DEFAULT_ACTIVITY_SUSTAIN_SEC;
+    std::wstring m_watchFolders;
+    DWORD m_folderQuietSec = DEFAULT_FOLDER_QUIET_SEC;
     bool m_enabled = true;
     HotkeyConfig m_hotkeyConfig = {};
     TimerConfig m_timerConfig = {};
+    DisplayPolicy m_displayPolicy = {};
+    BatteryPolicy m_batteryPolicy = {};
     bool m_dirty = true;
 
+#ifdef _WIN32
     static constexpr const wchar_t* REG_KEY_PATH = L"Software\\Everon";
     static constexpr const wchar_t* RUN_KEY_PATH = L"Software\\Microsoft\\Windows\\CurrentVersion\\Run";
     static constexpr const wchar_t* APP_NAME = L"Everon";
+#endif
 };
 
 } // namespace Everon
@@ -838,6 +838,7 @@ bool SettingsDialog::OnOkClicked(HWND dialog) {
     if (timerChanged || timer.mode == TimerMode::Indefinite) {
         timer.startTime = {};
         timer.endTimeUtc = 0;
+        timer.endTimeMonotonic = 0;
     }
 
 
@@ -0,0 +1,452 @@
+#include "Settings.h"
+#include "Localization.h"
+#include "HotkeyConfig.h"
+#include "TimerMode.h"
+#include "Utils.h"
+#include <strsafe.h>
+
+// Win32 registry persistence for Settings. The settings model itself lives in Settings.cpp.
+
+namespace Everon {
+
+bool Settings::LoadFromRegistry() {
+    HKEY hKey = nullptr;
+    const LONG openRes = RegOpenKeyExW(HKEY_CURRENT_USER, REG_KEY_PATH, 0, KEY_READ, &hKey);
+    if (openRes != ERROR_SUCCESS) {
+        if (openRes != ERROR_FILE_NOT_FOUND) {
+            Utils::CheckWinApiStatus(openRes, L"RegOpenKeyExW(HKCU\\\\Software\\\\Everon)");
+        }
+        // First run (or settings cleared). Keep defaults but ensure language/autostart are initialized.
+        SetLanguage(Localization::DetectSystemLanguage());
+        m_autoStart = IsAutoStartEnabled();
+        m_dirty = false;
+        return true;
+    }
+
+    auto ReadDword = [hKey](const wchar_t* name, DWORD& outValue) -> bool {
+        DWORD type = 0;
+        DWORD size = sizeof(DWORD);
+        DWORD value = 0;
+        const LONG res = RegQueryValueExW(hKey, name, nullptr, &type,
+                                          reinterpret_cast<LPBYTE>(&value), &size);
+        if (res == ERROR_SUCCESS && type == REG_DWORD) {
+            outValue = value;
+            return true;
+        }
+        if (res != ERROR_SUCCESS && res != ERROR_FILE_NOT_FOUND) {
+            Utils::CheckWinApiStatus(res, L"RegQueryValueExW(REG_DWORD)");
+        }
+        return false;
+    };
+
+    auto ReadQword = [hKey](const wchar_t* name, ULONGLONG& outValue) -> bool {
+        DWORD type = 0;
+        DWORD size = sizeof(ULONGLONG);
+        ULONGLONG value = 0;
+        const LONG res = RegQueryValueExW(hKey, name, nullptr, &type,
+                                          reinterpret_cast<LPBYTE>(&value), &size);
+        if (res == ERROR_SUCCESS && type == REG_QWORD) {
+            outValue = value;
+            return true;
+        }
+        if (res != ERROR_SUCCESS && res != ERROR_FILE_NOT_FOUND) {
+            Utils::CheckWinApiStatus(res, L"RegQueryValueExW(REG_QWORD)");
+        }
+        return false;
+    };
+
+    auto ReadString = [hKey](const wchar_t* name, wchar_t* buffer, DWORD bufferSize) -> bool {
+        DWORD type = 0;
+        DWORD size = bufferSize;
+        const LONG res = RegQueryValueExW(hKey, name, nullptr, &type,
+                                          reinterpret_cast<LPBYTE>(buffer), &size);
+        if (res == ERROR_SUCCESS && (type == REG_SZ || type == REG_EXPAND_SZ)) {
+            return true;
+        }
+        if (res != ERROR_SUCCESS && res != ERROR_FILE_NOT_FOUND) {
+            Utils::CheckWinApiStatus(res, L"RegQueryValueExW(REG_SZ)");
+        }
+        return false;
+    };
+
+    // Lists of any length: sized by a first query, read again if the value grew since.
+    auto ReadStringValue = [hKey](const wchar_t* name, std::wstring& outValue) -> bool {
+        DWORD type = 0;
+        DWORD size = 0;
+        LONG res = RegQueryValueExW(hKey, name, nullptr, &type, nullptr, &size);
+        std::wstring value;
+        while (res == ERROR_SUCCESS && (type == REG_SZ || type == REG_EXPAND_SZ)) {
+            // One more character: a stored value need not be null-terminated.
+            value.assign(size / sizeof(wchar_t) + 1, L'\0');
+            size = static_cast<DWORD>(value.size() * sizeof(wchar_t));
+            res = RegQueryValueExW(hKey, name, nullptr, &type, reinterpret_cast<LPBYTE>(&value[0]), &size);
+            if (res == ERROR_SUCCESS) {
+                value.resize(wcsnlen(value.c_str(), value.size()));
+                outValue = std::move(value);
+                return true;
+            }
+            if (res == ERROR_MORE_DATA) {
+                res = ERROR_SUCCESS;
+            }
+        }
+        if (res != ERROR_SUCCESS && res != ERROR_FILE_NOT_FOUND) {
+            Utils::CheckWinApiStatus(res, L"RegQueryValueExW(REG_SZ)");
+        }
+        return false;
+    };
+
+    DWORD tempDword = 0;
+    if (ReadDword(L"PeriodSec", tempDword)) {
+        SetPeriodSec(tempDword);
+    }
+    if (ReadDword(L"VkKey", tempDword)) {
+        SetVirtualKey(static_cast<WORD>(tempDword));
+    }
+    if (ReadDword(L"KeepDisplayOn", tempDword)) {
+        m_keepDisplayOn = (tempDword != 0);
+    }
+    if (ReadDword(L"ShowToggleNotifications", tempDword)) {
+        m_showToggleNotifications = (tempDword != 0);
+    }
+    if (ReadDword(L"Enabled", tempDword)) {
+        m_enabled = (tempDword != 0);
+    }
+    if (ReadDword(L"EfficiencyMode", tempDword)) {
+        m_efficiencyMode = (tempDword != 0);
+    }
+    if (ReadDword(L"WakeupBudgetPerHour", tempDword)) {
+        m_wakeupBudgetPerHour = tempDword;
+    }
+    if (ReadDword(L"KeypressJitterSec", tempDword)) {
+        m_keypressJitterSec = tempDword;
+    }
+    if (ReadDword(L"IdleThresholdSec", tempDword)) {
+        SetIdleThresholdSec(tempDword);
+    }
+    if (ReadDword(L"AdaptivePeriod", tempDword)) {
+        m_adaptivePeriod = (tempDword != 0);
+    }
+    if (ReadDword(L"KeepAwakeWhenLocked", tempDword)) {
+        m_keepAwakeWhenLocked = (tempDword != 0);
+    }
+    if (ReadDword(L"CpuActivityPercent", tempDword)) {
+        SetCpuActivityPercent(tempDword);
+    }
+    if (ReadDword(L"DiskActivityKBps", tempDword)) {
+        m_diskActivityKBps = tempDword;
+    }
+    if (ReadDword(L"NetworkActivityKBps", tempDword)) {
+        m_networkActivityKBps = tempDword;
+    }
+    if (ReadDword(L"ActivitySustainSec", tempDword)) {
+        SetActivitySustainSec(tempDword);
+    }
+    if (ReadDword(L"FolderQuietSec", tempDword)) {
+        SetFolderQuietSec(tempDword);
+    }
+    {
+        DisplayPolicy policy;
+        ReadDword(L"DisplayOnMinutes", policy.onMinutes);
+        ReadDword(L"DisplayWindowStart", policy.windowStartMinute);
+        ReadDword(L"DisplayWindowEnd", policy.windowEndMinute);
+        SetDisplayPolicy(policy);
+    }
+    {
+        BatteryPolicy policy;
+        if (ReadDword(L"BatteryAction", tempDword)) {
+            policy.onBattery = static_cast<BatteryAction>(tempDword);
+        }
+        ReadDword(L"BatteryLowPercent", policy.lowPercent);
+        if (ReadDword(L"BatteryLowAction", tempDword)) {
+            policy.whenLow = static_cast<BatteryAction>(tempDword);
+        }
+        SetBatteryPolicy(policy);
+    }
+
+    wchar_t langBuffer[16] = {};
+    if (ReadString(L"Language", langBuffer, sizeof(langBuffer))) {
+        SetLanguage(Localization::StringToLanguage(langBuffer));
+    } else {
+        SetLanguage(Localization::DetectSystemLanguage());
+    }
+
+
+    // Hotkey
+    wchar_t hotkeyBuffer[128] = {};
+    if (ReadString(L"Hotkey", hotkeyBuffer, sizeof(hotkeyBuffer))) {
+        m_hotkeyConfig = HotkeyConfig::FromRegistryString(hotkeyBuffer);
+    }
+
+    ReadStringValue(L"WatchProcesses", m_watchProcesses);
+    ReadStringValue(L"WatchFolders", m_watchFolders);
+
+    // Timer
+    TimerConfig timer = m_timerConfig;
+
+    DWORD tempMode = 0;
+    if (ReadDword(L"TimerMode", tempMode)) {
+        timer.mode = static_cast<TimerMode>(tempMode);
+    }
+    DWORD tempDuration = timer.durationMinutes;
+    if (ReadDword(L"TimerDuration", tempDuration)) {
+        timer.durationMinutes = tempDuration;
+    }
+
+    DWORD type = 0;
+    DWORD size = sizeof(SYSTEMTIME);
+    SYSTEMTIME st = {};
+
+    LONG qRes = RegQueryValueExW(hKey, L"TimerUntilTime", nullptr, &type,
+                                 reinterpret_cast<LPBYTE>(&st), &size);
+    if (qRes == ERROR_SUCCESS && type == REG_BINARY && size == sizeof(SYSTEMTIME)) {
+        timer.untilTime = st;
+    } else if (qRes != ERROR_SUCCESS && qRes != ERROR_FILE_NOT_FOUND) {
+        Utils::CheckWinApiStatus(qRes, L"RegQueryValueExW(TimerUntilTime)");
+    }
+
+    size = sizeof(SYSTEMTIME);
+    st = {};
+    qRes = RegQueryValueExW(hKey, L"TimerStartTime", nullptr, &type,
+                            reinterpret_cast<LPBYTE>(&st), &size);
+    if (qRes == ERROR_SUCCESS && type == REG_BINARY && size == sizeof(SYSTEMTIME)) {
+        timer.startTime = st;
+    } else if (qRes != ERROR_SUCCESS && qRes != ERROR_FILE_NOT_FOUND) {
+        Utils::CheckWinApiStatus(qRes, L"RegQueryValueExW(TimerStartTime)");
+    }
+
+    // Timer runtime end moment (UTC) - preferred over legacy startTime for DST robustness
+    ULONGLONG tempQword = 0;
+    if (ReadQword(L"TimerEndUtc", tempQword)) {
+        timer.endTimeUtc = tempQword;
+    } else if (timer.mode == TimerMode::Duration && timer.startTime.wYear != 0) {
+        // Backward compatibility: compute endTimeUtc from legacy startTime
+        SYSTEMTIME startUtc = {};
+        if (!TzSpecificLocalTimeToSystemTime(nullptr, &timer.startTime, &startUtc)) {
+            startUtc = timer.startTime;
+        }
+        FILETIME startFt = {};
+        if (SystemTimeToFileTime(&startUtc, &startFt)) {
+            ULARGE_INTEGER u;
+            u.LowPart = startFt.dwLowDateTime;
+            u.HighPart = startFt.dwHighDateTime;
+            timer.endTimeUtc = u.QuadPart + (static_cast<ULONGLONG>(timer.durationMinutes) * 60ULL * 10000000ULL);
+        }
+    }
+
+    // Sanity check
+    if (!timer.IsValid()) {
+        timer = TimerConfig{};
+        GetLocalTime(&timer.untilTime);
+    }
+    m_timerConfig = timer;
+
+    const LONG closeRes = RegCloseKey(hKey);
+    Utils::CheckWinApiStatus(closeRes, L"RegCloseKey(HKCU\\\\Software\\\\Everon)");
+    m_autoStart = IsAutoStartEnabled();
+    m_dirty = false;
+    return true;
+}
+
+bool Settings::SaveToRegistry() {
+    if (!m_dirty) {
+        return true;
+    }
+
+    HKEY hKey = nullptr;
+    const LONG createRes = RegCreateKeyExW(HKEY_CURRENT_USER, REG_KEY_PATH, 0, nullptr, 0,
+                                           KEY_WRITE, nullptr, &hKey, nullptr);
+    if (!Utils::CheckWinApiStatus(createRes, L"RegCreateKeyExW(HKCU\\\\Software\\\\Everon)")) {
+        return false;
+    }
+
+    auto WriteDword = [hKey](const wchar_t* name, DWORD value) -> bool {
+        const LONG res = RegSetValueExW(hKey, name, 0, REG_DWORD,
+                                        reinterpret_cast<const BYTE*>(&value),
+                                        sizeof(value));
+        if (!Utils::CheckWinApiStatus(res, L"RegSetValueExW(REG_DWORD)")) {
+            Utils::DebugLog(L"[Everon][Reg] Failed to write DWORD value '%s'\n", name);
+            return false;
+        }
+        return true;
+    };
+
+    auto WriteString = [hKey](const wchar_t* name, const wchar_t* value) -> bool {
+        DWORD size = static_cast<DWORD>((wcslen(value) + 1) * sizeof(wchar_t));
+        const LONG res = RegSetValueExW(hKey, name, 0, REG_SZ,
+                                        reinterpret_cast<const BYTE*>(value),
+                                        size);
+        if (!Utils::CheckWinApiStatus(res, L"RegSetValueExW(REG_SZ)")) {
+            Utils::DebugLog(L"[Everon][Reg] Failed to write string value '%s'\n", name);
+            return false;
+        }
+        return true;
+    };
+
+    auto WriteQword = [hKey](const wchar_t* name, ULONGLONG value) -> bool {
+        const LONG res = RegSetValueExW(hKey, name, 0, REG_QWORD,
+                                        reinterpret_cast<const BYTE*>(&value),
+                                        sizeof(value));
+        if (!Utils::CheckWinApiStatus(res, L"RegSetValueExW(REG_QWORD)")) {
+            Utils::DebugLog(L"[Everon][Reg] Failed to write QWORD value '%s'\n", name);
+            return false;
+        }
+        return true;
+    };
+
+    bool success = true;
+    success &= WriteDword(L"PeriodSec", m_periodSec);
+    success &= WriteDword(L"VkKey", static_cast<DWORD>(m_vkKey));
+    success &= WriteDword(L"KeepDisplayOn", m_keepDisplayOn ? 1 : 0);
+    success &= WriteDword(L"ShowToggleNotifications", m_showToggleNotifications ? 1 : 0);
+    success &= WriteDword(L"Enabled", m_enabled ? 1 : 0);
+    success &= WriteDword(L"EfficiencyMode", m_efficiencyMode ? 1 : 0);
+    success &= WriteDword(L"WakeupBudgetPerHour", m_wakeupBudgetPerHour);
+    success &= WriteDword(L"KeypressJitterSec", m_keypressJitterSec);
+    success &= WriteDword(L"IdleThresholdSec", m_idleThresholdSec);
+    success &= WriteDword(L"AdaptivePeriod", m_adaptivePeriod ? 1 : 0);
+    success &= WriteDword(L"KeepAwakeWhenLocked", m_keepAwakeWhenLocked ? 1 : 0);
+    success &= WriteDword(L"CpuActivityPercent", m_cpuActivityPercent);
+    success &= WriteDword(L"DiskActivityKBps", m_diskActivityKBps);
+    success &= WriteDword(L"NetworkActivityKBps", m_networkActivityKBps);
+    success &= WriteDword(L"ActivitySustainSec", m_activitySustainSec);
+    success &= WriteDword(L"FolderQuietSec", m_folderQuietSec);
+    success &= WriteDword(L"DisplayOnMinutes", m_displayPolicy.onMinutes);
+    success &= WriteDword(L"DisplayWindowStart", m_displayPolicy.windowStartMinute);
+    success &= WriteDword(L"DisplayWindowEnd", m_displayPolicy.windowEndMinute);
+    success &= WriteDword(L"BatteryAction", static_cast<DWORD>(m_batteryPolicy.onBattery));
+    success &= WriteDword(L"BatteryLowPercent", m_batteryPolicy.lowPercent);
+    success &= WriteDword(L"BatteryLowAction", static_cast<DWORD>(m_batteryPolicy.whenLow));
+    success &= WriteString(L"Language", Localization::LanguageToString(GetLanguage()));
+
+    success &= WriteString(L"Hotkey", m_hotkeyConfig.ToRegistryString().c_str());
+    success &= WriteString(L"WatchProcesses", m_watchProcesses.c_str());
+    success &= WriteString(L"WatchFolders", m_watchFolders.c_str());
+
+    const TimerConfig& timer = m_timerConfig;
+    success &= WriteDword(L"TimerMode", static_cast<DWORD>(timer.mode));
+    success &= WriteDword(L"TimerDuration", timer.durationMinutes);
+    LONG res = RegSetValueExW(hKey, L"TimerUntilTime", 0, REG_BINARY,
+                              reinterpret_cast<const BYTE*>(&timer.untilTime),
+                              sizeof(SYSTEMTIME));
+    if (!Utils::CheckWinApiStatus(res, L"RegSetValueExW(TimerUntilTime)")) {
+        success = false;
+    }
+
+    res = RegSetValueExW(hKey, L"TimerStartTime", 0, REG_BINARY,
+                         reinterpret_cast<const BYTE*>(&timer.startTime),
+                         sizeof(SYSTEMTIME));
+    if (!Utils::CheckWinApiStatus(res, L"RegSetValueExW(TimerStartTime)")) {
+        success = false;
+    }
+
+    // Store end moment only for the currently enabled run; avoid stale values when disabled.
+    ULONGLONG endUtcToSave = 0;
+    if (m_enabled && timer.mode != TimerMode::Indefinite) {
+        endUtcToSave = timer.endTimeUtc;
+    }
+    success &= WriteQword(L"TimerEndUtc", endUtcToSave);
+
+    const LONG closeRes = RegCloseKey(hKey);
+    Utils::CheckWinApiStatus(closeRes, L"RegCloseKey(HKCU\\\\Software\\\\Everon)");
+
+    if (success) {
+        m_dirty = false;
+    }
+    return success;
+}
+
+bool Settings::IsAutoStartEnabled() {
+    HKEY hKey = nullptr;
+    const LONG openRes = RegOpenKeyExW(HKEY_CURRENT_USER, RUN_KEY_PATH, 0, KEY_READ, &hKey);
+    if (openRes != ERROR_SUCCESS) {
+        if (openRes != ERROR_FILE_NOT_FOUND) {
+            Utils::CheckWinApiStatus(openRes, L"RegOpenKeyExW(HKCU\\\\Run)");
+        }
+        return false;
+    }
+
+    wchar_t value[2048] = {};
+    DWORD type = 0;
+    DWORD size = sizeof(value);
+    LONG result = RegQueryValueExW(hKey, APP_NAME, nullptr, &type,
+                                   reinterpret_cast<LPBYTE>(value), &size);
+    const LONG closeRes = RegCloseKey(hKey);
+    Utils::CheckWinApiStatus(closeRes, L"RegCloseKey(HKCU\\\\Run)");
+
+    if (result != ERROR_SUCCESS || (type != REG_SZ && type != REG_EXPAND_SZ)) {
+        if (result != ERROR_FILE_NOT_FOUND) {
+            Utils::CheckWinApiStatus(result, L"RegQueryValueExW(HKCU\\\\Run\\\\Everon)");
+        }
+        return false;
+    }
+
+    wchar_t exePath[MAX_PATH] = {};
+    GetModuleFileNameW(nullptr, exePath, MAX_PATH);
+
+    // Expand environment variables if needed, then parse the first token.
+    std::wstring stored;
+    if (type == REG_EXPAND_SZ) {
+        wchar_t expanded[4096] = {};
+        DWORD expandedLen = ExpandEnvironmentStringsW(value, expanded, _countof(expanded));
+        if (expandedLen != 0 && expandedLen <= _countof(expanded)) {
+            stored = expanded;
+        } else {
+            stored = value;
+        }
+    } else {
+        stored = value;
+    }
+
+    std::wstring first;
+    if (!stored.empty() && stored[0] == L'"') {
+        size_t end = stored.find(L'"', 1);
+        if (end != std::wstring::npos) {
+            first = stored.substr(1, end - 1);
+        }
+    } else {
+        size_t end = stored.find_first_of(L" \t");
+        first = stored.substr(0, end);
+    }
+
+    if (first.empty()) {
+        return false;
+    }
+
+    return _wcsicmp(first.c_str(), exePath) == 0;
+}
+
+bool Settings::SetAutoStartEnabled(bool enable) {
+    HKEY hKey = nullptr;
+    const LONG createRes = RegCreateKeyExW(HKEY_CURRENT_USER, RUN_KEY_PATH, 0, nullptr, 0,
+                                           KEY_WRITE, nullptr, &hKey, nullptr);
+    if (!Utils::CheckWinApiStatus(createRes, L"RegCreateKeyExW(HKCU\\\\Run)")) {
+        return false;
+    }
+
+    bool success = false;
+    if (enable) {
+        wchar_t exePath[MAX_PATH] = {};
+        GetModuleFileNameW(nullptr, exePath, MAX_PATH);
+        wchar_t quotedPath[2048] = {};
+        StringCchPrintfW(quotedPath, _countof(quotedPath), L"\"%s\"", exePath);
+        DWORD size = static_cast<DWORD>((wcslen(quotedPath) + 1) * sizeof(wchar_t));
+        LONG setRes = RegSetValueExW(hKey, APP_NAME, 0, REG_SZ,
+                                     reinterpret_cast<const BYTE*>(quotedPath),
+                                     size);
+        success = Utils::CheckWinApiStatus(setRes, L"RegSetValueExW(HKCU\\\\Run\\\\Everon)");
+    } else {
+        LONG delRes = RegDeleteValueW(hKey, APP_NAME);
+        if (delRes == ERROR_SUCCESS || delRes == ERROR_FILE_NOT_FOUND) {
+            success = true;
+        } else {
+            Utils::CheckWinApiStatus(delRes, L"RegDeleteValueW(HKCU\\\\Run\\\\Everon)");
+            success = false;
+        }
+    }
+
+    const LONG closeRes = RegCloseKey(hKey);
+    Utils::CheckWinApiStatus(closeRes, L"RegCloseKey(HKCU\\\\Run)");
+    return success;
+}
+
+} // namespace Everon
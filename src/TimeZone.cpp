@@ -0,0 +1,546 @@
+#include "TimeZone.h"
+#include "CivilTime.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+
+namespace Everon {
+
+namespace {
+
+using Civil::DaysFromCivil;
+using Civil::TicksToUnixSeconds;
+using Civil::UnixSecondsToTicks;
+
+constexpr LONGLONG kTicksPerSec = static_cast<LONGLONG>(Civil::TICKS_PER_SEC);
+constexpr LONGLONG kSecPerDay = Civil::SECONDS_PER_DAY;
+
+// POSIX footer rules are expanded into explicit transitions up to this year.
+// Later instants keep the last offset in the table.
+constexpr int kLastExpandedYear = 2100;
+
+inline int YearOfUnixSeconds(LONGLONG seconds) noexcept {
+    return Civil::CivilFromDays(Civil::FloorDiv(seconds, kSecPerDay)).year;
+}
+
+// ---------------------------------------------------------------------------
+// POSIX TZ rule strings (TZ environment variable, TZif v2+ footer)
+// ---------------------------------------------------------------------------
+
+struct PosixDate {
+    enum class Kind { Julian1, Julian0, MonthWeekDay } kind = Kind::MonthWeekDay;
+    int day = 0;      // Julian1: 1..365, Julian0: 0..365
+    int month = 0;    // MonthWeekDay
+    int week = 0;
+    int weekday = 0;
+    LONG time = 7200; // seconds after local midnight (default 02:00:00)
+};
+
+struct PosixRule {
+    LONG stdOffset = 0;   // seconds east of UTC
+    LONG dstOffset = 0;
+    bool hasDst = false;
+    PosixDate start;
+    PosixDate end;
+};
+
+class PosixRuleParser {
+public:
+    explicit PosixRuleParser(const char* text) : m_p(text) {}
+
+    bool Parse(PosixRule& rule) {
+        if (!ParseName()) {
+            return false;
+        }
+        LONG stdWest = 0;
+        if (!ParseTime(stdWest)) {
+            return false;
+        }
+        rule.stdOffset = -stdWest;
+
+        if (*m_p == '\0') {
+            rule.hasDst = false;
+            return true;
+        }
+
+        if (!ParseName()) {
+            return false;
+        }
+        rule.hasDst = true;
+        rule.dstOffset = rule.stdOffset + 3600;
+        if (*m_p != ',' && *m_p != '\0') {
+            LONG dstWest = 0;
+            if (!ParseTime(dstWest)) {
+                return false;
+            }
+            rule.dstOffset = -dstWest;
+        }
+
+        if (*m_p == '\0') {
+            // No rule given: POSIX leaves it implementation-defined; use the US rule like glibc.
+            rule.start.month = 3; rule.start.week = 2; rule.start.weekday = 0;
+            rule.end.month = 11; rule.end.week = 1; rule.end.weekday = 0;
+            return true;
+        }
+
+        if (*m_p++ != ',' || !ParseDate(rule.start) || *m_p++ != ',' || !ParseDate(rule.end)) {
+            return false;
+        }
+        return *m_p == '\0';
+    }
+
+private:
+    bool ParseName() {
+        if (*m_p == '<') {
+            const char* close = std::strchr(m_p, '>');
+            if (!close) {
+                return false;
+            }
+            m_p = close + 1;
+            return true;
+        }
+        const char* start = m_p;
+        while ((*m_p >= 'A' && *m_p <= 'Z') || (*m_p >= 'a' && *m_p <= 'z')) {
+            ++m_p;
+        }
+        return (m_p - start) >= 3;
+    }
+
+    bool ParseNumber(int& out, int maxValue) {
+        if (*m_p < '0' || *m_p > '9') {
+            return false;
+        }
+        int value = 0;
+        while (*m_p >= '0' && *m_p <= '9') {
+            value = value * 10 + (*m_p++ - '0');
+            if (value > maxValue) {
+                return false;
+            }
+        }
+        out = value;
+        return true;
+    }
+
+    // [+-]hh[:mm[:ss]], hours up to 167 (RFC 8536 extension)
+    bool ParseTime(LONG& seconds) {
+        int sign = 1;
+        if (*m_p == '+' || *m_p == '-') {
+            sign = (*m_p++ == '-') ? -1 : 1;
+        }
+        int h = 0, mi = 0, s = 0;
+        if (!ParseNumber(h, 167)) {
+            return false;
+        }
+        if (*m_p == ':') {
+            ++m_p;
+            if (!ParseNumber(mi, 59)) {
+                return false;
+            }
+            if (*m_p == ':') {
+                ++m_p;
+                if (!ParseNumber(s, 59)) {
+                    return false;
+                }
+            }
+        }
+        seconds = sign * (h * 3600 + mi * 60 + s);
+        return true;
+    }
+
+    bool ParseDate(PosixDate& date) {
+        if (*m_p == 'J') {
+            ++m_p;
+            date.kind = PosixDate::Kind::Julian1;
+            if (!ParseNumber(date.day, 365) || date.day < 1) {
+                return false;
+            }
+        } else if (*m_p == 'M') {
+            ++m_p;
+            date.kind = PosixDate::Kind::MonthWeekDay;
+            if (!ParseNumber(date.month, 12) || date.month < 1 || *m_p++ != '.' ||
+                !ParseNumber(date.week, 5) || date.week < 1 || *m_p++ != '.' ||
+                !ParseNumber(date.weekday, 6)) {
+                return false;
+            }
+        } else {
+            date.kind = PosixDate::Kind::Julian0;
+            if (!ParseNumber(date.day, 365)) {
+                return false;
+            }
+        }
+
+        if (*m_p == '/') {
+            ++m_p;
+            return ParseTime(date.time);
+        }
+        return true;
+    }
+
+    const char* m_p;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Construction
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// Local wall time (Unix seconds as if local were UTC) at which a POSIX rule date fires.
+LONGLONG PosixDateToLocalSeconds(const PosixDate& date, int year) noexcept {
+    LONGLONG days = 0;
+    switch (date.kind) {
+        case PosixDate::Kind::Julian1:
+            // 1..365, February 29 is never counted
+            days = DaysFromCivil(year, 1, 1) + date.day - 1;
+            if (Civil::IsLeapYear(year) && date.day >= 60) {
+                ++days;
+            }
+            break;
+        case PosixDate::Kind::Julian0:
+            days = DaysFromCivil(year, 1, 1) + date.day;
+            break;
+        case PosixDate::Kind::MonthWeekDay:
+            days = Civil::NthWeekdayOfMonth(year, date.month, date.week, date.weekday);
+            break;
+    }
+    return days * kSecPerDay + date.time;
+}
+
+} // namespace
+
+std::shared_ptr<const TimeZone> TimeZone::FromTransitions(LONG initialOffset,
+                                                          std::vector<Transition> transitions) {
+    std::stable_sort(transitions.begin(), transitions.end(),
+                     [](const Transition& a, const Transition& b) { return a.utc < b.utc; });
+
+    // The same instant listed twice: the later entry wins.
+    auto last = std::unique(transitions.rbegin(), transitions.rend(),
+                            [](const Transition& a, const Transition& b) { return a.utc == b.utc; });
+    transitions.erase(transitions.begin(), last.base());
+
+    std::shared_ptr<TimeZone> zone(new TimeZone(initialOffset));
+    zone->m_utc.reserve(transitions.size());
+    zone->m_offsetAfter.reserve(transitions.size());
+    zone->m_localKey.reserve(transitions.size());
+
+    LONG previous = initialOffset;
+    for (const Transition& t : transitions) {
+        if (t.offset == previous) {
+            continue; // no-op (e.g. abbreviation-only change)
+        }
+        zone->m_utc.push_back(t.utc);
+        zone->m_offsetAfter.push_back(t.offset);
+        zone->m_localKey.push_back(t.utc + std::min(previous, t.offset));
+        previous = t.offset;
+    }
+    return zone;
+}
+
+std::shared_ptr<const TimeZone> TimeZone::Utc() {
+    static const std::shared_ptr<const TimeZone> utc(new TimeZone(0));
+    return utc;
+}
+
+std::shared_ptr<const TimeZone> TimeZone::Fixed(LONG offsetSeconds) {
+    if (offsetSeconds == 0) {
+        return Utc();
+    }
+    return std::shared_ptr<const TimeZone>(new TimeZone(offsetSeconds));
+}
+
+std::shared_ptr<const TimeZone> TimeZone::FromPosixRule(const char* text) {
+    if (!text) {
+        return nullptr;
+    }
+    PosixRule rule;
+    PosixRuleParser parser(text);
+    if (!parser.Parse(rule)) {
+        return nullptr;
+    }
+    if (!rule.hasDst) {
+        return Fixed(rule.stdOffset);
+    }
+
+    std::vector<Transition> transitions;
+    transitions.reserve(2 * (kLastExpandedYear - 1970 + 1));
+    for (int year = 1970; year <= kLastExpandedYear; ++year) {
+        const LONGLONG dstStart = PosixDateToLocalSeconds(rule.start, year) - rule.stdOffset;
+        const LONGLONG dstEnd = PosixDateToLocalSeconds(rule.end, year) - rule.dstOffset;
+        transitions.push_back({ dstStart, rule.dstOffset });
+        transitions.push_back({ dstEnd, rule.stdOffset });
+    }
+    return FromTransitions(rule.stdOffset, std::move(transitions));
+}
+
+namespace {
+
+class TzifReader {
+public:
+    TzifReader(const unsigned char* data, size_t size) : m_data(data), m_size(size) {}
+
+    bool Skip(size_t count) {
+        if (m_size - m_pos < count) {
+            return false;
+        }
+        m_pos += count;
+        return true;
+    }
+
+    bool ReadU8(unsigned char& out) {
+        if (m_pos >= m_size) {
+            return false;
+        }
+        out = m_data[m_pos++];
+        return true;
+    }
+
+    bool ReadBe32(LONGLONG& out) {
+        if (m_size - m_pos < 4) {
+            return false;
+        }
+        const unsigned char* p = m_data + m_pos;
+        const std::uint32_t v = (static_cast<std::uint32_t>(p[0]) << 24) | (static_cast<std::uint32_t>(p[1]) << 16) |
+                                (static_cast<std::uint32_t>(p[2]) << 8) | static_cast<std::uint32_t>(p[3]);
+        out = static_cast<std::int32_t>(v);
+        m_pos += 4;
+        return true;
+    }
+
+    bool ReadBe64(LONGLONG& out) {
+        LONGLONG hi = 0, lo = 0;
+        if (!ReadBe32(hi) || !ReadBe32(lo)) {
+            return false;
+        }
+        out = static_cast<LONGLONG>((static_cast<std::uint64_t>(hi) << 32) | (static_cast<std::uint64_t>(lo) & 0xFFFFFFFFULL));
+        return true;
+    }
+
+    const unsigned char* Current() const { return m_data + m_pos; }
+    size_t Remaining() const { return m_size - m_pos; }
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+};
+
+struct TzifHeader {
+    char version = 0;
+    LONGLONG isutcnt = 0, isstdcnt = 0, leapcnt = 0, timecnt = 0, typecnt = 0, charcnt = 0;
+};
+
+bool ReadTzifHeader(TzifReader& reader, TzifHeader& header) {
+    const unsigned char* magic = reader.Current();
+    if (reader.Remaining() < 44 || std::memcmp(magic, "TZif", 4) != 0) {
+        return false;
+    }
+    header.version = static_cast<char>(magic[4]);
+    reader.Skip(20);
+    return reader.ReadBe32(header.isutcnt) && reader.ReadBe32(header.isstdcnt) &&
+           reader.ReadBe32(header.leapcnt) && reader.ReadBe32(header.timecnt) &&
+           reader.ReadBe32(header.typecnt) && reader.ReadBe32(header.charcnt) &&
+           header.typecnt > 0 && header.timecnt >= 0 && header.leapcnt >= 0 &&
+           header.charcnt >= 0 && header.isutcnt >= 0 && header.isstdcnt >= 0;
+}
+
+size_t TzifBlockSize(const TzifHeader& h, size_t timeSize) {
+    return static_cast<size_t>(h.timecnt) * timeSize + static_cast<size_t>(h.timecnt) +
+           static_cast<size_t>(h.typecnt) * 6U + static_cast<size_t>(h.charcnt) +
+           static_cast<size_t>(h.leapcnt) * (timeSize + 4U) +
+           static_cast<size_t>(h.isstdcnt) + static_cast<size_t>(h.isutcnt);
+}
+
+} // namespace
+
+std::shared_ptr<const TimeZone> TimeZone::FromTzif(const unsigned char* data, size_t size) {
+    if (!data) {
+        return nullptr;
+    }
+
+    TzifReader reader(data, size);
+    TzifHeader header;
+    if (!ReadTzifHeader(reader, header)) {
+        return nullptr;
+    }
+
+    // Prefer the 64-bit block of v2+ files; it follows the v1 block.
+    size_t timeSize = 4;
+    if (header.version >= '2') {
+        if (!reader.Skip(TzifBlockSize(header, 4)) || !ReadTzifHeader(reader, header)) {
+            return nullptr;
+        }
+        timeSize = 8;
+    }
+    if (reader.Remaining() < TzifBlockSize(header, timeSize)) {
+        return nullptr;
+    }
+
+    std::vector<LONGLONG> times(static_cast<size_t>(header.timecnt));
+    for (LONGLONG& t : times) {
+        if (!(timeSize == 8 ? reader.ReadBe64(t) : reader.ReadBe32(t))) {
+            return nullptr;
+        }
+    }
+    std::vector<unsigned char> indices(static_cast<size_t>(header.timecnt));
+    for (unsigned char& index : indices) {
+        if (!reader.ReadU8(index) || index >= header.typecnt) {
+            return nullptr;
+        }
+    }
+    std::vector<LONG> typeOffsets(static_cast<size_t>(header.typecnt));
+    for (LONG& offset : typeOffsets) {
+        LONGLONG utoff = 0;
+        unsigned char isdst = 0, desigidx = 0;
+        if (!reader.ReadBe32(utoff) || !reader.ReadU8(isdst) || !reader.ReadU8(desigidx)) {
+            return nullptr;
+        }
+        offset = static_cast<LONG>(utoff);
+    }
+    reader.Skip(static_cast<size_t>(header.charcnt) + static_cast<size_t>(header.leapcnt) * (timeSize + 4U) +
+                static_cast<size_t>(header.isstdcnt) + static_cast<size_t>(header.isutcnt));
+
+    // RFC 8536: local time type 0 applies before the first transition.
+    std::vector<Transition> transitions;
+    transitions.reserve(times.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+        transitions.push_back({ times[i], typeOffsets[indices[i]] });
+    }
+    const LONG initialOffset = typeOffsets[0];
+
+    // v2+ footer: "\n<POSIX TZ>\n" describes everything after the last transition.
+    if (timeSize == 8 && reader.Remaining() >= 2 && *reader.Current() == '\n') {
+        const char* footer = reinterpret_cast<const char*>(reader.Current()) + 1;
+        const size_t maxLen = reader.Remaining() - 1;
+        const void* nl = std::memchr(footer, '\n', maxLen);
+        if (nl) {
+            const std::string rule(footer, static_cast<const char*>(nl));
+            PosixRule parsed;
+            PosixRuleParser parser(rule.c_str());
+            if (!rule.empty() && parser.Parse(parsed)) {
+                const LONGLONG last = transitions.empty() ? LLONG_MIN : transitions.back().utc;
+                if (!parsed.hasDst) {
+                    if (transitions.empty()) {
+                        return Fixed(parsed.stdOffset);
+                    }
+                } else {
+                    const int firstYear = transitions.empty() ? 1970 : YearOfUnixSeconds(last);
+                    for (int year = firstYear; year <= kLastExpandedYear; ++year) {
+                        const LONGLONG dstStart = PosixDateToLocalSeconds(parsed.start, year) - parsed.stdOffset;
+                        const LONGLONG dstEnd = PosixDateToLocalSeconds(parsed.end, year) - parsed.dstOffset;
+                        if (dstStart > last) {
+                            transitions.push_back({ dstStart, parsed.dstOffset });
+                        }
+                        if (dstEnd > last) {
+                            transitions.push_back({ dstEnd, parsed.stdOffset });
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return FromTransitions(initialOffset, std::move(transitions));
+}
+
+// ---------------------------------------------------------------------------
+// Current zone cache
+// ---------------------------------------------------------------------------
+
+namespace {
+
+std::mutex g_currentMutex;
+std::shared_ptr<const TimeZone> g_current;
+
+} // namespace
+
+std::shared_ptr<const TimeZone> TimeZone::Current() noexcept {
+    std::lock_guard<std::mutex> lock(g_currentMutex);
+    try {
+        if (!g_current || HasSystemZoneChanged()) {
+            std::shared_ptr<const TimeZone> loaded = LoadSystemZone();
+            g_current = loaded ? loaded : Utc();
+        }
+    } catch (const std::bad_alloc&) {
+        if (!g_current) {
+            g_current = Utc();
+        }
+    }
+    return g_current;
+}
+
+void TimeZone::InvalidateCurrent() noexcept {
+    std::lock_guard<std::mutex> lock(g_currentMutex);
+    g_current.reset();
+}
+
+// ---------------------------------------------------------------------------
+// Lookups
+// ---------------------------------------------------------------------------
+
+LONG TimeZone::GetOffsetSeconds(ULONGLONG utcTicks) const noexcept {
+    const LONGLONG utc = TicksToUnixSeconds(utcTicks);
+    const auto it = std::upper_bound(m_utc.begin(), m_utc.end(), utc);
+    if (it == m_utc.begin()) {
+        return m_initialOffset;
+    }
+    return m_offsetAfter[static_cast<size_t>(it - m_utc.begin()) - 1];
+}
+
+TimeZone::LocalResolution TimeZone::Resolve(ULONGLONG localTicks) const noexcept {
+    const LONGLONG local = TicksToUnixSeconds(localTicks);
+    const ULONGLONG subSecond = localTicks % static_cast<ULONGLONG>(kTicksPerSec);
+
+    LocalResolution result;
+    const auto it = std::upper_bound(m_localKey.begin(), m_localKey.end(), local);
+    if (it == m_localKey.begin()) {
+        result.utcTicks = UnixSecondsToTicks(local - m_initialOffset) + subSecond;
+        return result;
+    }
+
+    const size_t i = static_cast<size_t>(it - m_localKey.begin()) - 1;
+    const LONG before = (i == 0) ? m_initialOffset : m_offsetAfter[i - 1];
+    const LONG after = m_offsetAfter[i];
+
+    if (after > before && local < m_utc[i] + after) {
+        // Spring forward: [utc+before, utc+after) never appears on the wall clock.
+        // The first valid moment after the gap is the transition itself.
+        result.kind = LocalKind::Gap;
+        result.utcTicks = UnixSecondsToTicks(m_utc[i]);
+        return result;
+    }
+    if (after < before && local < m_utc[i] + before) {
+        // Fall back: [utc+after, utc+before) appears twice; pick the first occurrence.
+        result.kind = LocalKind::Overlap;
+        result.utcTicks = UnixSecondsToTicks(local - before) + subSecond;
+        return result;
+    }
+
+    result.utcTicks = UnixSecondsToTicks(local - after) + subSecond;
+    return result;
+}
+
+bool TimeZone::ToLocal(ULONGLONG utcTicks, SYSTEMTIME& local) const noexcept {
+    const LONGLONG offsetTicks = static_cast<LONGLONG>(GetOffsetSeconds(utcTicks)) * kTicksPerSec;
+    const LONGLONG localTicks = static_cast<LONGLONG>(utcTicks) + offsetTicks;
+    if (localTicks < 0) {
+        return false;
+    }
+    local = Civil::TicksToSystemTime(static_cast<ULONGLONG>(localTicks));
+    return true;
+}
+
+bool TimeZone::Resolve(const SYSTEMTIME& local, LocalResolution& out) const noexcept {
+    ULONGLONG localTicks = 0;
+    if (!Civil::SystemTimeToTicks(local, localTicks)) {
+        return false;
+    }
+    out = Resolve(localTicks);
+    return true;
+}
+
+} // namespace Everon
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Everon {
+
+// Compiled time-zone rules: a sorted table of UTC offset transitions with O(log n)
+// UTC->local and local->UTC lookups. Built from TZif data (Linux tzdata), POSIX TZ
+// rule strings or the Windows time-zone API, so "until time" resolution behaves the
+// same on every platform. All tick values are FILETIME ticks (100 ns since 1601-01-01).
+class TimeZone {
+public:
+    enum class LocalKind {
+        Unique,   // Local time maps to exactly one instant
+        Gap,      // Local time skipped (spring forward); resolved to the end of the gap
+        Overlap   // Local time occurs twice (fall back); resolved to the first occurrence
+    };
+
+    struct LocalResolution {
+        LocalKind kind = LocalKind::Unique;
+        ULONGLONG utcTicks = 0;
+    };
+
+    static std::shared_ptr<const TimeZone> Utc();
+    static std::shared_ptr<const TimeZone> Fixed(LONG offsetSeconds);
+
+    // Parses TZif v1/v2/v3 data (RFC 8536). Returns nullptr on malformed input.
+    static std::shared_ptr<const TimeZone> FromTzif(const unsigned char* data, size_t size);
+
+    // Parses a POSIX TZ rule such as "CET-1CEST,M3.5.0,M10.5.0/3". Returns nullptr on error.
+    static std::shared_ptr<const TimeZone> FromPosixRule(const char* rule);
+
+    // The system's current zone, loaded once and cached until InvalidateCurrent()
+    // (or, on Linux, until TZ or /etc/localtime changes). Never returns nullptr.
+    static std::shared_ptr<const TimeZone> Current() noexcept;
+    static void InvalidateCurrent() noexcept;
+
+    LONG GetOffsetSeconds(ULONGLONG utcTicks) const noexcept;
+    LocalResolution Resolve(ULONGLONG localTicks) const noexcept;
+
+    // SYSTEMTIME conveniences on top of GetOffsetSeconds()/Resolve().
+    bool ToLocal(ULONGLONG utcTicks, SYSTEMTIME& local) const noexcept;
+    bool Resolve(const SYSTEMTIME& local, LocalResolution& out) const noexcept;
+
+    size_t GetTransitionCount() const noexcept { return m_utc.size(); }
+
+private:
+    struct Transition {
+        LONGLONG utc;   // Unix seconds
+        LONG offset;    // UTC offset in effect from `utc` on, seconds east of UTC
+    };
+
+    explicit TimeZone(LONG initialOffset) noexcept : m_initialOffset(initialOffset) {}
+
+    // Sorts, de-duplicates and compiles raw transitions into lookup tables.
+    static std::shared_ptr<const TimeZone> FromTransitions(LONG initialOffset,
+                                                           std::vector<Transition> transitions);
+
+    // Platform loader for Current() (TimeZoneWin32.cpp / TimeZonePosix.cpp).
+    static std::shared_ptr<const TimeZone> LoadSystemZone();
+    static bool HasSystemZoneChanged();
+
+    // Parallel arrays sorted by m_utc (Unix seconds). m_localKey[i] is the earliest local
+    // wall time touched by transition i and is what local->UTC lookups search on.
+    std::vector<LONGLONG> m_utc;
+    std::vector<LONG> m_offsetAfter;
+    std::vector<LONGLONG> m_localKey;
+    LONG m_initialOffset = 0;
+};
+
+} // namespace Everon
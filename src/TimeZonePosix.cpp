@@ -0,0 +1,93 @@
+#include "TimeZone.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/stat.h>
+
+namespace Everon {
+
+namespace {
+
+constexpr const char* kLocaltimePath = "/etc/localtime";
+constexpr const char* kZoneinfoDir = "/usr/share/zoneinfo/";
+
+// Identity of the inputs the cached zone was built from.
+struct ZoneSource {
+    bool hasTz = false;
+    std::string tz;
+    dev_t dev = 0;
+    ino_t ino = 0;
+    time_t mtime = 0;
+};
+
+ZoneSource g_loadedFrom;
+
+ZoneSource ReadZoneSource() {
+    ZoneSource source;
+    const char* tz = std::getenv("TZ");
+    if (tz) {
+        source.hasTz = true;
+        source.tz = tz;
+    }
+    // stat() follows the /etc/localtime symlink, so both re-pointing the link
+    // (timedatectl set-timezone) and rewriting the file are detected.
+    struct stat st = {};
+    if (stat(kLocaltimePath, &st) == 0) {
+        source.dev = st.st_dev;
+        source.ino = st.st_ino;
+        source.mtime = st.st_mtime;
+    }
+    return source;
+}
+
+std::shared_ptr<const TimeZone> LoadTzifFile(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return nullptr;
+    }
+    std::string data;
+    char buffer[4096];
+    size_t read = 0;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, read);
+    }
+    std::fclose(file);
+    return TimeZone::FromTzif(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+}
+
+} // namespace
+
+std::shared_ptr<const TimeZone> TimeZone::LoadSystemZone() {
+    g_loadedFrom = ReadZoneSource();
+
+    if (!g_loadedFrom.hasTz) {
+        return LoadTzifFile(kLocaltimePath);
+    }
+
+    // TZ=":Area/City", "Area/City", "/path/to/tzif" or a POSIX rule like "CET-1CEST,M3.5.0,M10.5.0/3".
+    std::string tz = g_loadedFrom.tz;
+    if (!tz.empty() && tz[0] == ':') {
+        tz.erase(0, 1);
+    }
+    if (tz.empty()) {
+        return Utc();
+    }
+    if (tz[0] == '/') {
+        return LoadTzifFile(tz);
+    }
+    if (tz.find("..") == std::string::npos) {
+        if (auto zone = LoadTzifFile(kZoneinfoDir + tz)) {
+            return zone;
+        }
+    }
+    return FromPosixRule(tz.c_str());
+}
+
+bool TimeZone::HasSystemZoneChanged() {
+    const ZoneSource now = ReadZoneSource();
+    return now.hasTz != g_loadedFrom.hasTz || now.tz != g_loadedFrom.tz ||
+           now.dev != g_loadedFrom.dev || now.ino != g_loadedFrom.ino ||
+           now.mtime != g_loadedFrom.mtime;
+}
+
+} // namespace Everon
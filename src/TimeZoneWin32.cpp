@@ -0,0 +1,90 @@
+#include "TimeZone.h"
+#include "CivilTime.h"
+
+namespace Everon {
+
+namespace {
+
+// Rule tables are generated for this many years past the current one.
+constexpr int kYearsAhead = 30;
+
+// Seconds after local midnight of a Windows transition time. 23:59:59.999 is used by
+// some zones to mean "end of day", so round milliseconds up.
+LONG TimeOfDaySeconds(const SYSTEMTIME& st) noexcept {
+    return static_cast<LONG>(st.wHour) * 3600 + static_cast<LONG>(st.wMinute) * 60 +
+           static_cast<LONG>(st.wSecond) + (st.wMilliseconds != 0 ? 1 : 0);
+}
+
+// Windows Bias: UTC = local + bias (minutes). Returns seconds east of UTC.
+LONG BiasToOffset(LONG bias, LONG extraBias) noexcept {
+    return -(bias + extraBias) * 60;
+}
+
+} // namespace
+
+std::shared_ptr<const TimeZone> TimeZone::LoadSystemZone() {
+    DYNAMIC_TIME_ZONE_INFORMATION dtzi = {};
+    if (GetDynamicTimeZoneInformation(&dtzi) == TIME_ZONE_ID_INVALID) {
+        return nullptr;
+    }
+
+    SYSTEMTIME nowUtc = {};
+    GetSystemTime(&nowUtc);
+
+    // Local wall time (Unix seconds) of a transition described by a TIME_ZONE_INFORMATION date.
+    auto RuleLocalSeconds = [](const SYSTEMTIME& rule, int year) -> LONGLONG {
+        const LONGLONG days = (rule.wYear == 0)
+            // "Day-in-month" form: wDay = occurrence (1..4, 5 = last) of wDayOfWeek.
+            ? Civil::NthWeekdayOfMonth(year, rule.wMonth, rule.wDay, rule.wDayOfWeek)
+            : Civil::DaysFromCivil(year, rule.wMonth, rule.wDay);
+        return days * 86400LL + TimeOfDaySeconds(rule);
+    };
+
+    const int firstYear = static_cast<int>(nowUtc.wYear) - 1;
+    const int lastYear = static_cast<int>(nowUtc.wYear) + kYearsAhead;
+
+    LONG initialOffset = BiasToOffset(dtzi.Bias, dtzi.StandardBias);
+    std::vector<Transition> transitions;
+    transitions.reserve(static_cast<size_t>(2 * (lastYear - firstYear + 1)));
+
+    bool first = true;
+    LONG runningOffset = initialOffset;
+    for (int year = firstYear; year <= lastYear; ++year) {
+        TIME_ZONE_INFORMATION tzi = {};
+        if (!GetTimeZoneInformationForYear(static_cast<USHORT>(year), &dtzi, &tzi)) {
+            continue;
+        }
+
+        const LONG stdOffset = BiasToOffset(tzi.Bias, tzi.StandardBias);
+        const LONG dstOffset = BiasToOffset(tzi.Bias, tzi.DaylightBias);
+        if (first) {
+            initialOffset = stdOffset;
+            runningOffset = stdOffset;
+            first = false;
+        }
+
+        if (stdOffset != runningOffset) {
+            // The zone's standard offset changed between years (dynamic DST data).
+            const LONGLONG yearStartLocal = Civil::DaysFromCivil(year, 1, 1) * Civil::SECONDS_PER_DAY;
+            transitions.push_back({ yearStartLocal - runningOffset, stdOffset });
+            runningOffset = stdOffset;
+        }
+
+        if (tzi.StandardDate.wMonth == 0 || tzi.DaylightDate.wMonth == 0) {
+            continue; // no DST this year
+        }
+
+        // DaylightDate is expressed in standard local time, StandardDate in daylight local time.
+        transitions.push_back({ RuleLocalSeconds(tzi.DaylightDate, year) - stdOffset, dstOffset });
+        transitions.push_back({ RuleLocalSeconds(tzi.StandardDate, year) - dstOffset, stdOffset });
+    }
+
+    return FromTransitions(initialOffset, std::move(transitions));
+}
+
+bool TimeZone::HasSystemZoneChanged() {
+    // Windows broadcasts WM_TIMECHANGE on zone changes; App calls InvalidateCurrent().
+    return false;
+}
+
+} // namespace Everon
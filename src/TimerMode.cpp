@@ -1,91 +1,25 @@
 #include "TimerMode.h"
+#include "CivilTime.h"
+#include <algorithm>
 
 namespace Everon {
 
-static inline ULONGLONG FileTimeToUll(const FILETIME& ft) noexcept {
-    ULARGE_INTEGER u;
-    u.LowPart = ft.dwLowDateTime;
-    u.HighPart = ft.dwHighDateTime;
-    return u.QuadPart;
-}
-
-static inline ULONGLONG NowUtcFileTimeUll() noexcept {
-    FILETIME ft;
-    GetSystemTimeAsFileTime(&ft);
-    return FileTimeToUll(ft);
-}
-
-static inline bool LocalToUtcSystemTime(const SYSTEMTIME& local, SYSTEMTIME& utc) noexcept {
-    // nullptr => current time zone
-    return TzSpecificLocalTimeToSystemTime(nullptr, &local, &utc) != 0;
-}
-
 static inline ULONGLONG UtcSystemTimeToFileTimeUll(const SYSTEMTIME& utc) noexcept {
-    FILETIME ft;
-    if (!SystemTimeToFileTime(&utc, &ft)) {
+    ULONGLONG ticks = 0;
+    if (!Civil::SystemTimeToTicks(utc, ticks)) {
         return 0;
     }
-    return FileTimeToUll(ft);
-}
-
-static inline bool IsLeapYear(WORD year) noexcept {
-    // Gregorian leap year rules
-    if ((year % 400) == 0) return true;
-    if ((year % 100) == 0) return false;
-    return (year % 4) == 0;
-}
-
-static inline WORD DaysInMonth(WORD year, WORD month) noexcept {
-    switch (month) {
-        case 1:  return 31;
-        case 2:  return static_cast<WORD>(IsLeapYear(year) ? 29 : 28);
-        case 3:  return 31;
-        case 4:  return 30;
-        case 5:  return 31;
-        case 6:  return 30;
-        case 7:  return 31;
-        case 8:  return 31;
-        case 9:  return 30;
-        case 10: return 31;
-        case 11: return 30;
-        case 12: return 31;
-        default: return 31;
-    }
-}
-
-// Adds N days in local calendar time (N must be >= 0).
-static inline void AddDaysLocal(SYSTEMTIME& st, int days) noexcept {
-    while (days-- > 0) {
-        const WORD dim = DaysInMonth(st.wYear, st.wMonth);
-        if (st.wDay < dim) {
-            st.wDay = static_cast<WORD>(st.wDay + 1);
-        } else {
-            st.wDay = 1;
-            if (st.wMonth < 12) {
-                st.wMonth = static_cast<WORD>(st.wMonth + 1);
-            } else {
-                st.wMonth = 1;
-                st.wYear = static_cast<WORD>(st.wYear + 1);
-            }
-        }
-    }
-}
-
-// Adds minutes in local calendar time (minutes must be >= 0).
-static inline void AddMinutesLocal(SYSTEMTIME& st, int minutes) noexcept {
-    int total = static_cast<int>(st.wHour) * 60 + static_cast<int>(st.wMinute) + minutes;
-    while (total >= 24 * 60) {
-        total -= 24 * 60;
-        AddDaysLocal(st, 1);
-    }
-    st.wHour = static_cast<WORD>(total / 60);
-    st.wMinute = static_cast<WORD>(total % 60);
+    return ticks;
 }
 
 // Computes next occurrence of untilTime (time-of-day) relative to now, returns UTC FILETIME (QWORD).
-static ULONGLONG ComputeNextUntilUtc(const SYSTEMTIME& untilTime) noexcept {
+static ULONGLONG ComputeNextUntilUtc(const Clock& clock, const SYSTEMTIME& untilTime) noexcept {
+    const std::shared_ptr<const TimeZone> zone = clock.GetTimeZone();
+
     SYSTEMTIME nowLocal = {};
-    GetLocalTime(&nowLocal);
+    if (!zone->ToLocal(clock.NowUtc(), nowLocal)) {
+        return 0;
+    }
 
     SYSTEMTIME targetLocal = nowLocal;
     targetLocal.wHour = untilTime.wHour;
@@ -109,57 +43,50 @@ static ULONGLONG ComputeNextUntilUtc(const SYSTEMTIME& untilTime) noexcept {
     }
 
     if (nextDay) {
-        AddDaysLocal(targetLocal, 1);
+        Civil::AddDays(targetLocal, 1);
     }
 
-    // Convert local target to UTC. Around DST transitions some local times may be invalid
-    // (e.g., spring-forward gap). In that case, move forward to the next valid minute.
-    SYSTEMTIME targetUtc = {};
-    SYSTEMTIME probeLocal = targetLocal;
-
-    bool ok = LocalToUtcSystemTime(probeLocal, targetUtc);
-    if (!ok) {
-        for (int i = 0; i < 180 && !ok; ++i) { // up to 3 hours of probing (more than enough for DST gaps)
-            AddMinutesLocal(probeLocal, 1);
-            ok = LocalToUtcSystemTime(probeLocal, targetUtc);
-        }
+    // Convert local target to UTC. Around DST transitions some local times are invalid
+    // (spring-forward gap); the zone resolves those to the first valid instant after the gap,
+    // and ambiguous (fall-back) times to their first occurrence.
+    TimeZone::LocalResolution resolved;
+    if (zone->Resolve(targetLocal, resolved)) {
+        return resolved.utcTicks;
     }
 
-    if (!ok) {
-        // Last resort: treat local as UTC (stable, but may be offset by timezone).
-        targetUtc = targetLocal;
-    }
+    // Last resort: treat local as UTC (stable, but may be offset by timezone).
+    return UtcSystemTimeToFileTimeUll(targetLocal);
+}
 
-    return UtcSystemTimeToFileTimeUll(targetUtc);
+static inline ULONGLONG DurationTicks(DWORD minutes) noexcept {
+    return static_cast<ULONGLONG>(minutes) * Clock::TICKS_PER_MIN;
 }
 
-static ULONGLONG ResolveTargetUtc(const TimerConfig& timer) noexcept {
+static ULONGLONG ResolveTargetUtc(const Clock& clock, const TimerConfig& timer) noexcept {
     if (timer.endTimeUtc != 0) {
         return timer.endTimeUtc;
     }
 
     if (timer.mode == TimerMode::Duration) {
         if (timer.startTime.wYear == 0) {
-            const ULONGLONG nowUtc = NowUtcFileTimeUll();
-            return nowUtc + (static_cast<ULONGLONG>(timer.durationMinutes) * 60ULL * 10000000ULL);
-        }
-
-        SYSTEMTIME startUtc = {};
-        if (!LocalToUtcSystemTime(timer.startTime, startUtc)) {
-            startUtc = timer.startTime;
+            const ULONGLONG nowUtc = clock.NowUtc();
+            return nowUtc + DurationTicks(timer.durationMinutes);
         }
 
-        const ULONGLONG startUtcU = UtcSystemTimeToFileTimeUll(startUtc);
+        TimeZone::LocalResolution start;
+        const ULONGLONG startUtcU = clock.GetTimeZone()->Resolve(timer.startTime, start)
+            ? start.utcTicks
+            : UtcSystemTimeToFileTimeUll(timer.startTime);
         if (startUtcU == 0) {
-            const ULONGLONG nowUtc = NowUtcFileTimeUll();
-            return nowUtc + (static_cast<ULONGLONG>(timer.durationMinutes) * 60ULL * 10000000ULL);
+            const ULONGLONG nowUtc = clock.NowUtc();
+            return nowUtc + DurationTicks(timer.durationMinutes);
         }
 
-        return startUtcU + (static_cast<ULONGLONG>(timer.durationMinutes) * 60ULL * 10000000ULL);
+        return startUtcU + DurationTicks(timer.durationMinutes);
     }
 
     if (timer.mode == TimerMode::UntilTime) {
-        return ComputeNextUntilUtc(timer.untilTime);
+        return ComputeNextUntilUtc(clock, timer.untilTime);
     }
 
     return 0;
@@ -178,34 +105,81 @@ bool TimerConfig::IsValid() const noexcept {
     }
 }
 
-void TimerConfig::ResetStartTime() noexcept {
+void TimerConfig::ResetStartTime(const Clock& clock) noexcept {
     // Reset "runtime state" for the current mode.
     if (mode == TimerMode::Duration) {
-        GetLocalTime(&startTime);
-        const ULONGLONG nowUtc = NowUtcFileTimeUll();
-        endTimeUtc = nowUtc + (static_cast<ULONGLONG>(durationMinutes) * 60ULL * 10000000ULL);
+        clock.NowLocal(startTime);
+        endTimeUtc = clock.NowUtc() + DurationTicks(durationMinutes);
+        endTimeMonotonic = clock.NowMonotonic() + DurationTicks(durationMinutes);
     } else if (mode == TimerMode::UntilTime) {
-        GetLocalTime(&startTime);
-        endTimeUtc = ComputeNextUntilUtc(untilTime);
+        clock.NowLocal(startTime);
+        endTimeUtc = ComputeNextUntilUtc(clock, untilTime);
+        endTimeMonotonic = 0;
     } else {
         startTime = {};
         endTimeUtc = 0;
+        endTimeMonotonic = 0;
+    }
+}
+
+bool TimerConfig::GetDeadline(const Clock& clock, ClockBase& base, ULONGLONG& ticks) const noexcept {
+    if (mode == TimerMode::Indefinite) {
+        return false;
+    }
+
+    if (mode == TimerMode::Duration && endTimeMonotonic != 0) {
+        base = ClockBase::Monotonic;
+        ticks = endTimeMonotonic;
+        return true;
+    }
+
+    base = ClockBase::Wall;
+    ticks = ResolveTargetUtc(clock, *this);
+    return ticks != 0;
+}
+
+void TimerConfig::AnchorToMonotonic(const Clock& clock) noexcept {
+    if (mode != TimerMode::Duration || endTimeMonotonic != 0) {
+        return;
+    }
+
+    const ULONGLONG nowUtc = clock.NowUtc();
+    const ULONGLONG targetUtc = ResolveTargetUtc(clock, *this);
+    const ULONGLONG remaining = (targetUtc > nowUtc) ? targetUtc - nowUtc : 0;
+    // Never anchor further out than a full duration (wall clock set back while we were not running).
+    endTimeMonotonic = clock.NowMonotonic() + (std::min)(remaining, DurationTicks(durationMinutes));
+}
+
+bool TimerConfig::SyncWallDeadline(const Clock& clock) noexcept {
+    if (mode != TimerMode::Duration || endTimeMonotonic == 0) {
+        return false;
+    }
+
+    const ULONGLONG nowMono = clock.NowMonotonic();
+    const ULONGLONG remaining = (endTimeMonotonic > nowMono) ? endTimeMonotonic - nowMono : 0;
+    const ULONGLONG wall = clock.NowUtc() + remaining;
+    // Sub-second differences are just the two clocks being read at different moments.
+    const ULONGLONG drift = (wall > endTimeUtc) ? wall - endTimeUtc : endTimeUtc - wall;
+    if (drift < Clock::TICKS_PER_SEC) {
+        return false;
     }
+    endTimeUtc = wall;
+    return true;
 }
 
-bool TimerConfig::IsExpired() const noexcept {
+bool TimerConfig::IsExpired(const Clock& clock) const noexcept {
     if (mode == TimerMode::Indefinite) {
         return false;
     }
-    return GetRemainingMilliseconds() == 0;
+    return GetRemainingMilliseconds(clock) == 0;
 }
 
-DWORD TimerConfig::GetRemainingSeconds() const noexcept {
+DWORD TimerConfig::GetRemainingSeconds(const Clock& clock) const noexcept {
     if (mode == TimerMode::Indefinite) {
         return INFINITE;
     }
 
-    const DWORD remainingMs = GetRemainingMilliseconds();
+    const DWORD remainingMs = GetRemainingMilliseconds(clock);
     if (remainingMs == 0 || remainingMs == INFINITE) {
         return remainingMs;
     }
@@ -217,20 +191,28 @@ DWORD TimerConfig::GetRemainingSeconds() const noexcept {
     return static_cast<DWORD>(seconds);
 }
 
-DWORD TimerConfig::GetRemainingMilliseconds() const noexcept {
+DWORD TimerConfig::GetRemainingMilliseconds(const Clock& clock) const noexcept {
     if (mode == TimerMode::Indefinite) {
         return INFINITE;
     }
 
-    const ULONGLONG nowUtc = NowUtcFileTimeUll();
-    const ULONGLONG targetUtc = ResolveTargetUtc(*this);
+    // Durations count elapsed (suspend-aware) time, immune to wall-clock steps.
+    ULONGLONG now = 0;
+    ULONGLONG target = 0;
+    if (mode == TimerMode::Duration && endTimeMonotonic != 0) {
+        now = clock.NowMonotonic();
+        target = endTimeMonotonic;
+    } else {
+        now = clock.NowUtc();
+        target = ResolveTargetUtc(clock, *this);
+    }
 
-    if (targetUtc == 0 || targetUtc <= nowUtc) {
+    if (target == 0 || target <= now) {
         return 0;
     }
 
     // Round up so we never report "0 ms" before the actual deadline.
-    const ULONGLONG diff100ns = targetUtc - nowUtc;
+    const ULONGLONG diff100ns = target - now;
     const ULONGLONG milliseconds = (diff100ns + 10000ULL - 1ULL) / 10000ULL;
     if (milliseconds > 0xFFFFFFFFULL) {
         return 0xFFFFFFFFUL;
@@ -1,31 +1,52 @@
 #pragma once
 
-#include <windows.h>
+#include "Platform.h"
+#include "Clock.h"
 
 namespace Everon {
 
 enum class TimerMode {
     Indefinite,    // Бесконечно (по умолчанию)
-    Duration,      // На определённое время (5 мин - 24 часа)
+    Duration,      // На определённое время (5 мин - 7 дней)
     UntilTime      // До указанного времени
 };
 
 struct TimerConfig {
     TimerMode mode = TimerMode::Indefinite;
-    DWORD durationMinutes = 60;  // Для Duration режима (5-1440 минут)
+    DWORD durationMinutes = 60;  // Для Duration режима (5-10080 минут)
     SYSTEMTIME untilTime = {};   // Для UntilTime режима (используются только часы/минуты)
     SYSTEMTIME startTime = {};   // Время запуска (legacy, для совместимости)
     ULONGLONG endTimeUtc = 0;    // FILETIME UTC (QWORD). 0 = не задано
 
+    // Duration deadline on Clock::NowMonotonic(), runtime only (never persisted).
+    // Wall-clock steps and NTP corrections do not move it; endTimeUtc is kept in sync
+    // for persistence via SyncWallDeadline(). 0 = not anchored yet.
+    ULONGLONG endTimeMonotonic = 0;
+
     // Константы для Duration
     static constexpr DWORD MIN_DURATION_MIN = 5;
-    static constexpr DWORD MAX_DURATION_MIN = 1440; // 24 часа
+    static constexpr DWORD MAX_DURATION_MIN = 10080; // 7 дней
 
+    // Time-dependent queries take the clock explicitly so expiry can be evaluated against
+    // virtual time (benchmarks, DST/clock-jump replay). Defaults to the real OS clock.
     bool IsValid() const noexcept;
-    bool IsExpired() const noexcept;
-    DWORD GetRemainingSeconds() const noexcept;
-    DWORD GetRemainingMilliseconds() const noexcept;
-    void ResetStartTime() noexcept;
+    bool IsExpired(const Clock& clock = SystemClock::Instance()) const noexcept;
+    DWORD GetRemainingSeconds(const Clock& clock = SystemClock::Instance()) const noexcept;
+    DWORD GetRemainingMilliseconds(const Clock& clock = SystemClock::Instance()) const noexcept;
+    void ResetStartTime(const Clock& clock = SystemClock::Instance()) noexcept;
+
+    // Absolute expiry moment for a one-shot OS timer: on the monotonic time line for
+    // anchored durations, on the wall clock otherwise. False for Indefinite.
+    bool GetDeadline(const Clock& clock, ClockBase& base, ULONGLONG& ticks) const noexcept;
+
+    // Duration mode: derives endTimeMonotonic from the persisted endTimeUtc (after a
+    // restart the monotonic clock has a new origin). No-op if already anchored.
+    void AnchorToMonotonic(const Clock& clock = SystemClock::Instance()) noexcept;
+
+    // Duration mode: recomputes endTimeUtc from the monotonic deadline after the wall
+    // clock was stepped, so the persisted value matches the remaining time.
+    // Returns true if endTimeUtc changed.
+    bool SyncWallDeadline(const Clock& clock = SystemClock::Instance()) noexcept;
 };
 
 } // namespace Everon
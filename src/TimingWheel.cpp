@@ -0,0 +1,296 @@
+#include "TimingWheel.h"
+#include <algorithm>
+#include <utility>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Everon {
+
+namespace {
+
+constexpr size_t kBitsPerLevel = 6;
+constexpr size_t kFiring = TimingWheel::LEVELS + 1;  // detached, waiting for its callback
+
+// Index of the lowest / highest set bit; `bits` must be non-zero.
+inline size_t LowestBit(ULONGLONG bits) noexcept {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward64(&index, bits);
+    return index;
+#else
+    return static_cast<size_t>(__builtin_ctzll(bits));
+#endif
+}
+
+inline size_t HighestBit(ULONGLONG bits) noexcept {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanReverse64(&index, bits);
+    return index;
+#else
+    return static_cast<size_t>(63 - __builtin_clzll(bits));
+#endif
+}
+
+inline ULONGLONG ToUnitsCeil(ULONGLONG ticks) noexcept {
+    return ticks / TimingWheel::RESOLUTION_TICKS + (ticks % TimingWheel::RESOLUTION_TICKS != 0 ? 1 : 0);
+}
+
+} // namespace
+
+TimingWheel::TimingWheel(ULONGLONG nowMonotonic) noexcept
+    : m_now(nowMonotonic / RESOLUTION_TICKS) {
+    for (auto& level : m_heads) {
+        std::fill(std::begin(level), std::end(level), kNil);
+    }
+}
+
+size_t& TimingWheel::Head(size_t level, size_t slot) noexcept {
+    return level == kOverflow ? m_overflow : m_heads[level][slot];
+}
+
+TimingWheel::Summary& TimingWheel::SlotSummary(size_t level, size_t slot) const noexcept {
+    return m_summaries[level][level == kOverflow ? 0 : slot];
+}
+
+const TimingWheel::Summary& TimingWheel::FreshSummary(size_t level, size_t slot) const noexcept {
+    Summary& summary = SlotSummary(level, slot);
+    if (summary.stale) {
+        summary = Summary();
+        const size_t head = (level == kOverflow) ? m_overflow : m_heads[level][slot];
+        for (size_t i = head; i != kNil; i = m_nodes[i].next) {
+            summary.earliest = (std::min)(summary.earliest, m_nodes[i].deadline);
+            summary.latest = (std::min)(summary.latest, m_nodes[i].deadline + m_nodes[i].tolerance);
+        }
+    }
+    return summary;
+}
+
+void TimingWheel::Place(size_t index) noexcept {
+    Node& node = m_nodes[index];
+    const ULONGLONG effective = (std::max)(node.deadline, m_now);
+    const ULONGLONG diff = effective ^ m_now;
+    size_t level = diff ? HighestBit(diff) / kBitsPerLevel : 0;
+    size_t slot = 0;
+    if (level >= LEVELS) {
+        level = kOverflow;
+    } else {
+        slot = static_cast<size_t>((effective >> (kBitsPerLevel * level)) & (SLOTS - 1));
+        m_occupied[level] |= 1ULL << slot;
+    }
+
+    Summary& summary = SlotSummary(level, slot);
+    summary.earliest = (std::min)(summary.earliest, node.deadline);
+    summary.latest = (std::min)(summary.latest, node.deadline + node.tolerance);
+
+    size_t& head = Head(level, slot);
+    node.level = level;
+    node.slot = slot;
+    node.prev = kNil;
+    node.next = head;
+    if (head != kNil) {
+        m_nodes[head].prev = index;
+    }
+    head = index;
+}
+
+void TimingWheel::Unlink(size_t index) noexcept {
+    Node& node = m_nodes[index];
+    if (node.level == kFiring) {
+        return;
+    }
+
+    Summary& summary = SlotSummary(node.level, node.slot);
+    if (node.prev == kNil && node.next == kNil) {
+        summary = Summary();
+    } else if (node.deadline == summary.earliest || node.deadline + node.tolerance == summary.latest) {
+        summary.stale = true;
+    }
+
+    if (node.prev != kNil) {
+        m_nodes[node.prev].next = node.next;
+    } else {
+        Head(node.level, node.slot) = node.next;
+        if (node.next == kNil && node.level != kOverflow) {
+            m_occupied[node.level] &= ~(1ULL << node.slot);
+        }
+    }
+    if (node.next != kNil) {
+        m_nodes[node.next].prev = node.prev;
+    }
+    node.prev = node.next = kNil;
+}
+
+void TimingWheel::Release(size_t index) noexcept {
+    Node& node = m_nodes[index];
+    node.generation = 0;
+    node.callback = nullptr;
+    m_free.push_back(index);
+    --m_active;
+}
+
+TimingWheel::TimerId TimingWheel::Schedule(ULONGLONG deadline, Callback callback, ULONGLONG toleranceTicks) {
+    size_t index = 0;
+    if (!m_free.empty()) {
+        index = m_free.back();
+        m_free.pop_back();
+    } else {
+        index = m_nodes.size();
+        m_nodes.emplace_back();
+    }
+
+    Node& node = m_nodes[index];
+    node.deadline = ToUnitsCeil(deadline);
+    node.tolerance = toleranceTicks / RESOLUTION_TICKS;
+    node.generation = m_nextGeneration++;
+    node.callback = std::move(callback);
+    ++m_active;
+    Place(index);
+
+    TimerId id;
+    id.index = index;
+    id.generation = node.generation;
+    return id;
+}
+
+bool TimingWheel::IsScheduled(const TimerId& id) const noexcept {
+    return id.IsValid() && id.index < m_nodes.size() && m_nodes[id.index].generation == id.generation;
+}
+
+bool TimingWheel::Cancel(TimerId& id) noexcept {
+    const bool scheduled = IsScheduled(id);
+    if (scheduled) {
+        Unlink(id.index);
+        Release(id.index);
+    }
+    id = TimerId();
+    return scheduled;
+}
+
+size_t TimingWheel::Advance(ULONGLONG nowMonotonic) {
+    const ULONGLONG now = nowMonotonic / RESOLUTION_TICKS;
+    if (now < m_now) {
+        return 0;
+    }
+
+    const ULONGLONG old = m_now;
+    m_now = now;
+
+    // Detach every slot that the move from `old` to `now` made due or current. The
+    // scratch vectors keep their capacity, so a steady-state tick does not allocate.
+    std::vector<size_t>& detached = m_detached;
+    detached.clear();
+    for (size_t level = 0; level < LEVELS; ++level) {
+        if (!m_occupied[level]) {
+            continue;
+        }
+        const size_t above = kBitsPerLevel * (level + 1);
+        ULONGLONG mask = ~0ULL;
+        if ((old >> above) == (now >> above)) {
+            const size_t current = static_cast<size_t>((now >> (kBitsPerLevel * level)) & (SLOTS - 1));
+            mask = (current == SLOTS - 1) ? ~0ULL : ((1ULL << (current + 1)) - 1);
+        }
+
+        ULONGLONG due = m_occupied[level] & mask;
+        m_occupied[level] &= ~due;
+        while (due) {
+            const size_t slot = LowestBit(due);
+            due &= due - 1;
+            for (size_t i = m_heads[level][slot]; i != kNil; i = m_nodes[i].next) {
+                detached.push_back(i);
+            }
+            m_heads[level][slot] = kNil;
+            m_summaries[level][slot] = Summary();
+        }
+    }
+    if (m_overflow != kNil && (old >> (kBitsPerLevel * LEVELS)) != (now >> (kBitsPerLevel * LEVELS))) {
+        for (size_t i = m_overflow; i != kNil; i = m_nodes[i].next) {
+            detached.push_back(i);
+        }
+        m_overflow = kNil;
+        m_summaries[kOverflow][0] = Summary();
+    }
+
+    // Expired entries fire; the rest cascade to a lower level relative to `now`. Taken
+    // out of the member while callbacks run, in case one of them advances the wheel.
+    std::vector<std::pair<ULONGLONG, size_t>> expired;
+    expired.swap(m_expired);
+    expired.clear();
+    for (size_t index : detached) {
+        Node& node = m_nodes[index];
+        node.prev = node.next = kNil;
+        if (node.deadline <= now) {
+            node.level = kFiring;
+            expired.emplace_back(node.generation, index);
+        } else {
+            Place(index);
+        }
+    }
+
+    // Deadline order, scheduling order for ties.
+    std::sort(expired.begin(), expired.end(), [this](const auto& a, const auto& b) {
+        const ULONGLONG da = m_nodes[a.second].deadline;
+        const ULONGLONG db = m_nodes[b.second].deadline;
+        return da != db ? da < db : a.first < b.first;
+    });
+
+    size_t fired = 0;
+    for (const auto& entry : expired) {
+        Node& node = m_nodes[entry.second];
+        if (node.generation != entry.first) {
+            continue; // cancelled by an earlier callback
+        }
+        Callback callback = std::move(node.callback);
+        Release(entry.second);
+        ++fired;
+        if (callback) {
+            callback();
+        }
+    }
+    expired.clear();
+    if (expired.capacity() > m_expired.capacity()) {
+        expired.swap(m_expired);
+    }
+    return fired;
+}
+
+bool TimingWheel::GetNextDeadline(ULONGLONG& deadline, ULONGLONG& toleranceTicks) const noexcept {
+    // Slots in deadline order: a level's slots ascending, every level before the next
+    // one, the overflow list last. The first occupied slot holds the earliest deadline;
+    // every entry due before the wakeup it allows caps that wakeup with its own
+    // tolerance, so the walk goes on until a slot starts past the cap.
+    ULONGLONG earliest = ~0ULL;
+    ULONGLONG latest = ~0ULL;
+    bool done = false;
+    auto Merge = [&](const Summary& summary) {
+        if (earliest == ~0ULL) {
+            earliest = summary.earliest;
+        } else if (summary.earliest > latest) {
+            done = true;
+            return;
+        }
+        latest = (std::min)(latest, summary.latest);
+    };
+
+    for (size_t level = 0; level < LEVELS && !done; ++level) {
+        for (ULONGLONG bits = m_occupied[level]; bits && !done; bits &= bits - 1) {
+            Merge(FreshSummary(level, LowestBit(bits)));
+        }
+    }
+    if (m_overflow != kNil && !done) {
+        Merge(FreshSummary(kOverflow, 0));
+    }
+
+    if (earliest == ~0ULL) {
+        return false;
+    }
+    // Entries scheduled in the past are due now.
+    earliest = (std::max)(earliest, m_now);
+    latest = (std::max)(latest, earliest);
+    deadline = earliest * RESOLUTION_TICKS;
+    toleranceTicks = (latest - earliest) * RESOLUTION_TICKS;
+    return true;
+}
+
+} // namespace Everon
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Platform.h"
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Everon {
+
+// Hierarchical timing wheel multiplexing any number of logical timers onto one OS timer.
+// Deadlines are Clock::NowMonotonic() ticks, kept at 1 ms resolution (rounded up, so an
+// entry never fires early). Each level has 64 slots and a 64-bit occupancy bitmap;
+// entries are placed by the highest 6-bit group in which their deadline differs from the
+// wheel's current time, so slot order is deadline order without wrap-around.
+// Schedule/Cancel are O(1); Advance() jumps straight to the new time and only touches
+// slots that became due.
+class TimingWheel {
+public:
+    using Callback = std::function<void()>;
+
+    // Opaque handle; stale handles (fired or cancelled) are detected and ignored.
+    struct TimerId {
+        size_t index = 0;
+        ULONGLONG generation = 0;
+        bool IsValid() const noexcept { return generation != 0; }
+    };
+
+    static constexpr size_t LEVELS = 6;           // 2^36 ms (~795 days) before overflow
+    static constexpr size_t SLOTS = 64;
+    static constexpr ULONGLONG RESOLUTION_TICKS = 10000ULL;  // 1 ms
+
+    explicit TimingWheel(ULONGLONG nowMonotonic = 0) noexcept;
+
+    // `toleranceTicks` is how late the entry may fire (coalescing, see GetNextDeadline).
+    TimerId Schedule(ULONGLONG deadline, Callback callback, ULONGLONG toleranceTicks = 0);
+    bool Cancel(TimerId& id) noexcept;
+    bool IsScheduled(const TimerId& id) const noexcept;
+
+    // Runs every callback whose deadline is <= nowMonotonic, in deadline order.
+    // Callbacks may schedule and cancel timers. Returns the number of callbacks run.
+    size_t Advance(ULONGLONG nowMonotonic);
+
+    // Earliest pending deadline, and how long the OS wakeup for it may be delayed
+    // without making any entry due by then fire past its own tolerance.
+    bool GetNextDeadline(ULONGLONG& deadline, ULONGLONG& toleranceTicks) const noexcept;
+
+    size_t GetActiveCount() const noexcept { return m_active; }
+    ULONGLONG GetNow() const noexcept { return m_now * RESOLUTION_TICKS; }
+
+private:
+    static constexpr size_t kNil = static_cast<size_t>(-1);
+    static constexpr size_t kOverflow = LEVELS;   // pseudo level for far deadlines
+
+    struct Node {
+        ULONGLONG deadline = 0;    // wheel units (ms)
+        ULONGLONG tolerance = 0;   // wheel units (ms)
+        ULONGLONG generation = 0;  // 0 = free
+        size_t prev = kNil;
+        size_t next = kNil;
+        size_t level = 0;
+        size_t slot = 0;
+        Callback callback;
+    };
+
+    // Earliest deadline and earliest deadline + tolerance in one slot, maintained on insert.
+    // Removing the entry that defined either marks it stale; GetNextDeadline() rescans
+    // stale slots only, so it stays cheap with thousands of entries in a far slot.
+    struct Summary {
+        ULONGLONG earliest = ~0ULL;
+        ULONGLONG latest = ~0ULL;
+        bool stale = false;
+    };
+
+    void Place(size_t index) noexcept;
+    void Unlink(size_t index) noexcept;
+    void Release(size_t index) noexcept;
+    size_t& Head(size_t level, size_t slot) noexcept;
+    Summary& SlotSummary(size_t level, size_t slot) const noexcept;
+    const Summary& FreshSummary(size_t level, size_t slot) const noexcept;
+
+    std::vector<Node> m_nodes;
+    std::vector<size_t> m_free;
+    std::vector<size_t> m_detached;                        // Advance() scratch
+    std::vector<std::pair<ULONGLONG, size_t>> m_expired;   // Advance() scratch
+    size_t m_heads[LEVELS][SLOTS];
+    ULONGLONG m_occupied[LEVELS] = {};
+    size_t m_overflow = kNil;
+    mutable Summary m_summaries[LEVELS + 1][SLOTS];   // [kOverflow][0] for the overflow list
+    size_t m_active = 0;
+    ULONGLONG m_now = 0;           // wheel units (ms)
+    ULONGLONG m_nextGeneration = 1;
+};
+
+} // namespace Everon
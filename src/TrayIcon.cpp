@@ -98,7 +98,7 @@ void TrayIcon::Remove() {
     }
 }
 
-void TrayIcon::UpdateTooltip(const Settings& settings) {
+void TrayIcon::UpdateTooltip(const Settings& settings, bool displayHeld, bool batteryPaused) {
     if (m_notifyData.cbSize == 0) {
         return;
     }
@@ -135,9 +135,12 @@ void TrayIcon::UpdateTooltip(const Settings& settings) {
             AppendBullet(part);
         }
 
-        // Keep display on (optional)
-        if (settings.GetKeepDisplayOn()) {
-            AppendBullet(loc.GetString(StringID::SettingsKeepDisplay));
+        // Keep display on (optional); the display or battery policy may have dropped to
+        // system only, or the battery policy paused keeping awake altogether
+        if (batteryPaused) {
+            AppendBullet(loc.GetString(StringID::TooltipBatteryPaused));
+        } else if (settings.GetKeepDisplayOn()) {
+            AppendBullet(loc.GetString(displayHeld ? StringID::SettingsKeepDisplay : StringID::TooltipSystemOnly));
         }
 
         // Timer info (optional)
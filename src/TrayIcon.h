@@ -21,8 +21,9 @@ public:
     bool ReAdd();
     void Remove();
 
-    // Update tooltip text
-    void UpdateTooltip(const Settings& settings);
+    // Update tooltip text; `displayHeld` is whether the display is currently kept on,
+    // `batteryPaused` whether the battery policy has suspended keeping awake
+    void UpdateTooltip(const Settings& settings, bool displayHeld, bool batteryPaused);
 
     // Show notification
     void ShowNotification(const wchar_t* title, const wchar_t* message, DWORD flags);
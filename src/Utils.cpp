@@ -1,23 +1,9 @@
 #include "Utils.h"
 #include <strsafe.h>
-#include <stdarg.h>
 
 namespace Everon {
 namespace Utils {
 
-#ifdef _DEBUG
-void DebugLog(const wchar_t* format, ...) {
-    wchar_t buffer[512] = {};
-
-    va_list args;
-    va_start(args, format);
-    StringCchVPrintfW(buffer, _countof(buffer), format, args);
-    va_end(args);
-
-    OutputDebugStringW(buffer);
-}
-#endif
-
 bool CheckWinApiBool(BOOL result, const wchar_t* apiName) {
     if (result) {
         return true;
@@ -38,10 +24,12 @@ bool CheckWinApiStatus(LONG status, const wchar_t* apiName) {
     return false;
 }
 
-UINT_PTR SetTimerChecked(HWND window, UINT_PTR timerId, UINT intervalMs) {
-    const UINT_PTR result = ::SetTimer(window, timerId, intervalMs, nullptr);
+UINT_PTR SetTimerChecked(HWND window, UINT_PTR timerId, UINT intervalMs, ULONG toleranceMs) {
+    const UINT_PTR result = (toleranceMs != 0)
+        ? ::SetCoalescableTimer(window, timerId, intervalMs, nullptr, toleranceMs)
+        : ::SetTimer(window, timerId, intervalMs, nullptr);
     if (result == 0) {
-        CheckWinApiBool(FALSE, L"SetTimer");
+        CheckWinApiBool(FALSE, toleranceMs != 0 ? L"SetCoalescableTimer" : L"SetTimer");
     }
     return result;
 }
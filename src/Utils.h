@@ -1,23 +1,17 @@
 #pragma once
 
-#include <windows.h>
+#include "Platform.h"
 #include <shellapi.h>
 #include <string>
 
 namespace Everon {
 namespace Utils {
 
-// Debug logging (outputs to debugger)
-#ifdef _DEBUG
-void DebugLog(const wchar_t* format, ...);
-#else
-inline void DebugLog(const wchar_t*, ...) {}
-#endif
-
 // Unified WinAPI result checks (with consistent debug logging)
 bool CheckWinApiBool(BOOL result, const wchar_t* apiName);
 bool CheckWinApiStatus(LONG status, const wchar_t* apiName);
-UINT_PTR SetTimerChecked(HWND window, UINT_PTR timerId, UINT intervalMs);
+// toleranceMs > 0 makes the timer coalescable (SetCoalescableTimer)
+UINT_PTR SetTimerChecked(HWND window, UINT_PTR timerId, UINT intervalMs, ULONG toleranceMs = 0);
 bool ShellNotifyIconChecked(DWORD message, PNOTIFYICONDATAW data, const wchar_t* context = nullptr);
 
 // Center window on monitor